@@ -1,14 +1,24 @@
 // JNI 桥接 — Bridge.java ↔ ProtectionEngine (NEXT_IMPROVEMENTS §5 §7)
 
+#include "core/EngineStats.h"
 #include <jni.h>
+#include <cinttypes>
+#include <cmath>
+#include <cstdarg>
 #include <cstdint>
+#include <cstdio>
 #include <cstring>
 #include <string>
 
-extern void* ProtectionEngine_getInstance(void);
-extern void ProtectionEngine_updateConfig(void* engine, const char* json);
-extern void ProtectionEngine_markFalsePositive(void* engine, const char* word, int64_t timestamp);
-extern void ProtectionEngine_setTestInterceptEnabled(void* engine, int enabled);
+// Engine.cpp 以 extern "C" 导出，声明须一致 (否则按 C++ 名字修饰链接失败)
+extern "C" {
+void* ProtectionEngine_getInstance(void);
+void ProtectionEngine_updateConfig(void* engine, const char* json);
+void ProtectionEngine_markFalsePositive(void* engine, const char* word, int64_t timestamp);
+void ProtectionEngine_setTestInterceptEnabled(void* engine, int enabled);
+void ProtectionEngine_loadModel(void* engine, const char* path);
+int ProtectionEngine_getStats(void* engine, SgEngineStats* out);
+}
 // 声明新添加的 initInterceptor Stub/Impl
 // Assuming ProtectionEngine has init(). Yes it does.
 // extern void ProtectionEngine_init(void* engine); // Not exported in Engine.cpp yet?
@@ -60,13 +70,108 @@ void nativeLoadModel(JNIEnv* env, jobject /* thiz */, jstring path) {
     // Stub or Implement if needed. Engine.cpp has `ProtectionEngine_loadModel` exported?
     // Let's assume yes from previous `Engine.cpp` view (lines 206-208).
     // Yes: extern "C" void ProtectionEngine_loadModel(void* engine, const char* path)
-    extern void ProtectionEngine_loadModel(void* engine, const char* path);
-    
     std::string pathStr = jstringToUtf8(env, path);
     void* engine = ProtectionEngine_getInstance();
     ProtectionEngine_loadModel(engine, pathStr.c_str());
 }
 
+// printf 式追加到 out 尾部：先量出长度再直接写入字符串，不经固定缓冲，不会截断；编码错误时返回 false
+__attribute__((format(printf, 2, 3))) bool appendf(std::string* out, const char* fmt, ...) {
+  va_list args;
+  va_start(args, fmt);
+  va_list measure;
+  va_copy(measure, args);
+  const int n = vsnprintf(nullptr, 0, fmt, measure);
+  va_end(measure);
+  if (n < 0) {
+    va_end(args);
+    return false;
+  }
+  const size_t at = out->size();
+  out->resize(at + static_cast<size_t>(n) + 1);  // vsnprintf 总要写结尾 NUL
+  const int written = vsnprintf(&(*out)[at], static_cast<size_t>(n) + 1, fmt, args);
+  va_end(args);
+  out->resize(at + static_cast<size_t>(n));
+  return written == n;
+}
+
+// JSON 不能表示 NaN / Inf
+double jsonNumber(float v) { return std::isfinite(v) ? static_cast<double>(v) : 0.0; }
+
+// 紧凑 JSON 快照 (阶段单位 ns)：
+// {"v":11,"stages":{"push":[n,p50,p90,p99,max,sum],...},"counters":{...},"model":{"load_us":..,...},"kws":{...},
+//  "config":{...},"vad":{...},"governor":{...},"sessions":{...},"capture":{...}}
+jstring nativeGetStats(JNIEnv* env, jobject /* thiz */) {
+  static const char* const kStageNames[SG_STAGE_COUNT] = {
+      "push", "queue_wait", "lock_wait", "mel", "inference", "decision", "lookahead"};
+
+  SgEngineStats stats;
+  if (!ProtectionEngine_getStats(ProtectionEngine_getInstance(), &stats)) return env->NewStringUTF("{}");
+
+  std::string json;
+  json.reserve(2048);
+  bool ok = appendf(&json, "{\"v\":%" PRIu32 ",\"stages\":{", stats.version);
+  for (int i = 0; i < SG_STAGE_COUNT; ++i) {
+    const SgStageStats& s = stats.stages[i];
+    ok = ok && appendf(&json, "%s\"%s\":[%" PRIu64 ",%" PRIu64 ",%" PRIu64 ",%" PRIu64 ",%" PRIu64 ",%" PRIu64 "]",
+                       i ? "," : "", kStageNames[i], s.count, s.p50_ns, s.p90_ns, s.p99_ns, s.max_ns, s.sum_ns);
+  }
+  const struct { const char* name; uint64_t value; } counters[] = {
+      {"intercepts", stats.intercept_decisions}, {"masks", stats.masks_scheduled},
+      {"immediate", stats.immediate_intercepts}, {"late_masks", stats.late_masks},
+      {"dropped_masks", stats.dropped_masks}, {"infer_fail", stats.inference_failures},
+      {"enqueued", stats.blocks_enqueued}, {"dropped", stats.blocks_dropped},
+      {"late_blocks", stats.blocks_late}, {"windows", stats.windows_scheduled},
+      {"skipped", stats.windows_skipped}, {"chunks", stats.stream_chunks},
+      {"stream_resets", stats.stream_resets}};
+  json += "},\"counters\":{";
+  bool first = true;
+  for (const auto& c : counters) {
+    ok = ok && appendf(&json, "%s\"%s\":%" PRIu64, first ? "" : ",", c.name, c.value);
+    first = false;
+  }
+  ok = ok && appendf(&json,
+                     "},\"model\":{\"load_us\":%" PRIu32 ",\"warmup_us\":%" PRIu32 ",\"first_us\":%" PRIu32
+                     ",\"threads\":%" PRId32 ",\"xnnpack\":%" PRIu32 ",\"in_type\":%" PRIu32 ",\"out_type\":%" PRIu32
+                     ",\"chunk\":%" PRId32 ",\"states\":%" PRId32 "}",
+                     stats.model_load_us, stats.model_warmup_us, stats.model_first_inference_us, stats.model_threads,
+                     stats.model_xnnpack, stats.model_input_type, stats.model_output_type,
+                     stats.model_chunk_frames, stats.model_state_tensors);
+  ok = ok && appendf(&json,
+                     ",\"kws\":{\"keywords\":%" PRIu32 ",\"nodes\":%" PRIu32 ",\"frames\":%" PRIu64 ",\"hits\":%" PRIu64
+                     ",\"peak_tokens\":%" PRIu32 ",\"last\":{\"id\":%" PRId32 ",\"score\":%.3f,\"start\":%" PRIu64
+                     ",\"end\":%" PRIu64 "}}",
+                     stats.kws_keywords, stats.kws_graph_nodes, stats.kws_frames, stats.kws_hits, stats.kws_peak_tokens,
+                     stats.kws_last_keyword, jsonNumber(stats.kws_last_score), stats.kws_last_start,
+                     stats.kws_last_end);
+  ok = ok && appendf(&json,
+                     ",\"config\":{\"publishes\":%" PRIu64 ",\"rejected\":%" PRIu64 ",\"parse_us\":%" PRIu32
+                     ",\"compile_us\":%" PRIu32 "}",
+                     stats.config_publishes, stats.config_rejected, stats.config_parse_us, stats.config_compile_us);
+  ok = ok && appendf(&json,
+                     ",\"vad\":{\"samples\":%" PRIu64 ",\"skipped\":%" PRIu64 ",\"hops\":%" PRIu64
+                     ",\"speech_hops\":%" PRIu64 ",\"openings\":%" PRIu64 "}",
+                     stats.vad_samples, stats.vad_skipped_samples, stats.vad_hops, stats.vad_speech_hops,
+                     stats.vad_openings);
+  ok = ok && appendf(&json,
+                     ",\"governor\":{\"level\":%" PRIu32 ",\"levels\":%" PRIu32 ",\"stride_ms\":%" PRId32
+                     ",\"threads\":%" PRId32 ",\"fallback\":%" PRIu32 ",\"rtf\":%.3f,\"lag_ms\":%" PRIu32
+                     ",\"transitions\":%" PRIu64 ",\"overloads\":%" PRIu64 "}",
+                     stats.gov_level, stats.gov_levels, stats.gov_stride_ms, stats.gov_threads, stats.gov_fallback,
+                     jsonNumber(stats.gov_rtf), stats.gov_lag_ms, stats.gov_transitions, stats.gov_overloads);
+  ok = ok && appendf(&json,
+                     ",\"sessions\":{\"id\":%" PRIu32 ",\"open\":%" PRIu32 ",\"opened\":%" PRIu64
+                     ",\"workers\":%" PRIu32 ",\"slot\":%" PRIu32 ",\"state_restores\":%" PRIu64 "}",
+                     stats.session_id, stats.sessions_open, stats.sessions_opened, stats.pool_workers,
+                     stats.session_slot, stats.stream_state_restores);
+  ok = ok && appendf(&json,
+                     ",\"capture\":{\"rate\":%" PRIu32 ",\"channels\":%" PRIu32 ",\"format\":%" PRIu32
+                     ",\"taps\":%" PRIu32 "}}",
+                     stats.capture_sample_rate, stats.capture_channels, stats.capture_format, stats.resampler_taps);
+  // 格式化失败时不返回半截 JSON
+  return env->NewStringUTF(ok ? json.c_str() : "{}");
+}
+
 // TODO: Implement updateRules if needed, currently stubbed or ignored.
 
 JNINativeMethod g_bridgeMethods[] = {
@@ -74,7 +179,8 @@ JNINativeMethod g_bridgeMethods[] = {
   { "markFalsePositive", "(Ljava/lang/String;J)V", reinterpret_cast<void*>(nativeMarkFalsePositive) },
   { "setTestInterceptEnabled", "(Z)V", reinterpret_cast<void*>(nativeSetTestInterceptEnabled) },
   { "initInterceptor", "()V", reinterpret_cast<void*>(nativeInitInterceptor) },
-  { "loadModel", "(Ljava/lang/String;)V", reinterpret_cast<void*>(nativeLoadModel) }
+  { "loadModel", "(Ljava/lang/String;)V", reinterpret_cast<void*>(nativeLoadModel) },
+  { "getStats", "()Ljava/lang/String;", reinterpret_cast<void*>(nativeGetStats) }
 };
 
 }  // namespace
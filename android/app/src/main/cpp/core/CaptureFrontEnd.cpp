@@ -0,0 +1,106 @@
+#include "CaptureFrontEnd.h"
+#include "feature_extraction/MelSpectrogram.h"
+#include "injector/PcmKernels.h"
+#include <algorithm>
+#include <cmath>
+
+namespace silenceguard {
+
+bool CaptureFrontEnd::supports(int sampleRate, int channels, int format) {
+  if (channels < 1 || channels > kMaxChannels) return false;
+  if (format != kSampleInt16 && format != kSampleFloat32) return false;
+  return sampleRate == kSampleRate || PolyphaseResampler::supports(sampleRate, kSampleRate);
+}
+
+CaptureFrontEnd::CaptureFrontEnd(int sampleRate, int channels, int format)
+    : sample_rate_(sampleRate),
+      channels_(channels),
+      format_(format),
+      passthrough_(sampleRate == kSampleRate && channels == 1 && format == kSampleInt16) {
+  if (passthrough_) return;
+  if (sampleRate != kSampleRate) {
+    resampler_ = std::make_unique<PolyphaseResampler>(sampleRate, kSampleRate);
+    resampled_.resize(resampler_->maxOutput(kBlockFrames));
+  }
+  if (format == kSampleInt16) interleaved_.resize(kBlockFrames * static_cast<size_t>(channels));
+  mono_.resize(kBlockFrames);
+}
+
+size_t CaptureFrontEnd::frameBytes() const {
+  return static_cast<size_t>(channels_) * (format_ == kSampleFloat32 ? sizeof(float) : sizeof(int16_t));
+}
+
+size_t CaptureFrontEnd::maxOutput(size_t frames) const {
+  return resampler_ ? resampler_->maxOutput(frames) : frames;
+}
+
+size_t CaptureFrontEnd::inputFor(size_t outFrames) const {
+  if (!resampler_) return outFrames;
+  // maxOutput(n) = ceil(n·out/in) + 1
+  if (outFrames <= 1) return 0;
+  return static_cast<size_t>((outFrames - 1) * static_cast<uint64_t>(sample_rate_) / kSampleRate);
+}
+
+const float* CaptureFrontEnd::downmix(const void* data, size_t frames) {
+  const size_t ch = static_cast<size_t>(channels_);
+  float* mono = mono_.data();
+  const float* src;
+  if (format_ == kSampleInt16) {
+    int16ToFloat(static_cast<const int16_t*>(data), ch == 1 ? mono : interleaved_.data(), frames * ch);
+    if (ch == 1) return mono;
+    src = interleaved_.data();
+  } else {
+    src = static_cast<const float*>(data);
+    if (ch == 1) return src;  // float mono 直接送入重采样器
+  }
+  // 各声道等权平均 (立体声单独展开，便于编译器向量化)
+  if (ch == 2) {
+    for (size_t i = 0; i < frames; ++i) mono[i] = (src[2 * i] + src[2 * i + 1]) * 0.5f;
+    return mono;
+  }
+  const float scale = 1.0f / static_cast<float>(ch);
+  for (size_t i = 0; i < frames; ++i) {
+    float sum = 0.0f;
+    for (size_t c = 0; c < ch; ++c) sum += src[i * ch + c];
+    mono[i] = sum * scale;
+  }
+  return mono;
+}
+
+size_t CaptureFrontEnd::process(const void* data, size_t frames, int16_t* out) {
+  if (passthrough_) {
+    std::copy(static_cast<const int16_t*>(data), static_cast<const int16_t*>(data) + frames, out);
+    return frames;
+  }
+  const uint8_t* bytes = static_cast<const uint8_t*>(data);
+  const size_t stride = frameBytes();
+  size_t produced = 0;
+  for (size_t pos = 0; pos < frames; pos += kBlockFrames) {
+    const size_t n = std::min(kBlockFrames, frames - pos);
+    const float* mono = downmix(bytes + pos * stride, n);
+    if (resampler_) {
+      const size_t m = resampler_->process(mono, n, resampled_.data());
+      floatToInt16(resampled_.data(), out + produced, m);
+      produced += m;
+    } else {
+      floatToInt16(mono, out + produced, n);
+      produced += n;
+    }
+  }
+  return produced;
+}
+
+double CaptureFrontEnd::toNative(uint64_t analysisPos) const {
+  if (!resampler_) return static_cast<double>(analysisPos);
+  return static_cast<double>(analysisPos) * sample_rate_ / kSampleRate - resampler_->delay();
+}
+
+uint64_t CaptureFrontEnd::toNativeFloor(uint64_t analysisPos) const {
+  return static_cast<uint64_t>(std::max(0.0, std::floor(toNative(analysisPos))));
+}
+
+uint64_t CaptureFrontEnd::toNativeCeil(uint64_t analysisPos) const {
+  return static_cast<uint64_t>(std::max(0.0, std::ceil(toNative(analysisPos))));
+}
+
+}  // namespace silenceguard
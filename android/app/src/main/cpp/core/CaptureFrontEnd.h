@@ -0,0 +1,71 @@
+// SilenceGuard Pro — 采集前端：原生格式 (8k–192k、1–8 声道、int16 / float32 交错) → 分析格式 (16kHz mono int16)
+// 每路会话一个实例 (HAL 线程私有)：声道平均下混 → 多相重采样 (滤波器历史跨 buffer 保存) → int16
+// 只服务分析链路；掩蔽仍在原始 buffer 上按原生采样率进行，toNative* 把分析位置折算回原生帧位置
+// 16kHz mono int16 直通 (不拷贝)；缓冲在构造时预分配，process 无堆分配
+
+#ifndef SILENCEGUARD_CAPTUREFRONTEND_H
+#define SILENCEGUARD_CAPTUREFRONTEND_H
+
+#include "feature_extraction/PolyphaseResampler.h"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace silenceguard {
+
+/** 采集样本格式 (C 接口的 format 参数) */
+enum SampleFormat : int {
+  kSampleInt16 = 0,
+  kSampleFloat32 = 1,
+};
+
+class CaptureFrontEnd {
+ public:
+  static constexpr int kMaxChannels = 8;
+
+  static bool supports(int sampleRate, int channels, int format);
+
+  CaptureFrontEnd(int sampleRate, int channels, int format);
+
+  int sampleRate() const { return sample_rate_; }
+  int channels() const { return channels_; }
+  int format() const { return format_; }
+  size_t frameBytes() const;
+  /** 原生格式即分析格式：process 不需要调用，原 buffer 可直接送入分析 */
+  bool passthrough() const { return passthrough_; }
+  /** 重采样器点积长度；采样率为 16k 时为 0 (只下混 / 转换) */
+  int resamplerTaps() const { return resampler_ ? resampler_->taps() : 0; }
+
+  /** frames 个原生帧至多产出的分析样本数 */
+  size_t maxOutput(size_t frames) const;
+  /** 产出不超过 outFrames 个分析样本时一次可送入的最大原生帧数 */
+  size_t inputFor(size_t outFrames) const;
+
+  /** 原生帧 (交错) → 分析样本，out 容量 ≥ maxOutput(frames)；返回分析样本数 */
+  size_t process(const void* data, size_t frames, int16_t* out);
+
+  /** 分析位置 → 原生帧位置 (扣除重采样群延迟)：区间起点向下、终点向上取整 */
+  uint64_t toNativeFloor(uint64_t analysisPos) const;
+  uint64_t toNativeCeil(uint64_t analysisPos) const;
+
+ private:
+  static constexpr size_t kBlockFrames = 256;  // 每次下混 / 重采样的原生帧数
+
+  /** 下混为 mono float；返回 mono_ 或 (float mono 时) 原 buffer */
+  const float* downmix(const void* data, size_t frames);
+  double toNative(uint64_t analysisPos) const;
+
+  const int sample_rate_;
+  const int channels_;
+  const int format_;
+  const bool passthrough_;
+  std::unique_ptr<PolyphaseResampler> resampler_;  // 采样率为 16k 时为空
+  std::vector<float> interleaved_;  // int16 多声道块的 float 暂存
+  std::vector<float> mono_;
+  std::vector<float> resampled_;
+};
+
+}  // namespace silenceguard
+
+#endif  // SILENCEGUARD_CAPTUREFRONTEND_H
@@ -0,0 +1,103 @@
+#include "ComputeGovernor.h"
+#include "InferenceScheduler.h"
+#include "feature_extraction/MelSpectrogram.h"
+#include <algorithm>
+
+namespace silenceguard {
+
+namespace {
+int clampStride(int ms) { return std::max(kMinInferenceStrideMs, std::min(kMaxInferenceStrideMs, ms)); }
+// 步长按 hop 取整，与 InferenceScheduler 一致
+int roundStride(int ms) { return clampStride((ms + kHopMs / 2) / kHopMs * kHopMs); }
+}  // namespace
+
+ComputeGovernor::ComputeGovernor() {
+  configure(GovernorOptions(), kDefaultInferenceStrideMs, 0);
+}
+
+bool ComputeGovernor::configure(const GovernorOptions& options, int baseStrideMs, int baseThreads) {
+  const OperatingPoint before = ladder_.empty() ? OperatingPoint() : current();
+  options_ = options;
+  const int base = roundStride(baseStrideMs);
+  ladder_.clear();
+  if (!options_.enabled) {
+    ladder_.push_back({base, 0, false});
+  } else {
+    // 步长段：[min, max] 内每级约放宽 1.5 倍，基准步长必在其中
+    const int lo = options_.minStrideMs < 0 ? base : std::min(base, roundStride(options_.minStrideMs));
+    const int hi = std::max(base, roundStride(options_.maxStrideMs));
+    std::vector<int> strides{lo, base, hi};
+    for (int s = lo; s < hi;) {
+      s = std::min(hi, std::max(s + kHopMs, roundStride(s * 3 / 2)));
+      strides.push_back(s);
+    }
+    std::sort(strides.begin(), strides.end());
+    strides.erase(std::unique(strides.begin(), strides.end()), strides.end());
+    for (int s : strides) ladder_.push_back({s, 0, false});
+    // 线程段：最宽步长上逐个加线程
+    int threads = 0;
+    for (int t = std::max(1, baseThreads) + 1; t <= options_.maxThreads; ++t) ladder_.push_back({hi, threads = t, false});
+    if (!options_.fallbackModel.empty()) ladder_.push_back({hi, threads, true});
+  }
+  int baseLevel = 0;
+  while (ladder_[baseLevel].strideMs < base) ++baseLevel;
+  level_ = baseLevel;
+  published_level_.store(static_cast<uint32_t>(level_), std::memory_order_relaxed);
+  intervalSamples_ = static_cast<uint64_t>(std::max(100, options_.intervalMs)) * kSampleRate / 1000;
+  calm_ = 0;
+  calmNeeded_ = kCalmIntervals;
+  sinceRaise_ = -1;
+  restartInterval();
+  return current() != before;
+}
+
+void ComputeGovernor::restartInterval() {
+  samples_ = 0;
+  busyNs_ = 0;
+  maxLagNs_ = 0;
+}
+
+bool ComputeGovernor::record(size_t samples, int64_t busyNs, int64_t lagNs) {
+  if (ladder_.size() <= 1) return false;
+  samples_ += samples;
+  busyNs_ += busyNs;
+  maxLagNs_ = std::max(maxLagNs_, lagNs);
+  if (samples_ < intervalSamples_) return false;
+
+  const float rtf = static_cast<float>(static_cast<double>(busyNs_) * kSampleRate / 1e9 / static_cast<double>(samples_));
+  const int64_t lagMs = maxLagNs_ / 1000000;
+  last_rtf_.store(rtf, std::memory_order_relaxed);
+  last_lag_ms_.store(static_cast<uint32_t>(lagMs), std::memory_order_relaxed);
+  restartInterval();
+
+  const int last = levels() - 1;
+  if (sinceRaise_ >= 0) ++sinceRaise_;
+  if (rtf > options_.targetRtf || lagMs > options_.targetLatencyMs) {
+    overloads_.fetch_add(1, std::memory_order_relaxed);
+    calm_ = 0;
+    // 刚升上来就过载：这一级撑不住，下次升级前要求更久的富余
+    if (sinceRaise_ >= 0 && sinceRaise_ <= calmNeeded_) calmNeeded_ = std::min(kMaxCalmIntervals, calmNeeded_ * 2);
+    sinceRaise_ = -1;
+    return moveTo(lagMs > static_cast<int64_t>(options_.targetLatencyMs) * kEmergencyFactor ? last
+                                                                                            : std::min(last, level_ + 1));
+  }
+  // 富余：实时率与滞后都低于目标的一半
+  if (rtf < 0.5f * options_.targetRtf && lagMs * 2 <= options_.targetLatencyMs) {
+    if (++calm_ < calmNeeded_ || level_ == 0) return false;
+    calm_ = 0;
+    sinceRaise_ = 0;
+    return moveTo(level_ - 1);
+  }
+  calm_ = 0;
+  return false;
+}
+
+bool ComputeGovernor::moveTo(int level) {
+  if (level == level_) return false;
+  level_ = level;
+  published_level_.store(static_cast<uint32_t>(level_), std::memory_order_relaxed);
+  transitions_.fetch_add(1, std::memory_order_relaxed);
+  return true;
+}
+
+}  // namespace silenceguard
@@ -0,0 +1,105 @@
+// SilenceGuard Pro — 算力调节器 (实时预算)
+// 按评估区间统计分析实时率 (分析耗时 / 音频时长，只计 VAD 开门的块) 与排队滞后，
+// 在配置边界内沿一条工作点阶梯升降：推理步长 → TFLite 线程数 → 备用轻量模型
+// 超出预算立即降一级 (滞后远超目标时直接降到底)，连续数个区间富余才升一级；
+// 升级后很快又过载说明上一级撑不住，升级所需的富余区间数翻倍 (防止在两级之间振荡)；只在分析线程使用
+
+#ifndef SILENCEGUARD_COMPUTEGOVERNOR_H
+#define SILENCEGUARD_COMPUTEGOVERNOR_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace silenceguard {
+
+/** UPDATE_CONFIG "governor": {...}；步长下限缺省为配置的 inference_stride_ms */
+struct GovernorOptions {
+  bool enabled = true;
+  float targetRtf = 0.5f;         // 分析耗时占音频时长的目标上限
+  int targetLatencyMs = 200;      // 排队滞后 (入队 → 分析完成) 的目标上限
+  int minStrideMs = -1;           // 富余时可细化到的步长；< 0 = 配置步长
+  int maxStrideMs = 320;          // 过载时可放宽到的步长
+  int maxThreads = 0;             // 过载时可增加到的 TFLite 线程数；0 = 不调线程
+  std::string fallbackModel;      // 最后一级换用的轻量模型；空 = 不换
+  int intervalMs = 1000;          // 评估区间 (音频时长)
+
+  bool operator==(const GovernorOptions& o) const {
+    return enabled == o.enabled && targetRtf == o.targetRtf && targetLatencyMs == o.targetLatencyMs &&
+           minStrideMs == o.minStrideMs && maxStrideMs == o.maxStrideMs && maxThreads == o.maxThreads &&
+           fallbackModel == o.fallbackModel && intervalMs == o.intervalMs;
+  }
+  bool operator!=(const GovernorOptions& o) const { return !(*this == o); }
+};
+
+/** 阶梯上的一个工作点 */
+struct OperatingPoint {
+  int strideMs = 0;
+  int threads = 0;        // TFLite 线程数；0 = 沿用加载选项
+  bool fallback = false;  // 使用备用模型
+
+  bool operator==(const OperatingPoint& o) const {
+    return strideMs == o.strideMs && threads == o.threads && fallback == o.fallback;
+  }
+  bool operator!=(const OperatingPoint& o) const { return !(*this == o); }
+};
+
+class ComputeGovernor {
+ public:
+  static constexpr int kCalmIntervals = 3;    // 连续富余区间数达到后升一级
+  static constexpr int kMaxCalmIntervals = 48;  // 退避后的上限
+  static constexpr int kEmergencyFactor = 4;  // 滞后超过目标的倍数：直接降到最低一级
+
+  ComputeGovernor();
+
+  /**
+   * 按选项与基准 (配置步长、加载选项的线程数) 重建阶梯；基准工作点为第一个不细于配置步长的点
+   * 重建后回到基准工作点，返回工作点是否变化
+   */
+  bool configure(const GovernorOptions& options, int baseStrideMs, int baseThreads);
+
+  /**
+   * 记录一个已分析的块：samples 为块长，busyNs 为分析耗时，lagNs 为入队到分析完成的滞后
+   * 满一个评估区间时判决；返回工作点是否变化
+   */
+  bool record(size_t samples, int64_t busyNs, int64_t lagNs);
+
+  /** 丢弃当前区间的累计 (模型加载期间的测量不代表新工作点) */
+  void restartInterval();
+
+  const OperatingPoint& current() const { return ladder_[level_]; }
+  int level() const { return level_; }
+  int levels() const { return static_cast<int>(ladder_.size()); }
+
+  /** 统计 (任意线程读取) */
+  uint64_t transitions() const { return transitions_.load(std::memory_order_relaxed); }
+  uint64_t overloads() const { return overloads_.load(std::memory_order_relaxed); }
+  float lastRtf() const { return last_rtf_.load(std::memory_order_relaxed); }
+  uint32_t lastLagMs() const { return last_lag_ms_.load(std::memory_order_relaxed); }
+  uint32_t publishedLevel() const { return published_level_.load(std::memory_order_relaxed); }
+
+ private:
+  bool moveTo(int level);
+
+  GovernorOptions options_;
+  std::vector<OperatingPoint> ladder_;  // 0 = 最细 (算力最多)，越往后越省
+  int level_ = 0;
+  uint64_t intervalSamples_ = 0;
+  uint64_t samples_ = 0;
+  int64_t busyNs_ = 0;
+  int64_t maxLagNs_ = 0;
+  int calm_ = 0;
+  int calmNeeded_ = kCalmIntervals;
+  int sinceRaise_ = -1;  // 上次升级以来的区间数；-1 = 尚未升级
+  std::atomic<uint64_t> transitions_{0};
+  std::atomic<uint64_t> overloads_{0};
+  std::atomic<float> last_rtf_{0.0f};
+  std::atomic<uint32_t> last_lag_ms_{0};
+  std::atomic<uint32_t> published_level_{0};
+};
+
+}  // namespace silenceguard
+
+#endif  // SILENCEGUARD_COMPUTEGOVERNOR_H
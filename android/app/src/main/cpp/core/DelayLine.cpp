@@ -0,0 +1,130 @@
+#include "DelayLine.h"
+#include "injector/AudioInjector.h"
+#include <algorithm>
+
+namespace silenceguard {
+
+namespace {
+const int16_t kZeros[256] = {};
+}
+
+DelayLine::DelayLine(int sampleRate, int channels)
+    : sample_rate_(sampleRate),
+      channels_(std::max(1, channels)),
+      fade_frames_(static_cast<size_t>(kMaskCrossFadeMs) * sampleRate / 1000),
+      ring_((static_cast<size_t>(kMaxLookaheadMs) * sampleRate / 1000 + kChunkFrames) * channels_),
+      tone_(static_cast<float>(kBeepFreqHz), static_cast<float>(sampleRate), kBeepAmplitude) {}
+
+void DelayLine::setDelayMs(int delayMs) {
+  delay_ms_.store(std::max(0, std::min(kMaxLookaheadMs, delayMs)), std::memory_order_relaxed);
+}
+
+bool DelayLine::scheduleMask(uint64_t start, uint64_t end) {
+  if (end <= start) return true;
+  std::lock_guard<std::mutex> lock(pending_mutex_);
+  size_t tail = pending_tail_.load(std::memory_order_relaxed);
+  if (tail - pending_head_.load(std::memory_order_acquire) >= kPendingSlots) {
+    // HAL 线程未及消费；已发布的槽可能正被读取，不能就地合并
+    dropped_masks_.fetch_add(1, std::memory_order_relaxed);
+    return false;
+  }
+  pending_[tail & (kPendingSlots - 1)] = Range{start, end};
+  pending_tail_.store(tail + 1, std::memory_order_release);
+  return true;
+}
+
+void DelayLine::reconfigure(size_t delayFrames) {
+  // 清空旧内容并预填 D 帧零样本：之后每次 read 恰好落后 write D 帧
+  ring_.discard(ring_.available());
+  for (size_t n = delayFrames * channels_; n > 0;) {
+    size_t chunk = std::min(n, sizeof(kZeros) / sizeof(kZeros[0]));
+    ring_.write(kZeros, chunk);
+    n -= chunk;
+  }
+  delay_frames_ = delayFrames;
+}
+
+void DelayLine::process(int16_t* buffer, size_t frames, uint64_t inputPos) {
+  if (!buffer || frames == 0) return;
+
+  const size_t target = static_cast<size_t>(delay_ms_.load(std::memory_order_relaxed)) * sample_rate_ / 1000;
+  if (target != delay_frames_) reconfigure(target);
+  if (delay_frames_ == 0) return;
+
+  for (size_t pos = 0; pos < frames; pos += kChunkFrames) {
+    size_t n = std::min(kChunkFrames, frames - pos);
+    int16_t* chunk = buffer + pos * channels_;
+    ring_.write(chunk, n * channels_);
+    ring_.read(chunk, n * channels_);
+
+    // 启动阶段输出的是预填零样本，其位置为负，不会命中任何区间
+    uint64_t in = inputPos + pos;
+    if (in < delay_frames_) continue;
+    uint64_t outPos = in - delay_frames_;
+    collectPending(outPos);
+    applyMasks(chunk, n, outPos);
+  }
+}
+
+void DelayLine::collectPending(uint64_t outPos) {
+  size_t head = pending_head_.load(std::memory_order_relaxed);
+  const size_t tail = pending_tail_.load(std::memory_order_acquire);
+  for (; head != tail; ++head) {
+    Range r = pending_[head & (kPendingSlots - 1)];
+    const bool late = r.start < outPos;
+    if (late) {
+      if (r.end <= outPos) {
+        late_masks_.fetch_add(1, std::memory_order_relaxed);
+        continue;
+      }
+      r.start = outPos;
+    }
+
+    // 与已有区间重叠或相邻则合并，保证 applyMasks 不重复处理
+    bool merged = false;
+    for (size_t i = 0; i < active_count_; ++i) {
+      Range& a = active_[i];
+      if (r.start <= a.end && a.start <= r.end) {
+        a.start = std::min(a.start, r.start);
+        a.end = std::max(a.end, r.end);
+        merged = true;
+        break;
+      }
+    }
+    if (!merged) {
+      // 作用中区间已满：本区间及其后的留在待生效队列，等已有区间结束腾出位置 (不丢弃)
+      if (active_count_ == kMaxActive) break;
+      active_[active_count_++] = r;
+    }
+    if (late) late_masks_.fetch_add(1, std::memory_order_relaxed);
+  }
+  pending_head_.store(head, std::memory_order_release);
+}
+
+void DelayLine::applyMasks(int16_t* out, size_t frames, uint64_t outPos) {
+  const uint64_t outEnd = outPos + frames;
+  size_t keep = 0;
+  for (size_t i = 0; i < active_count_; ++i) {
+    const Range r = active_[i];
+    uint64_t s = std::max(r.start, outPos);
+    uint64_t e = std::min(r.end, outEnd);
+    if (s < e) {
+      int16_t* seg = out + (s - outPos) * channels_;
+      size_t len = static_cast<size_t>(e - s);
+      // 区间终点落在本块：最后一段由哔声淡回原声
+      size_t tail = (r.end <= outEnd) ? std::min(fade_frames_, len) : 0;
+      size_t body = len - tail;
+      if (body > 0) {
+        // 区间起点落在本块：先由原声淡入哔声
+        const size_t fade = r.start >= outPos ? std::min(fade_frames_, body) : 0;
+        if (fade > 0) applyCrossFade(tone_, seg, fade, fade, channels_);
+        if (body > fade) applyBeep(tone_, seg + fade * channels_, body - fade, channels_);
+      }
+      if (tail > 0) applyCrossFadeOut(tone_, seg + body * channels_, tail, tail, channels_);
+    }
+    if (r.end > outEnd) active_[keep++] = r;
+  }
+  active_count_ = keep;
+}
+
+}  // namespace silenceguard
@@ -0,0 +1,93 @@
+// SilenceGuard Pro — 前视延迟线 ("时间机器"回溯掩蔽, NEXT_IMPROVEMENTS §4.1)
+// HAL 输出整体延迟 D (0–300ms)，分析线程对采样区间 [a, b) 的拦截决策
+// 可作用于尚未交给 App 的音频；区间边界用 Injector 交叉淡入/淡出
+// 全部缓冲在构造时预分配，process 无堆分配，拼接为常数次 memcpy
+// 工作在采集流的原生采样率与声道数上 (交错 int16)，位置以帧计
+
+#ifndef SILENCEGUARD_DELAYLINE_H
+#define SILENCEGUARD_DELAYLINE_H
+
+#include "RingBuffer.h"
+#include "injector/ToneGenerator.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+
+namespace silenceguard {
+
+constexpr int kMaxLookaheadMs = 300;
+constexpr int kMaskCrossFadeMs = 5;
+
+class DelayLine {
+ public:
+  /** sampleRate 用于 ms → 帧换算；环容量 = (最大延迟 + 一个处理块) × channels */
+  explicit DelayLine(int sampleRate, int channels = 1);
+
+  /** 目标延迟 (ms)，限制在 [0, 300]；下一次 process 时在 HAL 线程生效 */
+  void setDelayMs(int delayMs);
+  int delayMs() const { return delay_ms_.load(std::memory_order_relaxed); }
+  bool enabled() const { return delayMs() > 0; }
+  /** HAL 线程：目标与当前生效的延迟都为 0，process 为直通 */
+  bool bypassed() const { return delayMs() == 0 && delay_frames_ == 0; }
+  int channels() const { return channels_; }
+
+  /**
+   * HAL 线程：buffer (frames 帧 × channels 交错) 原地替换为延迟 D 后的音频，并对落入本次输出的拦截区间做掩蔽
+   * inputPos 为首帧的绝对帧位置 (与 scheduleMask 同一坐标)
+   */
+  void process(int16_t* buffer, size_t frames, uint64_t inputPos);
+
+  /**
+   * 任意线程：登记需要掩蔽的绝对帧区间 [start, end)
+   * 待生效区间已满 (HAL 线程未及消费) 时返回 false 并计入 droppedMasks，调用方须改用其它拦截方式
+   */
+  bool scheduleMask(uint64_t start, uint64_t end);
+
+  /** 因决策太晚、起点已送出而被截短的区间数 */
+  uint64_t lateMasks() const { return late_masks_.load(std::memory_order_relaxed); }
+  /** 登记时待生效区间已满而丢弃的区间数 (作用中区间已满时区间留在待生效队列等待，不丢弃) */
+  uint64_t droppedMasks() const { return dropped_masks_.load(std::memory_order_relaxed); }
+
+  /** 本延迟线的哔声振荡器 (HAL 线程私有)：多路流各自保持相位，互不干扰 */
+  ToneGenerator& tone() { return tone_; }
+
+ private:
+  struct Range {
+    uint64_t start;
+    uint64_t end;
+  };
+
+  static constexpr size_t kChunkFrames = 1024;
+  static constexpr size_t kPendingSlots = 16;  // 2 的幂
+  static constexpr size_t kMaxActive = 8;
+
+  void reconfigure(size_t delayFrames);
+  void collectPending(uint64_t outPos);
+  void applyMasks(int16_t* out, size_t frames, uint64_t outPos);
+
+  const int sample_rate_;
+  const int channels_;
+  const size_t fade_frames_;  // 区间边界的交叉淡化长度
+  RingBuffer ring_;
+  std::atomic<int> delay_ms_{0};
+  size_t delay_frames_ = 0;  // HAL 线程当前生效值
+
+  // 待生效区间：多生产者 (持 pending_mutex_)，HAL 线程无锁消费
+  std::mutex pending_mutex_;
+  Range pending_[kPendingSlots];
+  std::atomic<size_t> pending_head_{0};
+  std::atomic<size_t> pending_tail_{0};
+
+  // HAL 线程私有：正在作用的区间与掩蔽哔声
+  Range active_[kMaxActive];
+  size_t active_count_ = 0;
+  ToneGenerator tone_;
+
+  std::atomic<uint64_t> late_masks_{0};
+  std::atomic<uint64_t> dropped_masks_{0};
+};
+
+}  // namespace silenceguard
+
+#endif  // SILENCEGUARD_DELAYLINE_H
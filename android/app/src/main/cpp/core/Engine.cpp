@@ -1,181 +1,1191 @@
+#include "CaptureFrontEnd.h"
+#include "ComputeGovernor.h"
+#include "DelayLine.h"
+#include "EngineConfig.h"
+#include "EngineStats.h"
+#include "InferenceScheduler.h"
+#include "LatencyHistogram.h"
 #include "RingBuffer.h"
-#include "feature_extraction/MelSpectrogram.h"
+#include "SpscBlockQueue.h"
+#include "feature_extraction/StreamingMelExtractor.h"
+#include "feature_extraction/VoiceActivityDetector.h"
 #include "inference/TFLiteRunner.h"
 #include "inference/ConfMatrix.h"
-#include "injector/AudioInjector.h" 
+#include "inference/KeywordDecoder.h"
+#include "injector/AudioInjector.h"
+#include "injector/PcmKernels.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <cstdint>
 #include <cstdio>
 #include <cstring>
+#include <memory>
 #include <mutex>
 #include <string>
+#include <sys/stat.h>
+#include <thread>
 #include <vector>
 
 namespace silenceguard {
 
 class ProtectionEngine {
  public:
+  class Session;
+
+  // 工作线程池上限：每个工作线程对应一个推理槽 (一个解释器)
+  static constexpr int kMaxWorkers = 4;
+
   static ProtectionEngine* getInstance() {
     static ProtectionEngine s;
     return &s;
   }
-  
+
   void init() {
      initialized_ = true;
   }
-  
+
+  /**
+   * 后台加载模型：立即返回，构建 + 预跑在 TFLiteRunner 的加载线程完成后原子换入；
+   * 期间分析线程继续用旧模型推理，不持有会话 mutex_，音频路径无停顿
+   */
   void loadModel(const char* path) {
-      std::lock_guard<std::mutex> lock(mutex_);
-      if (tfRunner_.loadModel(path)) {
-          printf("Model loaded from: %s\n", path);
+      {
+          std::lock_guard<std::mutex> lock(model_mutex_);
+          loadModelAsyncLocked(path);
       }
+      loadSiblingConfMatrix(path);
   }
 
-  void pushToBuffer(const void* data, size_t bytes) {
-    std::lock_guard<std::mutex> lock(mutex_);
-    
-    size_t frames = bytes / sizeof(int16_t);
-    const int16_t* pcm = static_cast<const int16_t*>(data);
-    ring_.write(pcm, frames);
-
-    processed_samples_ += frames;
-    if (processed_samples_ >= 8000) { 
-        std::vector<int16_t> window(8000);
-        
-        std::vector<float> mel(50 * 80);
-        int validFrames = computeMelFrames(pcm, frames, mel.data(), 50); 
-        
-        if (validFrames > 0 && tfRunner_.isLoaded()) {
-            std::vector<float> posteriors;
-            if (tfRunner_.run(mel.data(), validFrames * 80, &posteriors)) {
-                float risk_score = 0.0f; 
-                for(float p : posteriors) risk_score += p;
-                
-                if (risk_score > global_sensitivity_) {
-                    intercept_requested_ = true;
-                    intercept_frames_remaining_ = 3200; // 200ms mute
-                }
-            }
-        }
-        processed_samples_ = 0;
+  /** 以指定选项加载，并作为后续加载 (含 updateConfig 触发的重载) 的默认选项 */
+  void loadModel(const char* path, const TFLiteLoadOptions& options) {
+      {
+          std::lock_guard<std::mutex> lock(model_mutex_);
+          load_options_ = options;
+          load_threads_.store(options.numThreads, std::memory_order_relaxed);
+          loadModelAsyncLocked(path);
+      }
+      loadSiblingConfMatrix(path);
+  }
+
+  /** 等待全部推理槽的后台加载结束 (离线工具 / 测试用)；返回是否都有可用模型 */
+  bool waitForModel() {
+    bool ok = true;
+    const int workers = workers_.load(std::memory_order_acquire);
+    for (int i = 0; i < workers; ++i) ok = slots_[i].runner.waitForLoad() && ok;
+    return ok;
+  }
+
+  /**
+   * 打开一路采集会话 (如 VoIP 流 + 录音流、两个输入设备)：独立的环形缓冲、特征、VAD、
+   * 解码器、延迟线、掩蔽器与拦截状态；分析由共享的工作线程池完成
+   * sampleRate / channels / format 为 HAL 原生格式：采集前端下混 + 重采样到 16kHz mono 供分析，
+   * 延迟线与哔声在原 buffer 上按原生格式处理；CaptureFrontEnd 不支持的格式返回 nullptr
+   */
+  Session* openSession(int sampleRate, int channels, int format = kSampleInt16) {
+    if (!CaptureFrontEnd::supports(sampleRate, channels, format)) {
+      printf("[SilenceGuard] openSession: unsupported format %d Hz x %d (format %d)\n", sampleRate, channels, format);
+      return nullptr;
     }
+    std::lock_guard<std::mutex> lock(sessions_mutex_);
+    auto session = std::make_shared<Session>(this, next_session_id_++, sampleRate, channels, format);
+    auto next = std::make_shared<SessionList>(*std::atomic_load(&sessions_));
+    next->push_back(session);
+    std::atomic_store(&sessions_, std::shared_ptr<const SessionList>(std::move(next)));
+    sessions_opened_.fetch_add(1, std::memory_order_relaxed);
+    return session.get();
   }
 
-  bool shouldIntercept() {
-    std::lock_guard<std::mutex> lock(mutex_);
-    if (test_intercept_enabled_ && test_frames_remaining_ > 0) {
-      --test_frames_remaining_;
-      return true;
+  /**
+   * 关闭会话：从会话表摘除，队列中未分析的块丢弃；正在分析它的工作线程持有引用，分析完后释放
+   * 调用方须保证之后不再以该句柄调用；默认会话不可关闭
+   */
+  void closeSession(Session* session) {
+    if (!session || session == default_session_) return;
+    std::lock_guard<std::mutex> lock(sessions_mutex_);
+    auto next = std::make_shared<SessionList>(*std::atomic_load(&sessions_));
+    next->erase(std::remove_if(next->begin(), next->end(),
+                               [session](const std::shared_ptr<Session>& s) { return s.get() == session; }),
+                next->end());
+    std::atomic_store(&sessions_, std::shared_ptr<const SessionList>(std::move(next)));
+  }
+
+  /** 引擎级接口 (pushToBuffer / shouldIntercept / getStats …) 作用的会话 */
+  Session* defaultSession() { return default_session_; }
+
+  /**
+   * HAL in_read 线程入口 (默认会话)
+   * 异步模式 (默认)：只把 PCM 拷进 wait-free SPSC 队列，不加锁、不做分析
+   * 同步模式：在调用线程上直接跑 Mel + TFLite (仅供调试 / 离线复现)
+   */
+  void pushToBuffer(const void* data, size_t bytes) { default_session_->pushToBuffer(data, bytes); }
+
+  void processLookahead(int16_t* buffer, size_t frames) {
+    default_session_->processLookahead(buffer, frames * sizeof(int16_t));
+  }
+
+  bool shouldIntercept() { return default_session_->shouldIntercept(); }
+
+  void setTestInterceptEnabled(bool enabled) { default_session_->setTestInterceptEnabled(enabled); }
+
+  /** 切换异步分析模式：开启时启动工作线程池，关闭时排空全部会话的队列并回收线程 */
+  void setAsyncAnalysis(bool enabled) {
+    std::lock_guard<std::mutex> lock(thread_mutex_);
+    if (enabled == async_analysis_.load(std::memory_order_acquire)) return;
+    if (enabled) {
+      startWorkersLocked();
+      async_analysis_.store(true, std::memory_order_release);
+    } else {
+      async_analysis_.store(false, std::memory_order_release);
+      stopWorkersLocked();
     }
-    
-    if (intercept_requested_) {
-        if (intercept_frames_remaining_ > 0) {
-            --intercept_frames_remaining_;
-            return true;
-        } else {
-            intercept_requested_ = false;
-        }
+  }
+
+  /**
+   * 工作线程数 (= 推理槽数，1 – kMaxWorkers)：会话按 id 绑定推理槽，槽内推理串行；
+   * 新增的槽在后台加载当前模型。调整时先排空队列、停下线程池
+   */
+  void setWorkerCount(int workers) {
+    workers = std::max(1, std::min(kMaxWorkers, workers));
+    std::lock_guard<std::mutex> lock(thread_mutex_);
+    const bool async = async_analysis_.load(std::memory_order_acquire);
+    if (async) stopWorkersLocked();
+    {
+      std::lock_guard<std::mutex> modelLock(model_mutex_);
+      const int before = workers_.exchange(workers, std::memory_order_acq_rel);
+      if (workers > before && !model_path_.empty()) loadSlotsLocked(before, workers);
     }
-    
-    return false;
+    if (async) startWorkersLocked();
   }
 
-  void setTestInterceptEnabled(bool enabled) {
-    std::lock_guard<std::mutex> lock(mutex_);
-    test_intercept_enabled_ = enabled;
-    if (enabled) test_frames_remaining_ = 1600;  // 100ms @ 16kHz
+  void getAnalysisCounters(uint64_t* enqueued, uint64_t* dropped, uint64_t* late) const {
+    default_session_->getAnalysisCounters(enqueued, dropped, late);
   }
 
-  RingBuffer& getRingBuffer() { return ring_; }
+  void getSchedulerCounters(uint64_t* windows, uint64_t* skipped) const {
+    default_session_->getSchedulerCounters(windows, skipped);
+  }
+
+  /** 拦截决策累计次数与最近一次决策所在窗口末端 (流内样本位置) */
+  void getInterceptCounters(uint64_t* decisions, uint64_t* lastPosition) const {
+    default_session_->getInterceptCounters(decisions, lastPosition);
+  }
+
+  /** 统计快照：会话的阶段延迟与计数器 + 引擎级 (模型 / 配置 / 调节器 / 线程池)；任意线程调用，不阻塞热路径 */
+  void getStats(const Session* session, SgEngineStats* out) const {
+    *out = SgEngineStats{};
+    out->version = SG_ENGINE_STATS_VERSION;
+    out->stage_count = SG_STAGE_COUNT;
+    session->fillStats(out);
+
+    const TFLiteLoadTimings t = slots_[out->session_slot].runner.loadTimings();
+    out->model_load_us = t.loadUs;
+    out->model_warmup_us = t.warmupUs;
+    out->model_first_inference_us = t.firstInferenceUs;
+    out->model_threads = t.numThreads;
+    out->model_xnnpack = t.xnnpackApplied ? 1 : 0;
+    out->model_input_type = static_cast<uint32_t>(t.inputType);
+    out->model_output_type = static_cast<uint32_t>(t.outputType);
+    out->model_chunk_frames = t.chunkFrames;
+    out->model_state_tensors = t.stateTensors;
+
+    out->kws_keywords = kws_keywords_.load(std::memory_order_relaxed);
+    out->kws_graph_nodes = kws_graph_nodes_.load(std::memory_order_relaxed);
+    out->config_publishes = config_publishes_.load(std::memory_order_relaxed);
+    out->config_rejected = config_rejected_.load(std::memory_order_relaxed);
+    out->config_parse_us = config_parse_us_.load(std::memory_order_relaxed);
+    out->config_compile_us = config_compile_us_.load(std::memory_order_relaxed);
+    out->gov_transitions = governor_.transitions();
+    out->gov_overloads = governor_.overloads();
+    out->gov_rtf = governor_.lastRtf();
+    out->gov_lag_ms = governor_.lastLagMs();
+    out->gov_level = governor_.publishedLevel();
+    out->gov_levels = governor_levels_.load(std::memory_order_relaxed);
+    out->gov_stride_ms = governor_stride_ms_.load(std::memory_order_relaxed);
+    out->gov_threads = governor_threads_.load(std::memory_order_relaxed);
+    out->gov_fallback = governor_fallback_.load(std::memory_order_relaxed) ? 1 : 0;
+    out->sessions_open = static_cast<uint32_t>(std::atomic_load(&sessions_)->size());
+    out->sessions_opened = sessions_opened_.load(std::memory_order_relaxed);
+    out->pool_workers = static_cast<uint32_t>(workers_.load(std::memory_order_relaxed));
+  }
+
+  void getStats(SgEngineStats* out) const { getStats(default_session_, out); }
+
+  /** 清零全部会话的延迟直方图 (计数器保持累计) */
+  void resetStats() {
+    const std::shared_ptr<const SessionList> sessions = std::atomic_load(&sessions_);
+    for (const std::shared_ptr<Session>& s : *sessions) s->resetStats();
+  }
+
+  RingBuffer& getRingBuffer() { return default_session_->ring(); }
 
   /**
    * [新增] 获取 Masker 实例供外部调用 (如 Hook 层)
    * 当检测到违规时，Hook 层可直接调用 engine->getMasker().process(buffer, frames)
    */
-  NoiseMasker& getMasker() { return masker_; }
+  NoiseMasker& getMasker() { return default_session_->masker(); }
 
   /**
-   * [升级] 支持配置 Masking 参数
-   * Web 端发送 {"masking": {"attack": 15, "release": 100}}
+   * UPDATE_CONFIG：在调用线程把整个载荷解析为 EngineConfig 并编译关键词图，再原子发布
+   * 不持有任何会话 mutex_：万级词表的推送不阻塞分析线程 (及同步模式下的 HAL 线程)；JSON 不合法时整包丢弃
+   * Web 端发送 {"keywords": [...], "global_sensitivity": 0.85, "masking": {"attack": 15, "release": 100}}
    */
   void updateConfig(const char* json) {
     if (!json) return;
-    std::lock_guard<std::mutex> lock(mutex_);
-    last_config_json_ = json;
-    
-    global_sensitivity_ = parseGlobalSensitivity(json);
-    keyword_count_ = parseKeywordCount(json);
-
-    // 新增：解析 masking 参数
-    float attack = parseJsonFloat(json, "\"attack\"", 10.0f);
-    float release = parseJsonFloat(json, "\"release\"", 50.0f);
-    masker_.setEnvelopeParams(attack, release);
-  }
-  
-  const std::string& getLastConfigJson() const { return last_config_json_; }
+    const int64_t parseStart = nowNs();
+    auto next = std::make_shared<EngineConfig>();
+    if (!parseEngineConfig(json, next.get())) {
+      config_rejected_.fetch_add(1, std::memory_order_relaxed);
+      printf("[SilenceGuard] UPDATE_CONFIG rejected: malformed JSON\n");
+      return;
+    }
+    config_parse_us_.store(static_cast<uint32_t>((nowNs() - parseStart) / 1000), std::memory_order_relaxed);
+
+    std::unique_lock<std::mutex> writer(config_mutex_);
+    const std::shared_ptr<const EngineConfig> prev = std::atomic_load(&config_);
+    if (prev->keywords->specs() == next->keywords->specs() && prev->phonemeUnits == next->phonemeUnits) {
+      // 词表 / 单元表未变：沿用已编译的图
+      next->graph = prev->graph;
+      next->graphReport = prev->graphReport;
+      config_compile_us_.store(0, std::memory_order_relaxed);
+    } else {
+      compileKeywordGraph(next.get());
+    }
+
+    // 掩蔽包络与前视延迟本身是原子量，各会话的 HAL 线程下一次读取即生效；推理步长由调节器按新配置重定
+    {
+      std::lock_guard<std::mutex> lock(sessions_mutex_);
+      for (const std::shared_ptr<Session>& s : *std::atomic_load(&sessions_)) s->applyHalConfig(*next);
+    }
+    publishConfigLocked(next);
+    writer.unlock();
+
+    // TFLite 执行选项：变化时按新选项在后台重载当前模型
+    std::lock_guard<std::mutex> modelLock(model_mutex_);
+    TFLiteLoadOptions options = load_options_;
+    if (next->hasTfliteThreads) options.numThreads = next->tfliteThreads;
+    if (next->tfliteXnnpack >= 0) options.useXnnpack = next->tfliteXnnpack != 0;
+    if (next->tfliteWarmup >= 0) options.warmupRuns = next->tfliteWarmup;
+    if (options != load_options_) {
+      load_options_ = options;
+      load_threads_.store(options.numThreads, std::memory_order_relaxed);
+      if (!model_path_.empty()) loadModelAsyncLocked(model_path_.c_str());
+    }
+  }
+
+  /** 当前已发布的配置快照 (任意线程) */
+  std::shared_ptr<const EngineConfig> config() const { return std::atomic_load(&config_); }
+
   const std::string& getLastFalsePositiveWord() const { return last_false_positive_word_; }
   int64_t getLastFalsePositiveTs() const { return last_false_positive_ts_; }
-  
+
   void markFalsePositive(const char* word, int64_t timestamp) {
-      std::lock_guard<std::mutex> lock(mutex_);
+      std::lock_guard<std::mutex> lock(false_positive_mutex_);
       if (word) last_false_positive_word_ = word;
       last_false_positive_ts_ = timestamp;
   }
 
  private:
-  ProtectionEngine() : masker_(16000.0f) {} // 初始化 Masker
-
-  static float parseGlobalSensitivity(const char* json) {
-    const char* key = "\"global_sensitivity\"";
-    const char* p = strstr(json, key);
-    if (!p) return 0.85f;
-    p += strlen(key);
-    while (*p && (*p == ' ' || *p == ':' || *p == ' ')) ++p;
-    float v = 0.85f;
-    if (sscanf(p, "%f", &v) >= 1) return v;
-    return 0.85f;
-  }
-
-  static int parseKeywordCount(const char* json) {
-    const char* key = "\"keywords\"";
-    const char* p = strstr(json, key);
-    if (!p) return 0;
-    p = strchr(p, '[');
-    if (!p) return 0;
-    int n = 0;
-    for (++p; *p && *p != ']'; ++p)
-      if (*p == '{') ++n;
-    return n;
-  }
-
-  // 辅助解析函数
-  static float parseJsonFloat(const char* json, const char* key, float defaultVal) {
-    const char* p = strstr(json, key);
-    if (!p) return defaultVal;
-    p += strlen(key);
-    while (*p && (*p == ' ' || *p == ':' || *p == ' ' || *p == '"')) ++p;
-    float v = defaultVal;
-    if (sscanf(p, "%f", &v) >= 1) return v;
-    return defaultVal;
-  }
-
-  std::mutex mutex_;
-  RingBuffer ring_;
-  std::string last_config_json_;
+  // 64 × 1024 样本 ≈ 4s @ 16kHz 的排队余量 (每个会话一个队列)
+  using PcmQueue = SpscBlockQueue<64, 1024>;
+  using SessionList = std::vector<std::shared_ptr<Session>>;
+  // 入队到开始分析超过此时长记为迟到块
+  static constexpr int64_t kLateBlockNs = 50 * 1000 * 1000;
+  static constexpr auto kIdlePoll = std::chrono::milliseconds(2);
+  // 工作线程每次拿到一个会话最多连续分析的块数 (多会话时轮转，避免一路流独占线程)
+  static constexpr int kDrainBlocks = 8;
+  static constexpr int kMaxKeywordHits = 16;  // 单次推理最多登记的命中
+  static constexpr uint64_t kInterceptTailSamples = 3200;  // 200ms
+
+  /**
+   * 推理槽：一个解释器 (TFLiteRunner) + 串行化其 invoke 的 mutex；会话按 id 绑定
+   * streamOwner / streamGeneration 记录上下文里的流式状态属于哪个会话 (持有 mutex 时读写)
+   */
+  struct InferenceSlot {
+    std::mutex mutex;
+    TFLiteRunner runner;
+    uint32_t streamOwner = 0;
+    uint64_t streamGeneration = 0;
+  };
+
+ public:
+  /**
+   * 采集会话：一路采集流的全部流状态；HAL 线程 → 会话的 SPSC 队列 → 共享工作线程池
+   * 每个会话有自己的 mutex_，不同会话的分析并行、互不阻塞；推理经绑定的推理槽串行
+   */
+  class Session {
+   public:
+    Session(ProtectionEngine* engine, uint32_t id, int sampleRate, int channels, int format)
+        : engine_(engine), id_(id), active_config_(std::make_shared<EngineConfig>()),
+          front_end_(sampleRate, channels, format), delay_line_(sampleRate, channels),
+          masker_(static_cast<float>(sampleRate)) { // 初始化 Masker (原生采样率)
+      if (!front_end_.passthrough()) analysis_pcm_.resize(PcmQueue::blockFrames());
+      if (format == kSampleFloat32) lookahead_pcm_.resize(kLookaheadChunkFrames * static_cast<size_t>(channels));
+      applyHalConfig(*engine_->config());
+    }
+
+    uint32_t id() const { return id_; }
+    RingBuffer& ring() { return ring_; }
+    NoiseMasker& masker() { return masker_; }
+
+    /**
+     * HAL 线程：原生格式的 buffer 经采集前端转为 16kHz mono，异步模式入队，同步模式在调用线程分析
+     * 按块转换，每块的分析样本不超过一个队列块
+     */
+    void pushToBuffer(const void* data, size_t bytes) {
+      const size_t frames = bytes / front_end_.frameBytes();
+      if (!data || frames == 0) return;
+      StageTimer timer(stage_[SG_STAGE_PUSH]);
+
+      native_pos_ += frames;
+      if (front_end_.passthrough()) {
+        pushAnalysis(static_cast<const int16_t*>(data), frames);
+        return;
+      }
+      const uint8_t* src = static_cast<const uint8_t*>(data);
+      const size_t chunk = front_end_.inputFor(PcmQueue::blockFrames());
+      for (size_t pos = 0; pos < frames; pos += chunk) {
+        const size_t n = std::min(chunk, frames - pos);
+        const size_t produced = front_end_.process(src + pos * front_end_.frameBytes(), n, analysis_pcm_.data());
+        pushAnalysis(analysis_pcm_.data(), produced);
+      }
+    }
+
+    /**
+     * HAL 线程：前视延迟线 ("时间机器")，须在同一 buffer 的 pushToBuffer 之后调用
+     * buffer 原地替换为延迟后的音频，并对已登记的拦截区间做掩蔽；延迟为 0 时不做任何事
+     * float32 流经预分配的 int16 暂存通过延迟线 (延迟期间按 16 bit 量化)
+     */
+    void processLookahead(void* buffer, size_t bytes) {
+      const size_t frames = bytes / front_end_.frameBytes();
+      if (!buffer || frames > native_pos_) return;
+      StageTimer timer(stage_[SG_STAGE_LOOKAHEAD]);
+      const uint64_t start = native_pos_ - frames;
+      if (front_end_.format() != kSampleFloat32) {
+        delay_line_.process(static_cast<int16_t*>(buffer), frames, start);
+        return;
+      }
+      if (delay_line_.bypassed()) return;
+      float* pcm = static_cast<float*>(buffer);
+      const size_t ch = static_cast<size_t>(front_end_.channels());
+      for (size_t pos = 0; pos < frames; pos += kLookaheadChunkFrames) {
+        const size_t n = std::min(kLookaheadChunkFrames, frames - pos);
+        floatToInt16(pcm + pos * ch, lookahead_pcm_.data(), n * ch);
+        delay_line_.process(lookahead_pcm_.data(), n, start + pos);
+        int16ToFloat(lookahead_pcm_.data(), pcm + pos * ch, n * ch);
+      }
+    }
+
+    /** HAL 线程读取拦截决策：仅原子操作 */
+    bool shouldIntercept() {
+      if (test_intercept_enabled_.load(std::memory_order_relaxed) &&
+          consumeOne(test_frames_remaining_)) {
+        return true;
+      }
+      return consumeOne(intercept_frames_remaining_);
+    }
+
+    void setTestInterceptEnabled(bool enabled) {
+      if (enabled) test_frames_remaining_.store(1600, std::memory_order_relaxed);  // 100ms @ 16kHz
+      test_intercept_enabled_.store(enabled, std::memory_order_relaxed);
+    }
+
+    /** HAL 线程：即时拦截的哔声 (原生格式 buffer)，用本会话的振荡器 (多路 HAL 线程不共用相位状态) */
+    void applyBeep(void* buffer, size_t bytes) {
+      const size_t frames = bytes / front_end_.frameBytes();
+      if (!buffer || frames == 0) return;
+      if (front_end_.format() == kSampleFloat32) {
+        silenceguard::applyBeep(delay_line_.tone(), static_cast<float*>(buffer), frames, front_end_.channels());
+      } else {
+        silenceguard::applyBeep(delay_line_.tone(), static_cast<int16_t*>(buffer), frames, front_end_.channels());
+      }
+    }
+
+    /** 哔声振荡器改用 HAL 实际采样率 (流打开时、首次 in_read 之前调用) */
+    void setToneSampleRate(int sampleRate) {
+      if (sampleRate > 0) delay_line_.tone().setSampleRate(static_cast<float>(sampleRate));
+    }
+
+    /** 配置中由 HAL 线程读取的部分 (掩蔽包络、前视延迟)：原子量，立即生效 */
+    void applyHalConfig(const EngineConfig& cfg) {
+      masker_.setEnvelopeParams(cfg.masking.attackMs, cfg.masking.releaseMs);
+      delay_line_.setDelayMs(cfg.masking.lookaheadMs);
+    }
+
+    void getAnalysisCounters(uint64_t* enqueued, uint64_t* dropped, uint64_t* late) const {
+      if (enqueued) *enqueued = enqueued_blocks_.load(std::memory_order_relaxed);
+      if (dropped) *dropped = dropped_blocks_.load(std::memory_order_relaxed);
+      if (late) *late = late_blocks_.load(std::memory_order_relaxed);
+    }
+
+    void getSchedulerCounters(uint64_t* windows, uint64_t* skipped) const {
+      if (windows) *windows = scheduler_.scheduledWindows();
+      if (skipped) *skipped = scheduler_.skippedWindows();
+    }
+
+    void getInterceptCounters(uint64_t* decisions, uint64_t* lastPosition) const {
+      if (decisions) *decisions = intercept_decisions_.load(std::memory_order_acquire);
+      if (lastPosition) *lastPosition = last_decision_pos_.load(std::memory_order_relaxed);
+    }
+
+    /** 会话部分的统计 (阶段延迟与流相关计数器) */
+    void fillStats(SgEngineStats* out) const {
+      for (int i = 0; i < SG_STAGE_COUNT; ++i) {
+        const LatencyHistogram& h = stage_[i];
+        SgStageStats& s = out->stages[i];
+        s.count = h.count();
+        s.sum_ns = h.sumNs();
+        s.p50_ns = h.percentile(0.50);
+        s.p90_ns = h.percentile(0.90);
+        s.p99_ns = h.percentile(0.99);
+        s.max_ns = h.maxNs();
+      }
+      out->intercept_decisions = intercept_decisions_.load(std::memory_order_acquire);
+      out->masks_scheduled = masks_scheduled_.load(std::memory_order_relaxed);
+      out->immediate_intercepts = immediate_intercepts_.load(std::memory_order_relaxed);
+      out->late_masks = delay_line_.lateMasks();
+      out->dropped_masks = delay_line_.droppedMasks();
+      out->inference_failures = inference_failures_.load(std::memory_order_relaxed);
+      getAnalysisCounters(&out->blocks_enqueued, &out->blocks_dropped, &out->blocks_late);
+      getSchedulerCounters(&out->windows_scheduled, &out->windows_skipped);
+      out->stream_chunks = stream_chunks_.load(std::memory_order_relaxed);
+      out->stream_resets = stream_resets_.load(std::memory_order_relaxed);
+
+      out->kws_frames = kws_frames_.load(std::memory_order_relaxed);
+      out->kws_hits = kws_hits_.load(std::memory_order_acquire);
+      out->kws_peak_tokens = kws_peak_tokens_.load(std::memory_order_relaxed);
+      out->kws_last_keyword = kws_last_keyword_.load(std::memory_order_relaxed);
+      out->kws_last_start = kws_last_start_.load(std::memory_order_relaxed);
+      out->kws_last_end = kws_last_end_.load(std::memory_order_relaxed);
+      out->kws_last_score = kws_last_score_.load(std::memory_order_relaxed);
+      out->vad_samples = vad_samples_.load(std::memory_order_relaxed);
+      out->vad_skipped_samples = vad_skipped_samples_.load(std::memory_order_relaxed);
+      out->vad_hops = vad_.hops();
+      out->vad_speech_hops = vad_.speechHops();
+      out->vad_openings = vad_.openings();
+      out->session_id = id_;
+      out->session_slot = static_cast<uint32_t>(engine_->slotIndex(id_));
+      out->stream_state_restores = stream_state_restores_.load(std::memory_order_relaxed);
+      out->capture_sample_rate = static_cast<uint32_t>(front_end_.sampleRate());
+      out->capture_channels = static_cast<uint32_t>(front_end_.channels());
+      out->capture_format = static_cast<uint32_t>(front_end_.format());
+      out->resampler_taps = static_cast<uint32_t>(front_end_.resamplerTaps());
+    }
+
+    void resetStats() {
+      for (LatencyHistogram& h : stage_) h.reset();
+    }
+
+    /** 工作线程：队首是否有待分析的块 (近似，不加锁) */
+    bool hasPending() const { return queue_.front() != nullptr; }
+
+    /**
+     * 工作线程：会话未被其它线程占用时连续分析至多 maxBlocks 块；返回分析的块数
+     * 会话 mutex_ 保证同一时刻只有一个消费者，队列的 SPSC 约束与块顺序不变
+     */
+    int drain(int maxBlocks) {
+      std::unique_lock<std::mutex> lock(mutex_, std::try_to_lock);
+      if (!lock.owns_lock()) return 0;
+      int done = 0;
+      while (done < maxBlocks) {
+        const PcmQueue::Block* block = queue_.front();
+        if (!block) break;
+        const int64_t dequeueNs = nowNs();
+        stage_[SG_STAGE_QUEUE_WAIT].record(static_cast<uint64_t>(std::max<int64_t>(0, dequeueNs - block->enqueueNs)));
+        if (dequeueNs - block->enqueueNs > kLateBlockNs) {
+          late_blocks_.fetch_add(1, std::memory_order_relaxed);
+        }
+        recordSince(SG_STAGE_LOCK_WAIT, dequeueNs);
+        // 本块之后还有排队的块：积压中，只喂 Mel 不推理，追上后只推理最新窗口
+        const bool backlog = queue_.size() > 1;
+        analyzeLocked(block->pcm, block->frames, block->position, block->enqueueNs, backlog);
+        queue_.pop();
+        ++done;
+      }
+      return done;
+    }
+
+   private:
+    // 16kHz mono 分析样本：推进分析位置后入队或就地分析
+    void pushAnalysis(const int16_t* pcm, size_t frames) {
+      if (frames == 0) return;
+      const uint64_t position = analysis_pos_;
+      analysis_pos_ += frames;
+
+      if (engine_->async_analysis_.load(std::memory_order_acquire)) {
+        const int64_t now = nowNs();
+        for (size_t pos = 0; pos < frames; pos += PcmQueue::blockFrames()) {
+          size_t n = std::min(frames - pos, PcmQueue::blockFrames());
+          if (queue_.tryPush(pcm + pos, n, now, position + pos)) {
+            enqueued_blocks_.fetch_add(1, std::memory_order_relaxed);
+          } else {
+            dropped_blocks_.fetch_add(1, std::memory_order_relaxed);
+          }
+        }
+        return;
+      }
+
+      const int64_t lockStart = nowNs();
+      std::lock_guard<std::mutex> lock(mutex_);
+      recordSince(SG_STAGE_LOCK_WAIT, lockStart);
+      analyzeLocked(pcm, frames, position, lockStart);
+    }
+
+    /**
+     * 分析一块并喂给引擎的调节器；调用方持有 mutex_
+     * sinceNs 为块入队 (异步) 或开始等锁 (同步) 的时刻：到分析完成的时长即排队滞后
+     */
+    void analyzeLocked(const int16_t* pcm, size_t frames, uint64_t position, int64_t sinceNs, bool backlog = false) {
+      const int32_t stride = engine_->governor_stride_ms_.load(std::memory_order_relaxed);
+      if (stride != scheduler_.strideMs()) scheduler_.setStrideMs(stride);
+      const int64_t start = nowNs();
+      const bool analyzed = analyzeBlockLocked(pcm, frames, position, backlog);
+      const int64_t end = nowNs();
+      engine_->recordAnalysis(frames, analyzed, end - start, end - sinceNs);
+    }
+
+    // 分析侧 (持有 mutex_)：代号变化时换入新快照；关键词图变化时重置解码器
+    void adoptConfigLocked() {
+      const uint64_t generation = engine_->config_generation_.load(std::memory_order_acquire);
+      if (generation == active_generation_) return;
+      active_generation_ = generation;
+      std::shared_ptr<const EngineConfig> next = engine_->config();
+      kws_.setOptions(next->kws);
+      if (next->graph != active_config_->graph) kws_.setGraph(next->graph);
+      if (next->vad != active_config_->vad) vad_.setOptions(next->vad);
+      active_config_ = std::move(next);
+    }
+
+    // 分析主体：ring → VAD 门 → 流式 Mel → TFLite → 决策；返回 false 表示 VAD 门关闭、未分析
+    // backlog：队列中还有后续块，窗口模型本块不推理 (流式模型须逐块推进状态，不受影响)
+    bool analyzeBlockLocked(const int16_t* pcm, size_t frames, uint64_t position, bool backlog) {
+      adoptConfigLocked();
+      ring_.write(pcm, frames);
+      size_t preRoll = 0;
+      if (!gateLocked(pcm, frames, &preRoll)) return false;
+
+      // 推理槽在本块内独占；租约钉住当前模型：推理期间的热替换不会释放它
+      InferenceSlot& slot = engine_->slotFor(id_);
+      std::lock_guard<std::mutex> slotLock(slot.mutex);
+      TFLiteRunner::Lease model = slot.runner.acquire();
+      if (preRoll > 0) resumeLocked(slot, model, preRoll, frames);
+      if (model.chunkFrames() > 0) {
+        // 流式模型：按块切分送入，单次送入超过滚动矩阵 (500ms) 也不会丢帧
+        const size_t chunkSamples = static_cast<size_t>(model.chunkFrames()) * kHopSamples;
+        for (size_t off = 0; off < frames; off += chunkSamples) {
+          const size_t n = std::min(chunkSamples, frames - off);
+          const int64_t melStart = nowNs();
+          melExtractor_.push(pcm + off, n);
+          recordSince(SG_STAGE_MEL, melStart);
+          analyzeStreamLocked(slot, model, position + off + n);
+        }
+        return true;
+      }
+
+      // 流式 Mel：只计算本次新增的 hop，跨回调保留上下文
+      const int64_t melStart = nowNs();
+      const int newFrames = melExtractor_.push(pcm, frames);
+      recordSince(SG_STAGE_MEL, melStart);
+      if (newFrames == 0) return true;
+
+      // 滑动窗口：每 stride 对最近 50 帧推理一次；积压期间跳过过期窗口
+      if (!scheduler_.shouldRun(melExtractor_.totalFrames(), backlog)) return true;
+
+      const int64_t inferStart = nowNs();
+      // 特征从滚动矩阵直接写入解释器输入张量 (int8 / uint8 模型在写入时量化)：无中间缓冲、无堆分配
+      const int tensorFrames = static_cast<int>(std::min<size_t>(kMaxFrames, model.inputInfo().size / kMelBins));
+      MelRows first, second;
+      const int rows = melExtractor_.latestRows(tensorFrames, &first, &second);
+      if (rows > 0) {
+          writeRows(model, first, second);
+          const bool ok = model.invoke();
+          recordSince(SG_STAGE_INFERENCE, inferStart);
+          if (!ok) inference_failures_.fetch_add(1, std::memory_order_relaxed);
+          // 相邻窗口重叠：只有上次推理之后的帧是新的；中间有缺口 (跳窗 / 失败) 时解码器重新起步
+          const uint64_t total = melExtractor_.totalFrames();
+          const uint64_t fresh = total - kws_mel_frame_;
+          if (fresh > static_cast<uint64_t>(rows)) kws_.reset();
+          if (ok) {
+            kws_mel_frame_ = total;
+            decideLocked(model.output(), position + frames, rows, static_cast<int>(std::min<uint64_t>(fresh, rows)));
+          }
+      }
+      return true;
+    }
+
+    /**
+     * VAD 门控：门关闭期间的块只进环形缓冲，不做 Mel 与推理 (返回 false)
+     * 重新开门时 *preRoll 为须先补送的历史样本数：环形缓冲中紧挨本块之前、且属于空档内的部分
+     */
+    bool gateLocked(const int16_t* pcm, size_t frames, size_t* preRoll) {
+      vad_samples_.fetch_add(frames, std::memory_order_relaxed);
+      if (!vad_.process(pcm, frames)) {
+        vad_gap_samples_ += frames;
+        vad_skipped_samples_.fetch_add(frames, std::memory_order_relaxed);
+        return false;
+      }
+      if (vad_gap_samples_ > 0) {
+        const size_t wanted = static_cast<size_t>(std::max(0, active_config_->vad.preRollMs)) * kSampleRate / 1000;
+        const size_t room = ring_.capacity() > frames ? ring_.capacity() - frames : 0;
+        *preRoll = static_cast<size_t>(std::min<uint64_t>({wanted, room, vad_gap_samples_}));
+        vad_gap_samples_ = 0;
+      }
+      return true;
+    }
+
+    /**
+     * 空档后续上：解码器与流式模型状态从头开始 (不把空档两侧的音素拼成一个关键词)，
+     * 再把空档末尾 preRoll 个样本补送进 Mel，开门前的起始辅音仍在窗口内
+     * 窗口模型的滚动矩阵前部为关门前的 hangover 尾部 (非语音)，与不门控时的内容相近
+     */
+    void resumeLocked(InferenceSlot& slot, TFLiteRunner::Lease& model, size_t preRoll, size_t frames) {
+      kws_.reset();
+      if (model.chunkFrames() > 0 && model.generation() == stream_generation_) {
+        model.resetState();
+        slot.streamOwner = id_;
+        slot.streamGeneration = model.generation();
+        stream_next_frame_ = melExtractor_.totalFrames();
+      }
+      PcmSpan spans[2];
+      const size_t covered = ring_.peekLast(preRoll + frames, &spans[0], &spans[1]);
+      size_t left = covered > frames ? std::min(preRoll, covered - frames) : 0;
+      const int64_t melStart = nowNs();
+      for (const PcmSpan& span : spans) {
+        const size_t n = std::min(left, span.frames);
+        if (n > 0) melExtractor_.push(span.data, n);
+        left -= n;
+      }
+      recordSince(SG_STAGE_MEL, melStart);
+      scheduler_.resume(melExtractor_.totalFrames());
+    }
+
+    /**
+     * 流式模型：按块送入尚未推理过的新帧，状态由模型跨调用携带；每块成本只随新音频增长
+     * 换模型 (新上下文状态为零) 时从滚动矩阵中最早的帧重新起步；积压超过矩阵则状态清零并跳过缺口
+     * 推理槽被其它会话用过时先恢复本会话保存的状态 (见 ensureStreamStateLocked)
+     */
+    void analyzeStreamLocked(InferenceSlot& slot, TFLiteRunner::Lease& model, uint64_t end) {
+      const int chunk = model.chunkFrames();
+      const uint64_t total = melExtractor_.totalFrames();
+      const uint64_t oldest = total - static_cast<uint64_t>(melExtractor_.availableFrames());
+      ensureStreamStateLocked(slot, model, oldest);
+      if (stream_next_frame_ < oldest) {
+        model.resetState();
+        stream_next_frame_ = oldest;
+        stream_resets_.fetch_add(1, std::memory_order_relaxed);
+        kws_.reset();
+      }
+
+      while (total - stream_next_frame_ >= static_cast<uint64_t>(chunk)) {
+        const int64_t inferStart = nowNs();
+        MelRows first, second;
+        if (melExtractor_.rowsAt(stream_next_frame_, chunk, &first, &second) == 0) break;
+        writeRows(model, first, second);
+        stream_next_frame_ += static_cast<uint64_t>(chunk);
+        stream_chunks_.fetch_add(1, std::memory_order_relaxed);
+        const bool ok = model.invoke();
+        recordSince(SG_STAGE_INFERENCE, inferStart);
+        if (!ok) {
+          inference_failures_.fetch_add(1, std::memory_order_relaxed);
+          break;
+        }
+        decideLocked(model.output(), end, chunk, chunk);
+      }
+      // 会话多于推理槽时槽会被轮流使用：每次用完保存状态，下次被别的会话用过后可原样恢复
+      if (engine_->slotsShared()) saveStreamStateLocked(model);
+    }
+
+    /**
+     * 使上下文中的流式状态属于本会话：本会话首次用到该上下文 (换模型 / 换槽) 时从最早的帧起步；
+     * 上下文此后被其它会话用过则恢复保存的副本，副本与进度不符时状态清零、重新起步
+     */
+    void ensureStreamStateLocked(InferenceSlot& slot, TFLiteRunner::Lease& model, uint64_t oldest) {
+      const uint64_t generation = model.generation();
+      const bool mine = slot.streamOwner == id_ && slot.streamGeneration == generation;
+      if (generation != stream_generation_) {
+        if (slot.streamGeneration == generation) model.resetState();  // 其它会话已用过这个上下文
+        stream_generation_ = generation;
+        stream_next_frame_ = oldest;
+        kws_.reset();
+      } else if (!mine) {
+        if (stream_state_generation_ == generation && stream_state_frame_ == stream_next_frame_ &&
+            model.loadState(stream_state_.data(), stream_state_.size())) {
+          stream_state_restores_.fetch_add(1, std::memory_order_relaxed);
+        } else {
+          model.resetState();
+          stream_next_frame_ = oldest;
+          stream_resets_.fetch_add(1, std::memory_order_relaxed);
+          kws_.reset();
+        }
+      }
+      slot.streamOwner = id_;
+      slot.streamGeneration = generation;
+    }
+
+    void saveStreamStateLocked(TFLiteRunner::Lease& model) {
+      stream_state_.resize(model.stateBytes());  // 只在首次 / 换模型时分配
+      if (!model.saveState(stream_state_.data(), stream_state_.size())) return;
+      stream_state_generation_ = model.generation();
+      stream_state_frame_ = stream_next_frame_;
+    }
+
+    static void writeRows(TFLiteRunner::Lease& model, const MelRows& first, const MelRows& second) {
+      model.writeInput(0, first.data, static_cast<size_t>(first.frames) * kMelBins);
+      if (second.frames > 0) {
+        model.writeInput(static_cast<size_t>(first.frames) * kMelBins, second.data,
+                         static_cast<size_t>(second.frames) * kMelBins);
+      }
+    }
+
+    /**
+     * 决策：end 为触发本次推理的送入块末端 (流内样本位置)；melFrames 为本次输出覆盖的 Mel 帧数，
+     * 其中末尾 newFrames 帧此前未解码过
+     * 配置了关键词且输出为 [帧 × 音素单元] 后验矩阵时走 KWS 解码，否则沿用风险和阈值规则
+     */
+    void decideLocked(ConstFloatSpan posteriors, uint64_t end, int melFrames, int newFrames) {
+      StageTimer decisionTimer(stage_[SG_STAGE_DECISION]);
+      // 输出视图在下一次 invoke 前有效
+      const KeywordGraph* graph = kws_.graph().get();
+      if (graph && graph->unitCount() > 0 && posteriors.size > 0 &&
+          posteriors.size % static_cast<size_t>(graph->unitCount()) == 0 && kws_.accepts(graph->unitCount())) {
+        searchKeywordsLocked(posteriors, end, melFrames, newFrames);
+        return;
+      }
+
+      float risk_score = 0.0f;
+      for (size_t i = 0; i < posteriors.size; ++i) risk_score += posteriors.data[i];
+      if (risk_score <= active_config_->globalSensitivity) return;
+
+      // 回溯掩蔽：窗口末端之前 D 的音频尚未送出，连同之后 200ms 一起处理
+      const uint64_t lookback = static_cast<uint64_t>(delay_line_.delayMs()) * kSampleRate / 1000;
+      interceptLocked(end > lookback ? end - lookback : 0, end + kInterceptTailSamples, end);
+    }
+
+    // KWS：只把输出末尾的新帧送入解码器；命中的起止帧按每帧样本数折算回流内位置并精确掩蔽
+    void searchKeywordsLocked(ConstFloatSpan posteriors, uint64_t end, int melFrames, int newFrames) {
+      const int units = kws_.graph()->unitCount();
+      const int frames = static_cast<int>(posteriors.size / static_cast<size_t>(units));
+      // 输出帧可能相对 Mel 帧下采样：按比例折算新帧数 (向上取整)
+      const int fresh = melFrames > 0 ? std::min(frames, (newFrames * frames + melFrames - 1) / melFrames) : frames;
+      if (fresh <= 0) return;
+      const uint64_t frameSamples =
+          std::max<uint64_t>(1, static_cast<uint64_t>(melFrames > 0 ? melFrames : frames) * kHopSamples / frames);
+
+      KeywordHit hits[kMaxKeywordHits];
+      const int found = kws_.advance(posteriors.data + static_cast<size_t>(frames - fresh) * units, fresh, hits,
+                                     kMaxKeywordHits);
+      kws_frames_.fetch_add(static_cast<uint64_t>(fresh), std::memory_order_relaxed);
+      kws_peak_tokens_.store(static_cast<uint32_t>(kws_.peakActiveTokens()), std::memory_order_relaxed);
+
+      const int64_t last = kws_.frameCount() - 1;  // 解码器的最后一帧对应 end
+      for (int i = 0; i < std::min(found, kMaxKeywordHits); ++i) {
+        const KeywordHit& hit = hits[i];
+        const uint64_t back = static_cast<uint64_t>(last - hit.startFrame + 1) * frameSamples;
+        const uint64_t tail = std::min(end, static_cast<uint64_t>(last - hit.endFrame) * frameSamples);
+        const uint64_t start = end > back ? end - back : 0;
+        kws_last_keyword_.store(hit.keywordId, std::memory_order_relaxed);
+        kws_last_score_.store(hit.score, std::memory_order_relaxed);
+        kws_last_start_.store(start, std::memory_order_relaxed);
+        kws_last_end_.store(end - tail, std::memory_order_relaxed);
+        kws_hits_.fetch_add(1, std::memory_order_release);
+        interceptLocked(start, end - tail + kInterceptTailSamples, end);
+      }
+    }
+
+    // 登记一次拦截：有延迟线时掩蔽 [maskStart, maskEnd)，否则 (或延迟线区间已满) 即时静音 200ms
+    // 区间为分析位置，折算为原生帧位置后交给延迟线 (折算只读前端的不可变参数)
+    void interceptLocked(uint64_t maskStart, uint64_t maskEnd, uint64_t end) {
+      last_decision_pos_.store(end, std::memory_order_relaxed);
+      intercept_decisions_.fetch_add(1, std::memory_order_release);
+      if (delay_line_.enabled() &&
+          delay_line_.scheduleMask(front_end_.toNativeFloor(maskStart), front_end_.toNativeCeil(maskEnd))) {
+        masks_scheduled_.fetch_add(1, std::memory_order_relaxed);
+      } else {
+        intercept_frames_remaining_.store(static_cast<int>(kInterceptTailSamples), std::memory_order_relaxed);
+        immediate_intercepts_.fetch_add(1, std::memory_order_relaxed);
+      }
+    }
+
+    void recordSince(int stage, int64_t startNs) {
+      stage_[stage].record(static_cast<uint64_t>(std::max<int64_t>(0, nowNs() - startNs)));
+    }
+
+    ProtectionEngine* const engine_;
+    const uint32_t id_;
+
+    std::mutex mutex_;
+    RingBuffer ring_;
+
+    // 分析侧 (持有 mutex_) 按代号换入的配置快照；初始为默认配置，首块即换入当前快照
+    std::shared_ptr<const EngineConfig> active_config_;
+    uint64_t active_generation_ = UINT64_MAX;
+    std::atomic<bool> test_intercept_enabled_{false};
+    std::atomic<int> test_frames_remaining_{0};
+
+    StreamingMelExtractor melExtractor_;
+    InferenceScheduler scheduler_;
+    std::atomic<int> intercept_frames_remaining_{0};
+    std::atomic<uint64_t> intercept_decisions_{0};
+    std::atomic<uint64_t> last_decision_pos_{0};
+    std::atomic<uint64_t> masks_scheduled_{0};
+    std::atomic<uint64_t> immediate_intercepts_{0};
+    std::atomic<uint64_t> inference_failures_{0};
+
+    // 流式模型进度 (分析侧，持有 mutex_)：下一块的起始 Mel 帧号与所属模型代号；
+    // stream_state_ 为推理槽共享时保存的状态副本 (对应 stream_state_frame_ 处的进度)
+    uint64_t stream_next_frame_ = 0;
+    uint64_t stream_generation_ = 0;
+    std::vector<uint8_t> stream_state_;
+    uint64_t stream_state_generation_ = 0;
+    uint64_t stream_state_frame_ = 0;
+    std::atomic<uint64_t> stream_chunks_{0};
+    std::atomic<uint64_t> stream_resets_{0};
+    std::atomic<uint64_t> stream_state_restores_{0};
+
+    // 关键词检索 (分析侧，持有 mutex_)：解码器与已解码到的 Mel 帧号；词表与图在配置快照中
+    KeywordDecoder kws_;
+    uint64_t kws_mel_frame_ = 0;
+    std::atomic<uint64_t> kws_frames_{0};
+    std::atomic<uint64_t> kws_hits_{0};
+    std::atomic<uint32_t> kws_peak_tokens_{0};
+    std::atomic<int32_t> kws_last_keyword_{-1};
+    std::atomic<float> kws_last_score_{0.0f};
+    std::atomic<uint64_t> kws_last_start_{0};
+    std::atomic<uint64_t> kws_last_end_{0};
+
+    // VAD 门 (分析侧，持有 mutex_)：阈值随配置快照换入；vad_gap_samples_ 为当前空档已跳过的样本
+    VoiceActivityDetector vad_;
+    uint64_t vad_gap_samples_ = 0;
+    std::atomic<uint64_t> vad_samples_{0};
+    std::atomic<uint64_t> vad_skipped_samples_{0};
+
+    // 各阶段延迟直方图 (SgEngineStage 索引)
+    LatencyHistogram stage_[SG_STAGE_COUNT];
+
+    // HAL 线程私有：采集前端 (滤波器历史) 与两个坐标系的累计位置——
+    // native_pos_ 为已送入的原生帧数 (延迟线)，analysis_pos_ 为产出的 16kHz 分析样本数
+    static constexpr size_t kLookaheadChunkFrames = 256;
+    CaptureFrontEnd front_end_;
+    uint64_t native_pos_ = 0;
+    uint64_t analysis_pos_ = 0;
+    std::vector<int16_t> analysis_pcm_;   // 前端输出暂存 (直通时为空)
+    std::vector<int16_t> lookahead_pcm_;  // float32 流过延迟线的暂存
+    DelayLine delay_line_;
+
+    // 异步分析：HAL 线程 → SPSC 队列 → 工作线程池
+    PcmQueue queue_;
+    std::atomic<uint64_t> enqueued_blocks_{0};
+    std::atomic<uint64_t> dropped_blocks_{0};
+    std::atomic<uint64_t> late_blocks_{0};
+
+    NoiseMasker masker_;
+  };
+
+ private:
+  ProtectionEngine()
+      : config_(std::make_shared<EngineConfig>()), sessions_(std::make_shared<SessionList>()) {
+    load_threads_.store(load_options_.numThreads, std::memory_order_relaxed);
+    default_session_ = openSession(kSampleRate, 1);
+    {
+      std::lock_guard<std::mutex> lock(governor_mutex_);
+      governor_config_ = config_;
+      configureGovernorLocked();
+    }
+    setAsyncAnalysis(true);
+  }
+
+  ~ProtectionEngine() { setAsyncAnalysis(false); }
+
+  static int64_t nowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+  }
+
+  int slotIndex(uint32_t sessionId) const {
+    return static_cast<int>((sessionId - 1) % static_cast<uint32_t>(workers_.load(std::memory_order_relaxed)));
+  }
+
+  InferenceSlot& slotFor(uint32_t sessionId) { return slots_[slotIndex(sessionId)]; }
+
+  // 会话多于推理槽：同一槽的流式上下文会被多个会话轮流使用
+  bool slotsShared() const {
+    return std::atomic_load(&sessions_)->size() > static_cast<size_t>(workers_.load(std::memory_order_relaxed));
+  }
+
+  bool loadingAny() const {
+    const int workers = workers_.load(std::memory_order_relaxed);
+    for (int i = 0; i < workers; ++i) {
+      if (slots_[i].runner.loading()) return true;
+    }
+    return false;
+  }
+
+  /**
+   * 调用方持有 model_mutex_；各槽只登记请求后立即返回，加载中的旧请求被取代 (不等待上一次加载)
+   * 调节器的工作点覆盖线程数，并可能以备用模型代替 path；model_path_ 始终记录主模型
+   */
+  void loadModelAsyncLocked(const char* path) {
+      if (!path) return;
+      model_path_ = path;
+      loadSlotsLocked(0, workers_.load(std::memory_order_relaxed));
+  }
+
+  // 每个推理槽各自构建解释器 (后台并行)；只有槽 0 回调打印
+  void loadSlotsLocked(int begin, int end) {
+      TFLiteLoadOptions options = load_options_;
+      if (model_threads_ > 0) options.numThreads = model_threads_;
+      const std::string& effective = model_fallback_.empty() ? model_path_ : model_fallback_;
+      for (int i = begin; i < end; ++i) {
+          slots_[i].runner.loadModelAsync(effective.c_str(), options, i == 0 ? &ProtectionEngine::onModelLoaded : nullptr,
+                                          this);
+      }
+  }
+
+  /**
+   * 模型目录下随模型部署的 conf_matrix.json：载入成功后按新的混淆变体重编关键词图
+   * 同目录的 conf_matrix.bin 不旧于 JSON 时直接 mmap；否则解析 JSON 并顺手写出 .bin 供下次启动
+   */
+  void loadSiblingConfMatrix(const char* path) {
+      if (!path) return;
+      const char* slash = strrchr(path, '/');
+      if (!slash) return;
+      const std::string dir(path, slash + 1);
+      const std::string jsonPath = dir + "conf_matrix.json";
+      const std::string binPath = dir + "conf_matrix.bin";
+      struct stat jsonStat, binStat;
+      const bool haveJson = stat(jsonPath.c_str(), &jsonStat) == 0;
+      const bool haveBin = stat(binPath.c_str(), &binStat) == 0;
+      bool loaded = false;
+      if (haveBin && (!haveJson || binStat.st_mtime >= jsonStat.st_mtime)) loaded = loadConfMatrix(binPath.c_str());
+      if (!loaded && haveJson) {
+          loaded = loadConfMatrix(jsonPath.c_str());
+          if (loaded) {
+              std::shared_ptr<const CompiledConfMatrix> conf = currentConfMatrix();
+              if (conf) conf->writeFile(binPath.c_str());  // 目录只读时忽略
+          }
+      }
+      if (loaded) rebuildKeywordGraph();
+  }
+
+  /** 混淆矩阵重载后：以当前配置重编关键词图并发布新快照 (调用线程编译，分析线程不受影响) */
+  void rebuildKeywordGraph() {
+      std::lock_guard<std::mutex> writer(config_mutex_);
+      auto next = std::make_shared<EngineConfig>(*std::atomic_load(&config_));
+      compileKeywordGraph(next.get());
+      publishConfigLocked(next);
+  }
+
+  // 按 cfg 的词表与单元表编译关键词图 (数千条约数毫秒)；调用方持有 config_mutex_
+  void compileKeywordGraph(EngineConfig* cfg) {
+      const int64_t start = nowNs();
+      cfg->graph.reset();
+      cfg->graphReport = KeywordGraphReport();
+      if (cfg->keywords->size() > 0) {
+          const PhonemeUnits units = cfg->phonemeUnits.empty() ? PhonemeUnits() : PhonemeUnits(cfg->phonemeUnits);
+          cfg->graph = KeywordGraph::compile(cfg->keywords->specs(), units, KeywordGraphOptions(), &cfg->graphReport);
+      }
+      if (cfg->graphReport.rejected > 0) {
+          printf("[SilenceGuard] %d keywords rejected (pinyin not in phoneme units)\n", cfg->graphReport.rejected);
+      }
+      config_compile_us_.store(static_cast<uint32_t>((nowNs() - start) / 1000), std::memory_order_relaxed);
+  }
+
+  /**
+   * 发布快照并递增代号；调用方持有 config_mutex_
+   * 被替换的快照暂存在 retired_configs_：分析线程换入新快照时不会在它那里释放大词表，
+   * 回收留给下一次发布 (只剩这里引用时)
+   */
+  void publishConfigLocked(std::shared_ptr<const EngineConfig> next) {
+      kws_keywords_.store(static_cast<uint32_t>(next->graphReport.keywords), std::memory_order_relaxed);
+      kws_graph_nodes_.store(static_cast<uint32_t>(next->graphReport.nodes), std::memory_order_relaxed);
+      retired_configs_.erase(std::remove_if(retired_configs_.begin(), retired_configs_.end(),
+                                            [](const std::shared_ptr<const EngineConfig>& c) {
+                                                return c.use_count() == 1;
+                                            }),
+                             retired_configs_.end());
+      retired_configs_.push_back(std::atomic_load(&config_));
+      std::atomic_store(&config_, std::move(next));
+      config_generation_.fetch_add(1, std::memory_order_release);
+      config_publishes_.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  /**
+   * 每个会话分析完一块后调用 (任意工作线程 / 同步模式的 HAL 线程)：喂给调节器并应用工作点
+   * 临界区只有几次加法；多会话时实时率按 "每个工作线程分摊的音频" 计：会话多于线程时样本数按比例折算
+   */
+  void recordAnalysis(size_t frames, bool analyzed, int64_t busyNs, int64_t lagNs) {
+    std::lock_guard<std::mutex> lock(governor_mutex_);
+    const uint64_t generation = config_generation_.load(std::memory_order_acquire);
+    if (generation != governor_generation_) {
+      governor_generation_ = generation;
+      std::shared_ptr<const EngineConfig> next = config();
+      const bool regovern = next->governor != governor_config_->governor ||
+                            next->inferenceStrideMs != governor_config_->inferenceStrideMs;
+      governor_config_ = std::move(next);
+      if (regovern) configureGovernorLocked();
+    }
+    if (load_threads_.load(std::memory_order_relaxed) != governor_base_threads_) configureGovernorLocked();
+    // 模型加载期间 (含调节器自己触发的重载) 的测量不代表任何工作点；门关闭的块不计入实时率
+    if (loadingAny()) {
+      governor_.restartInterval();
+    } else if (analyzed) {
+      const size_t workers = static_cast<size_t>(workers_.load(std::memory_order_relaxed));
+      const size_t sessions = std::atomic_load(&sessions_)->size();
+      const size_t share = frames * workers / std::max(workers, sessions);
+      if (governor_.record(share, busyNs, lagNs)) governor_pending_ = true;
+    }
+    if (governor_pending_) applyOperatingPointLocked();
+  }
+
+  // 按当前快照与加载选项的线程数重建调节器阶梯 (回到基准工作点)；调用方持有 governor_mutex_
+  void configureGovernorLocked() {
+      governor_base_threads_ = load_threads_.load(std::memory_order_relaxed);
+      governor_.configure(governor_config_->governor, governor_config_->inferenceStrideMs, governor_base_threads_);
+      governor_levels_.store(static_cast<uint32_t>(governor_.levels()), std::memory_order_relaxed);
+      governor_pending_ = true;
+  }
+
+  /**
+   * 应用调节器的工作点：步长经原子量由各会话下一块换入；线程数 / 备用模型须后台重载 ——
+   * 分析线程不等待：model_mutex_ 被占用或上一次加载未结束时保留 pending，下一块重试
+   */
+  void applyOperatingPointLocked() {
+      const OperatingPoint& point = governor_.current();
+      governor_stride_ms_.store(point.strideMs, std::memory_order_relaxed);
+      std::unique_lock<std::mutex> lock(model_mutex_, std::try_to_lock);
+      if (!lock.owns_lock() || loadingAny()) return;
+      governor_pending_ = false;
+      const std::string& fallback = point.fallback ? governor_config_->governor.fallbackModel : std::string();
+      if (point.threads == model_threads_ && fallback == model_fallback_) return;
+      model_threads_ = point.threads;
+      model_fallback_ = fallback;
+      governor_threads_.store(model_threads_, std::memory_order_relaxed);
+      governor_fallback_.store(!model_fallback_.empty(), std::memory_order_relaxed);
+      if (!model_path_.empty()) loadModelAsyncLocked(model_path_.c_str());
+  }
+
+  // 加载线程回调 (槽 0)：只打印；被更新请求取代的构建不回调
+  static void onModelLoaded(bool ok, const char* path, void* /*self*/) {
+      if (ok) {
+          printf("Model loaded from: %s\n", path);
+      } else {
+          printf("Model load failed, keeping previous model: %s\n", path);
+      }
+  }
+
+  // 作用域计时：析构时记入对应阶段直方图
+  class StageTimer {
+   public:
+    explicit StageTimer(LatencyHistogram& h) : h_(h), start_(nowNs()) {}
+    ~StageTimer() { h_.record(static_cast<uint64_t>(nowNs() - start_)); }
+    StageTimer(const StageTimer&) = delete;
+    StageTimer& operator=(const StageTimer&) = delete;
+
+   private:
+    LatencyHistogram& h_;
+    int64_t start_;
+  };
+
+  // 原子地 "若 > 0 则减一"，返回是否减成功
+  static bool consumeOne(std::atomic<int>& counter) {
+    int v = counter.load(std::memory_order_relaxed);
+    while (v > 0) {
+      if (counter.compare_exchange_weak(v, v - 1, std::memory_order_relaxed)) return true;
+    }
+    return false;
+  }
+
+  void startWorkersLocked() {
+    analysis_running_.store(true, std::memory_order_release);
+    const int workers = workers_.load(std::memory_order_relaxed);
+    for (int i = 0; i < workers; ++i) worker_threads_.emplace_back([this, i] { workerLoop(i); });
+  }
+
+  void stopWorkersLocked() {
+    analysis_running_.store(false, std::memory_order_release);
+    for (std::thread& t : worker_threads_) {
+      if (t.joinable()) t.join();
+    }
+    worker_threads_.clear();
+  }
+
+  /**
+   * 工作线程：轮询会话表，取到未被占用且有积压的会话就连续分析几块；各线程起点错开
+   * 停止时排空全部会话的队列后退出
+   */
+  void workerLoop(int index) {
+    size_t cursor = static_cast<size_t>(index);
+    for (;;) {
+      const bool running = analysis_running_.load(std::memory_order_acquire);
+      const std::shared_ptr<const SessionList> sessions = std::atomic_load(&sessions_);
+      const size_t n = sessions->size();
+      bool pending = false;
+      int done = 0;
+      for (size_t k = 0; k < n; ++k) {
+        Session& s = *(*sessions)[(cursor + k) % n];
+        if (!s.hasPending()) continue;
+        pending = true;
+        done += s.drain(kDrainBlocks);
+      }
+      ++cursor;
+      if (!running && !pending) break;
+      if (done == 0) std::this_thread::sleep_for(kIdlePoll);
+    }
+  }
+
+  std::mutex false_positive_mutex_;
   std::string last_false_positive_word_;
   int64_t last_false_positive_ts_ = 0;
-  float global_sensitivity_ = 0.85f;
-  int keyword_count_ = 0;
-  bool test_intercept_enabled_ = false;
-  int test_frames_remaining_ = 0;
-  
-  TFLiteRunner tfRunner_;
+
+  // 配置快照：写方 (updateConfig / 混淆矩阵重载) 由 config_mutex_ 串行化，原子指针发布；
+  // 各会话的分析侧按代号换入自己的 active_config_
+  std::mutex config_mutex_;
+  std::shared_ptr<const EngineConfig> config_;
+  std::vector<std::shared_ptr<const EngineConfig>> retired_configs_;
+  std::atomic<uint64_t> config_generation_{0};
+  std::atomic<uint64_t> config_publishes_{0};
+  std::atomic<uint64_t> config_rejected_{0};
+  std::atomic<uint32_t> config_parse_us_{0};
+  std::atomic<uint32_t> config_compile_us_{0};
+  std::atomic<uint32_t> kws_keywords_{0};
+  std::atomic<uint32_t> kws_graph_nodes_{0};
+
+  // 模型路径与加载选项；独立于会话 mutex_，加载请求不会阻塞分析线程
+  // (声明在 slots_ 之前：析构时各槽的 TFLiteRunner 先回收加载线程，其回调仍可安全访问)
+  std::mutex model_mutex_;
+  TFLiteLoadOptions load_options_;
+  std::string model_path_;
+  int model_threads_ = 0;        // 调节器工作点的线程数覆盖 (0 = 加载选项)
+  std::string model_fallback_;   // 调节器换用的备用模型；空 = 主模型
+  std::atomic<int> load_threads_{0};  // load_options_.numThreads 的副本，供调节器重建阶梯
+  std::atomic<int> workers_{1};
+  InferenceSlot slots_[kMaxWorkers];
   bool initialized_ = false;
-  size_t processed_samples_ = 0;
-  bool intercept_requested_ = false;
-  int intercept_frames_remaining_ = 0;
 
-  // 新增成员变量
-  NoiseMasker masker_;
+  // 算力调节器 (governor_mutex_)：汇总各会话的实时率 / 滞后并沿工作点阶梯升降；步长经原子量发布给各会话
+  std::mutex governor_mutex_;
+  ComputeGovernor governor_;
+  std::shared_ptr<const EngineConfig> governor_config_;
+  uint64_t governor_generation_ = 0;
+  int governor_base_threads_ = -1;
+  bool governor_pending_ = false;
+  std::atomic<uint32_t> governor_levels_{0};
+  std::atomic<int32_t> governor_stride_ms_{kDefaultInferenceStrideMs};
+  std::atomic<int32_t> governor_threads_{0};
+  std::atomic<bool> governor_fallback_{false};
+
+  // 会话表：写方 (open / close) 由 sessions_mutex_ 串行化，整表以原子指针发布；工作线程持快照遍历
+  std::mutex sessions_mutex_;
+  std::shared_ptr<const SessionList> sessions_;
+  uint32_t next_session_id_ = 1;
+  Session* default_session_ = nullptr;
+  std::atomic<uint64_t> sessions_opened_{0};
+
+  // 异步分析：各会话的 SPSC 队列 → 工作线程池
+  std::atomic<bool> async_analysis_{false};
+  std::atomic<bool> analysis_running_{false};
+  std::mutex thread_mutex_;
+  std::vector<std::thread> worker_threads_;
 };
 
 }  // namespace silenceguard
@@ -211,4 +1221,104 @@ void ProtectionEngine_loadModel(void* engine, const char* path) {
   static_cast<silenceguard::ProtectionEngine*>(engine)->loadModel(path);
 }
 
+void ProtectionEngine_loadModelWithOptions(void* engine, const char* path, int numThreads,
+                                           int useXnnpack, int warmupRuns) {
+  silenceguard::TFLiteLoadOptions options;
+  options.numThreads = numThreads;
+  options.useXnnpack = useXnnpack != 0;
+  options.warmupRuns = std::max(0, warmupRuns);
+  static_cast<silenceguard::ProtectionEngine*>(engine)->loadModel(path, options);
+}
+
+int ProtectionEngine_waitForModel(void* engine) {
+  return static_cast<silenceguard::ProtectionEngine*>(engine)->waitForModel() ? 1 : 0;
+}
+
+void ProtectionEngine_processLookahead(void* engine, int16_t* buffer, size_t frames) {
+  static_cast<silenceguard::ProtectionEngine*>(engine)->processLookahead(buffer, frames);
+}
+
+void ProtectionEngine_setAsyncAnalysis(void* engine, int enabled) {
+  static_cast<silenceguard::ProtectionEngine*>(engine)->setAsyncAnalysis(enabled != 0);
+}
+
+void ProtectionEngine_setWorkerCount(void* engine, int workers) {
+  static_cast<silenceguard::ProtectionEngine*>(engine)->setWorkerCount(workers);
+}
+
+void ProtectionEngine_getAnalysisCounters(void* engine, uint64_t* enqueued,
+                                          uint64_t* dropped, uint64_t* late) {
+  static_cast<silenceguard::ProtectionEngine*>(engine)->getAnalysisCounters(enqueued, dropped, late);
+}
+
+void ProtectionEngine_getSchedulerCounters(void* engine, uint64_t* windows, uint64_t* skipped) {
+  static_cast<silenceguard::ProtectionEngine*>(engine)->getSchedulerCounters(windows, skipped);
+}
+
+void ProtectionEngine_getInterceptCounters(void* engine, uint64_t* decisions, uint64_t* lastPosition) {
+  static_cast<silenceguard::ProtectionEngine*>(engine)->getInterceptCounters(decisions, lastPosition);
+}
+
+int ProtectionEngine_getStats(void* engine, SgEngineStats* out) {
+  if (!engine || !out) return 0;
+  static_cast<silenceguard::ProtectionEngine*>(engine)->getStats(out);
+  return 1;
+}
+
+void ProtectionEngine_resetStats(void* engine) {
+  static_cast<silenceguard::ProtectionEngine*>(engine)->resetStats();
+}
+
+// 会话接口：每路采集流一个句柄；引擎级的 push / lookahead / intercept / stats 作用于默认会话 (16kHz mono int16)
+// 会话的 buffer 均为原生格式的交错 PCM，长度以字节计
+
+void* ProtectionEngine_openSession(void* engine, int sampleRate, int channels) {
+  return static_cast<silenceguard::ProtectionEngine*>(engine)->openSession(sampleRate, channels);
+}
+
+/** format：0 = int16，1 = float32 */
+void* ProtectionEngine_openSessionWithFormat(void* engine, int sampleRate, int channels, int format) {
+  return static_cast<silenceguard::ProtectionEngine*>(engine)->openSession(sampleRate, channels, format);
+}
+
+void ProtectionEngine_closeSession(void* engine, void* session) {
+  static_cast<silenceguard::ProtectionEngine*>(engine)->closeSession(
+      static_cast<silenceguard::ProtectionEngine::Session*>(session));
+}
+
+void* ProtectionEngine_getDefaultSession(void* engine) {
+  return static_cast<silenceguard::ProtectionEngine*>(engine)->defaultSession();
+}
+
+void ProtectionEngine_sessionPushToBuffer(void* session, const void* buffer, size_t bytes) {
+  static_cast<silenceguard::ProtectionEngine::Session*>(session)->pushToBuffer(buffer, bytes);
+}
+
+void ProtectionEngine_sessionProcessLookahead(void* session, void* buffer, size_t bytes) {
+  static_cast<silenceguard::ProtectionEngine::Session*>(session)->processLookahead(buffer, bytes);
+}
+
+int ProtectionEngine_sessionShouldIntercept(void* session) {
+  return static_cast<silenceguard::ProtectionEngine::Session*>(session)->shouldIntercept() ? 1 : 0;
+}
+
+void ProtectionEngine_sessionApplyBeep(void* session, void* buffer, size_t bytes) {
+  static_cast<silenceguard::ProtectionEngine::Session*>(session)->applyBeep(buffer, bytes);
+}
+
+void ProtectionEngine_sessionSetToneSampleRate(void* session, int sampleRate) {
+  static_cast<silenceguard::ProtectionEngine::Session*>(session)->setToneSampleRate(sampleRate);
+}
+
+void ProtectionEngine_getSessionInterceptCounters(void* session, uint64_t* decisions, uint64_t* lastPosition) {
+  static_cast<silenceguard::ProtectionEngine::Session*>(session)->getInterceptCounters(decisions, lastPosition);
+}
+
+int ProtectionEngine_getSessionStats(void* engine, void* session, SgEngineStats* out) {
+  if (!engine || !session || !out) return 0;
+  static_cast<silenceguard::ProtectionEngine*>(engine)->getStats(
+      static_cast<const silenceguard::ProtectionEngine::Session*>(session), out);
+  return 1;
+}
+
 }  // extern "C"
@@ -0,0 +1,341 @@
+#include "EngineConfig.h"
+#include "InferenceScheduler.h"
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <unordered_map>
+#include <utility>
+
+namespace silenceguard {
+
+namespace {
+
+constexpr int kMaxJsonDepth = 32;
+
+// 最小 JSON 文档树：载荷只在配置线程解析一次，之后只读取需要的键
+struct JsonValue {
+  enum Type { kNull, kBool, kNumber, kString, kArray, kObject };
+  Type type = kNull;
+  bool boolean = false;
+  double number = 0.0;
+  std::string str;
+  std::vector<JsonValue> items;
+  std::vector<std::pair<std::string, JsonValue>> members;
+
+  const JsonValue* get(const char* key) const {
+    if (type != kObject) return nullptr;
+    for (const auto& m : members)
+      if (m.first == key) return &m.second;
+    return nullptr;
+  }
+};
+
+class JsonParser {
+ public:
+  explicit JsonParser(const char* text) : p_(text) {}
+
+  bool parseDocument(JsonValue* out) {
+    if (!value(out, 0)) return false;
+    skipSpace();
+    return *p_ == '\0';
+  }
+
+ private:
+  void skipSpace() {
+    while (*p_ == ' ' || *p_ == '\t' || *p_ == '\n' || *p_ == '\r') ++p_;
+  }
+
+  bool literal(const char* word) {
+    const size_t n = strlen(word);
+    if (strncmp(p_, word, n) != 0) return false;
+    p_ += n;
+    return true;
+  }
+
+  bool value(JsonValue* out, int depth) {
+    if (depth > kMaxJsonDepth) return false;
+    skipSpace();
+    switch (*p_) {
+      case '{': return object(out, depth);
+      case '[': return array(out, depth);
+      case '"': out->type = JsonValue::kString; return string(&out->str);
+      case 't': out->type = JsonValue::kBool; out->boolean = true; return literal("true");
+      case 'f': out->type = JsonValue::kBool; out->boolean = false; return literal("false");
+      case 'n': out->type = JsonValue::kNull; return literal("null");
+      default: return number(out);
+    }
+  }
+
+  bool object(JsonValue* out, int depth) {
+    out->type = JsonValue::kObject;
+    ++p_;
+    skipSpace();
+    if (*p_ == '}') {
+      ++p_;
+      return true;
+    }
+    while (true) {
+      skipSpace();
+      std::pair<std::string, JsonValue> member;
+      if (*p_ != '"' || !string(&member.first)) return false;
+      skipSpace();
+      if (*p_++ != ':') return false;
+      if (!value(&member.second, depth + 1)) return false;
+      out->members.push_back(std::move(member));
+      skipSpace();
+      if (*p_ == ',') {
+        ++p_;
+      } else if (*p_ == '}') {
+        ++p_;
+        return true;
+      } else {
+        return false;
+      }
+    }
+  }
+
+  bool array(JsonValue* out, int depth) {
+    out->type = JsonValue::kArray;
+    ++p_;
+    skipSpace();
+    if (*p_ == ']') {
+      ++p_;
+      return true;
+    }
+    while (true) {
+      out->items.emplace_back();
+      if (!value(&out->items.back(), depth + 1)) return false;
+      skipSpace();
+      if (*p_ == ',') {
+        ++p_;
+      } else if (*p_ == ']') {
+        ++p_;
+        return true;
+      } else {
+        return false;
+      }
+    }
+  }
+
+  bool number(JsonValue* out) {
+    if (*p_ != '-' && (*p_ < '0' || *p_ > '9')) return false;
+    char* end = nullptr;
+    out->type = JsonValue::kNumber;
+    out->number = strtod(p_, &end);
+    if (end == p_) return false;
+    p_ = end;
+    return true;
+  }
+
+  static int hex(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+  }
+
+  bool string(std::string* out) {
+    ++p_;  // 开引号
+    out->clear();
+    while (*p_ && *p_ != '"') {
+      if (*p_ != '\\') {
+        out->push_back(*p_++);
+        continue;
+      }
+      ++p_;
+      switch (*p_) {
+        case '"': case '\\': case '/': out->push_back(*p_); break;
+        case 'b': out->push_back('\b'); break;
+        case 'f': out->push_back('\f'); break;
+        case 'n': out->push_back('\n'); break;
+        case 'r': out->push_back('\r'); break;
+        case 't': out->push_back('\t'); break;
+        case 'u': {
+          unsigned cp = 0;
+          for (int k = 1; k <= 4; ++k) {
+            const int h = hex(p_[k]);
+            if (h < 0) return false;
+            cp = (cp << 4) | static_cast<unsigned>(h);
+          }
+          p_ += 4;
+          // BMP 内编码为 UTF-8 (拼音 ü 等)；代理对按两个码元各自编码
+          if (cp < 0x80) {
+            out->push_back(static_cast<char>(cp));
+          } else if (cp < 0x800) {
+            out->push_back(static_cast<char>(0xC0 | (cp >> 6)));
+            out->push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+          } else {
+            out->push_back(static_cast<char>(0xE0 | (cp >> 12)));
+            out->push_back(static_cast<char>(0x80 | ((cp >> 6) & 0x3F)));
+            out->push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+          }
+          break;
+        }
+        default: return false;
+      }
+      ++p_;
+    }
+    if (*p_ != '"') return false;
+    ++p_;
+    return true;
+  }
+
+  const char* p_;
+};
+
+// 数值键：兼容旧解析器接受的 "0.8" 字符串写法与 true / false；不可解析返回 false
+bool readNumber(const JsonValue* v, double* out) {
+  if (!v) return false;
+  if (v->type == JsonValue::kNumber) {
+    *out = v->number;
+    return true;
+  }
+  if (v->type == JsonValue::kBool) {
+    *out = v->boolean ? 1.0 : 0.0;
+    return true;
+  }
+  if (v->type == JsonValue::kString && !v->str.empty()) {
+    char* end = nullptr;
+    const double d = strtod(v->str.c_str(), &end);
+    if (end && *end == '\0') {
+      *out = d;
+      return true;
+    }
+  }
+  return false;
+}
+
+double numberOf(const JsonValue* v, double defaultVal) {
+  double d = defaultVal;
+  return readNumber(v, &d) ? d : defaultVal;
+}
+
+// 布尔键：true / false / 1 / 0 (含字符串形式)；缺省返回 -1
+int flagOf(const JsonValue* v) {
+  if (!v) return -1;
+  if (v->type == JsonValue::kBool) return v->boolean ? 1 : 0;
+  if (v->type == JsonValue::kNumber) return v->number != 0.0 ? 1 : 0;
+  if (v->type == JsonValue::kString) {
+    if (v->str == "true" || v->str == "1") return 1;
+    if (v->str == "false" || v->str == "0") return 0;
+  }
+  return -1;
+}
+
+void stringsOf(const JsonValue* v, std::vector<std::string>* out) {
+  out->clear();
+  if (!v || v->type != JsonValue::kArray) return;
+  for (const JsonValue& item : v->items)
+    if (item.type == JsonValue::kString) out->push_back(item.str);
+}
+
+}  // namespace
+
+// ---------------------------------------------------------
+// KeywordSet
+// ---------------------------------------------------------
+
+KeywordSet::KeywordSet(std::vector<KeywordSpec> specs) : specs_(std::move(specs)) {
+  std::unordered_map<std::string, int32_t> interned;
+  start_.reserve(specs_.size() + 1);
+  start_.push_back(0);
+  for (const KeywordSpec& spec : specs_) {
+    for (const std::string& syl : spec.pinyin) {
+      auto it = interned.emplace(syl, static_cast<int32_t>(syllables_.size()));
+      if (it.second) syllables_.push_back(syl);
+      ids_.push_back(it.first->second);
+    }
+    start_.push_back(static_cast<int32_t>(ids_.size()));
+  }
+}
+
+// ---------------------------------------------------------
+// EngineConfig
+// ---------------------------------------------------------
+
+EngineConfig::EngineConfig()
+    : keywords(std::make_shared<KeywordSet>(std::vector<KeywordSpec>())),
+      inferenceStrideMs(kDefaultInferenceStrideMs) {}
+
+bool parseEngineConfig(const char* json, EngineConfig* out) {
+  if (!json || !out) return false;
+  JsonValue root;
+  if (!JsonParser(json).parseDocument(&root) || root.type != JsonValue::kObject) return false;
+
+  EngineConfig cfg;
+  cfg.globalSensitivity = static_cast<float>(numberOf(root.get("global_sensitivity"), cfg.globalSensitivity));
+
+  // "keywords":[{"pinyin":["ni","hao"],"threshold":0.85,...},...]：非对象项保留为空词条，id 与下标对齐
+  std::vector<KeywordSpec> specs;
+  const JsonValue* keywords = root.get("keywords");
+  if (keywords && keywords->type == JsonValue::kArray) {
+    specs.reserve(keywords->items.size());
+    for (const JsonValue& item : keywords->items) {
+      KeywordSpec spec;
+      spec.threshold = static_cast<float>(numberOf(item.get("threshold"), cfg.globalSensitivity));
+      stringsOf(item.get("pinyin"), &spec.pinyin);
+      specs.push_back(std::move(spec));
+    }
+  }
+  cfg.keywords = std::make_shared<KeywordSet>(std::move(specs));
+  stringsOf(root.get("phoneme_units"), &cfg.phonemeUnits);
+
+  cfg.kws.beam = std::max(0.0f, static_cast<float>(numberOf(root.get("kws_beam"), cfg.kws.beam)));
+  cfg.kws.maxActive = std::max(1, static_cast<int>(numberOf(root.get("kws_max_active"), cfg.kws.maxActive)));
+
+  const JsonValue* masking = root.get("masking");
+  auto maskingKey = [&](const char* key) {
+    const JsonValue* v = masking ? masking->get(key) : nullptr;
+    return v ? v : root.get(key);
+  };
+  cfg.masking.attackMs = static_cast<float>(numberOf(maskingKey("attack"), cfg.masking.attackMs));
+  cfg.masking.releaseMs = static_cast<float>(numberOf(maskingKey("release"), cfg.masking.releaseMs));
+  cfg.masking.lookaheadMs = static_cast<int>(numberOf(maskingKey("lookahead_ms"), cfg.masking.lookaheadMs));
+  cfg.inferenceStrideMs = static_cast<int>(numberOf(root.get("inference_stride_ms"), cfg.inferenceStrideMs));
+
+  // "vad": {"enabled": true, "energy_db": -55, ...}；"vad": false 为整体开关
+  const JsonValue* vad = root.get("vad");
+  if (vad && vad->type == JsonValue::kObject) {
+    const int enabled = flagOf(vad->get("enabled"));
+    if (enabled >= 0) cfg.vad.enabled = enabled != 0;
+    cfg.vad.energyDb = static_cast<float>(numberOf(vad->get("energy_db"), cfg.vad.energyDb));
+    cfg.vad.marginDb = std::max(0.0f, static_cast<float>(numberOf(vad->get("margin_db"), cfg.vad.marginDb)));
+    cfg.vad.zcrMin = static_cast<float>(numberOf(vad->get("zcr_min"), cfg.vad.zcrMin));
+    cfg.vad.zcrMax = static_cast<float>(numberOf(vad->get("zcr_max"), cfg.vad.zcrMax));
+    cfg.vad.flatnessMax = static_cast<float>(numberOf(vad->get("flatness_max"), cfg.vad.flatnessMax));
+    cfg.vad.hangoverMs = std::max(0, static_cast<int>(numberOf(vad->get("hangover_ms"), cfg.vad.hangoverMs)));
+    cfg.vad.preRollMs = std::max(0, static_cast<int>(numberOf(vad->get("preroll_ms"), cfg.vad.preRollMs)));
+  } else if (flagOf(vad) >= 0) {
+    cfg.vad.enabled = flagOf(vad) != 0;
+  }
+
+  // "governor": {"target_rtf": 0.5, "max_stride_ms": 320, "max_threads": 4, "fallback_model": "...", ...}
+  const JsonValue* governor = root.get("governor");
+  if (governor && governor->type == JsonValue::kObject) {
+    GovernorOptions& g = cfg.governor;
+    const int enabled = flagOf(governor->get("enabled"));
+    if (enabled >= 0) g.enabled = enabled != 0;
+    g.targetRtf = std::max(0.01f, static_cast<float>(numberOf(governor->get("target_rtf"), g.targetRtf)));
+    g.targetLatencyMs =
+        std::max(1, static_cast<int>(numberOf(governor->get("target_latency_ms"), g.targetLatencyMs)));
+    g.minStrideMs = static_cast<int>(numberOf(governor->get("min_stride_ms"), g.minStrideMs));
+    g.maxStrideMs = static_cast<int>(numberOf(governor->get("max_stride_ms"), g.maxStrideMs));
+    g.maxThreads = std::max(0, static_cast<int>(numberOf(governor->get("max_threads"), g.maxThreads)));
+    const JsonValue* fallback = governor->get("fallback_model");
+    if (fallback && fallback->type == JsonValue::kString) g.fallbackModel = fallback->str;
+    g.intervalMs = std::max(100, static_cast<int>(numberOf(governor->get("interval_ms"), g.intervalMs)));
+  } else if (flagOf(governor) >= 0) {
+    cfg.governor.enabled = flagOf(governor) != 0;
+  }
+
+  double v = 0.0;
+  cfg.hasTfliteThreads = readNumber(root.get("tflite_threads"), &v);
+  if (cfg.hasTfliteThreads) cfg.tfliteThreads = static_cast<int>(v);
+  cfg.tfliteXnnpack = flagOf(root.get("tflite_xnnpack"));
+  if (readNumber(root.get("tflite_warmup"), &v)) cfg.tfliteWarmup = std::max(0, static_cast<int>(v));
+
+  *out = std::move(cfg);
+  return true;
+}
+
+}  // namespace silenceguard
@@ -0,0 +1,79 @@
+// SilenceGuard Pro — UPDATE_CONFIG 载荷解析与不可变配置快照
+// 载荷整体解析为 EngineConfig (含关键词表 KeywordSet 与编译后的关键词图)，在调用线程构建完成后
+// 以原子指针交换发布；分析线程每块只比较一次代号，热路径不持锁读配置
+
+#ifndef SILENCEGUARD_ENGINECONFIG_H
+#define SILENCEGUARD_ENGINECONFIG_H
+
+#include "ComputeGovernor.h"
+#include "feature_extraction/VoiceActivityDetector.h"
+#include "inference/KeywordDecoder.h"
+#include "inference/KeywordGraph.h"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace silenceguard {
+
+/** 掩蔽参数："masking": {"attack", "release"} (也接受顶层同名键) 与前视延迟 lookahead_ms */
+struct MaskingParams {
+  float attackMs = 10.0f;
+  float releaseMs = 50.0f;
+  int lookaheadMs = 0;
+};
+
+/**
+ * 不可变关键词表：关键词 id 即 UPDATE_CONFIG 中的数组下标
+ * 拼音音节驻留为稠密 id，每个关键词的音节 id 以 CSR (syllableStart / syllableIds) 存放
+ */
+class KeywordSet {
+ public:
+  explicit KeywordSet(std::vector<KeywordSpec> specs);
+
+  int size() const { return static_cast<int>(specs_.size()); }
+  const std::vector<KeywordSpec>& specs() const { return specs_; }
+  float threshold(int keyword) const { return specs_[keyword].threshold; }
+
+  int syllableCount() const { return static_cast<int>(syllables_.size()); }
+  const std::string& syllable(int id) const { return syllables_[id]; }
+  const int32_t* syllablesBegin(int keyword) const { return ids_.data() + start_[keyword]; }
+  const int32_t* syllablesEnd(int keyword) const { return ids_.data() + start_[keyword + 1]; }
+
+ private:
+  std::vector<KeywordSpec> specs_;
+  std::vector<std::string> syllables_;  // id → 音节
+  std::vector<int32_t> start_;          // [size + 1]
+  std::vector<int32_t> ids_;
+};
+
+/** 一次 UPDATE_CONFIG 的完整结果；发布后只读。缺省的键取默认值 (每次推送都是完整配置) */
+struct EngineConfig {
+  float globalSensitivity = 0.85f;  // 风险和阈值，也是关键词缺省阈值
+  std::shared_ptr<const KeywordSet> keywords;  // 非空
+  std::vector<std::string> phonemeUnits;        // 空 = 默认声母 / 韵母表
+  KeywordDecoderOptions kws;
+  MaskingParams masking;
+  VadOptions vad;
+  GovernorOptions governor;
+  int inferenceStrideMs;
+  // TFLite 执行选项：载荷未给出的项沿用当前加载选项
+  bool hasTfliteThreads = false;
+  int tfliteThreads = -1;
+  int tfliteXnnpack = -1;  // -1 未给出，否则 0 / 1
+  int tfliteWarmup = -1;   // -1 未给出
+
+  // 由引擎在发布前填入：按 keywords / phonemeUnits 与当前混淆矩阵编译的图 (无关键词时为空)
+  std::shared_ptr<const KeywordGraph> graph;
+  KeywordGraphReport graphReport;
+
+  EngineConfig();
+};
+
+/** 解析 UPDATE_CONFIG；JSON 不合法返回 false (out 不可用)，未知键忽略 */
+bool parseEngineConfig(const char* json, EngineConfig* out);
+
+}  // namespace silenceguard
+
+#endif  // SILENCEGUARD_ENGINECONFIG_H
@@ -0,0 +1,123 @@
+/*
+ * SilenceGuard Pro — 引擎统计快照 (C 兼容 POD，供 hook / JNI / host 工具读取)
+ * ProtectionEngine_getStats(engine, &stats) 填充默认会话，ProtectionEngine_getSessionStats 填充指定会话；
+ * 流相关的阶段延迟与计数器按会话统计，模型 / 配置 / 调节器为引擎级；各阶段延迟来自无锁 HDR 风格直方图
+ */
+
+#ifndef SILENCEGUARD_ENGINESTATS_H
+#define SILENCEGUARD_ENGINESTATS_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define SG_ENGINE_STATS_VERSION 11
+
+/* 热路径阶段 */
+enum SgEngineStage {
+  SG_STAGE_PUSH = 0,      /* HAL 线程 pushToBuffer 整体 (含下混 / 重采样) */
+  SG_STAGE_QUEUE_WAIT,    /* 入队 → 分析线程取出 */
+  SG_STAGE_LOCK_WAIT,     /* 分析侧等待会话 mutex */
+  SG_STAGE_MEL,           /* 流式 Mel 提取 (每次送入) */
+  SG_STAGE_INFERENCE,     /* 特征写入 + invoke (每个调度窗口 / 每个流式块) */
+  SG_STAGE_DECISION,      /* 风险汇总或关键词解码 + 拦截 / 掩蔽登记 */
+  SG_STAGE_LOOKAHEAD,     /* HAL 线程延迟线 + 掩蔽 */
+  SG_STAGE_COUNT
+};
+
+typedef struct SgStageStats {
+  uint64_t count;
+  uint64_t sum_ns;
+  uint64_t p50_ns;
+  uint64_t p90_ns;
+  uint64_t p99_ns;
+  uint64_t max_ns;
+} SgStageStats;
+
+typedef struct SgEngineStats {
+  uint32_t version;                      /* SG_ENGINE_STATS_VERSION */
+  uint32_t stage_count;                  /* SG_STAGE_COUNT */
+  SgStageStats stages[SG_STAGE_COUNT];
+  uint64_t intercept_decisions;          /* 风险超过阈值的次数 */
+  uint64_t masks_scheduled;              /* 登记到延迟线的回溯掩蔽 */
+  uint64_t immediate_intercepts;         /* 无延迟线时的即时拦截 */
+  uint64_t late_masks;                   /* 起点已送出、只能部分掩蔽的区间 */
+  uint64_t inference_failures;
+  uint64_t blocks_enqueued;
+  uint64_t blocks_dropped;
+  uint64_t blocks_late;
+  uint64_t windows_scheduled;
+  uint64_t windows_skipped;              /* 分析积压期间到期、或被同一次送入中更新的窗口取代的窗口 */
+  /* v2：最近一次模型加载 (TFLiteLoadOptions / TFLiteLoadTimings) */
+  uint32_t model_load_us;
+  uint32_t model_warmup_us;
+  uint32_t model_first_inference_us;   /* 0 = 尚未推理 */
+  int32_t model_threads;               /* <= 0 为 TFLite 默认 */
+  uint32_t model_xnnpack;              /* XNNPACK delegate 是否生效 */
+  /* v3：模型输入 / 输出张量类型 (0 = float32, 1 = int8, 2 = uint8) */
+  uint32_t model_input_type;
+  uint32_t model_output_type;
+  /* v4：流式模型 (每次只送入新帧，状态跨调用携带) */
+  int32_t model_chunk_frames;          /* 每块新帧数；0 = 窗口模型 */
+  int32_t model_state_tensors;         /* 状态张量对数 */
+  uint64_t stream_chunks;              /* 已推理的块数 */
+  uint64_t stream_resets;              /* 积压超过滚动矩阵导致的状态清零 */
+  /* v5：关键词检索 (KWS)；位置为流内样本号 */
+  uint32_t kws_keywords;               /* 已编译进关键词图的关键词数 */
+  uint32_t kws_graph_nodes;
+  uint64_t kws_frames;                 /* 已解码的后验帧数 */
+  uint64_t kws_hits;
+  uint32_t kws_peak_tokens;            /* 单帧活跃令牌峰值 */
+  int32_t kws_last_keyword;            /* 最近一次命中的关键词 id；-1 = 尚无 */
+  uint64_t kws_last_start;
+  uint64_t kws_last_end;
+  float kws_last_score;                /* 置信度 0–1 */
+  /* v6：UPDATE_CONFIG 快照 (在调用线程解析 + 编译后原子发布) */
+  uint64_t config_publishes;           /* 已发布的配置快照 (含混淆矩阵重载引起的重编) */
+  uint64_t config_rejected;            /* JSON 不合法而整包丢弃的推送 */
+  uint32_t config_parse_us;            /* 最近一次解析耗时 */
+  uint32_t config_compile_us;          /* 最近一次关键词图编译耗时 (词表未变时为 0) */
+
+  /* v7: VAD 门控 (门关闭的块跳过 Mel 与推理；跳过率 = vad_skipped_samples / vad_samples) */
+  uint64_t vad_samples;                /* 经过 VAD 门的样本 */
+  uint64_t vad_skipped_samples;        /* 其中门关闭、未做 Mel / 推理的样本 */
+  uint64_t vad_hops;                   /* 已判决的 10ms hop */
+  uint64_t vad_speech_hops;            /* 其中判为语音的 hop */
+  uint64_t vad_openings;               /* 开门次数 (每次开门补送 preroll) */
+
+  /* v8: 算力调节器 (工作点阶梯：步长 → 线程数 → 备用模型；level 0 为算力最多的一级) */
+  uint64_t gov_transitions;            /* 工作点切换次数 */
+  uint64_t gov_overloads;              /* 超出实时预算的评估区间 */
+  float gov_rtf;                       /* 最近一个区间的实时率 (分析耗时 / 音频时长) */
+  uint32_t gov_lag_ms;                 /* 最近一个区间的最大排队滞后 */
+  uint32_t gov_level;                  /* 当前工作点 */
+  uint32_t gov_levels;                 /* 阶梯级数；1 = 未启用 */
+  int32_t gov_stride_ms;               /* 当前推理步长 */
+  int32_t gov_threads;                 /* 线程数覆盖；0 = 加载选项 */
+  uint32_t gov_fallback;               /* 1 = 正在使用备用模型 */
+
+  /* v9: 多会话 (每路采集流独立状态，共享推理工作线程池) */
+  uint32_t session_id;                 /* 本快照所属会话；1 = 默认会话 */
+  uint32_t sessions_open;              /* 当前打开的会话数 (含默认会话) */
+  uint64_t sessions_opened;            /* 累计打开的会话数 */
+  uint32_t pool_workers;               /* 工作线程数 = 推理槽 (解释器) 数 */
+  uint32_t session_slot;               /* 本会话绑定的推理槽 */
+  uint64_t stream_state_restores;      /* 推理槽被其它会话用过后恢复本会话流式状态的次数 */
+
+  /* v10: 采集前端 (原生格式 → 16kHz mono 分析；掩蔽按原生格式) */
+  uint32_t capture_sample_rate;        /* 会话的原生采样率 */
+  uint32_t capture_channels;           /* 原生声道数 */
+  uint32_t capture_format;             /* 0 = int16，1 = float32 */
+  uint32_t resampler_taps;             /* 多相滤波每个输出的点积长度；0 = 16kHz 无需重采样 */
+
+  /* v11: 延迟线丢弃的掩蔽区间 (登记失败的拦截改为即时拦截，计入 immediate_intercepts) */
+  uint64_t dropped_masks;
+} SgEngineStats;
+
+#ifdef __cplusplus
+}  /* extern "C" */
+#endif
+
+#endif  /* SILENCEGUARD_ENGINESTATS_H */
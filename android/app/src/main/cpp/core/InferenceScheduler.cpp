@@ -0,0 +1,54 @@
+#include "InferenceScheduler.h"
+#include "feature_extraction/MelSpectrogram.h"
+#include <algorithm>
+
+namespace silenceguard {
+
+InferenceScheduler::InferenceScheduler(int strideMs)
+    : strideFrames_(1), nextDueFrame_(kMaxFrames) {
+  setStrideMs(strideMs);
+}
+
+void InferenceScheduler::setStrideMs(int strideMs) {
+  strideMs = std::max(kMinInferenceStrideMs, std::min(kMaxInferenceStrideMs, strideMs));
+  strideFrames_.store(std::max(1, (strideMs + kHopMs / 2) / kHopMs), std::memory_order_relaxed);
+}
+
+int InferenceScheduler::strideMs() const {
+  return strideFrames_.load(std::memory_order_relaxed) * kHopMs;
+}
+
+bool InferenceScheduler::shouldRun(uint64_t totalMelFrames, bool backlog) {
+  const uint64_t stride = static_cast<uint64_t>(strideFrames_.load(std::memory_order_relaxed));
+  if (totalMelFrames >= nextDueFrame_) {
+    // 本次跨过的到期窗口数 (第一个窗口须凑满 kMaxFrames 帧，nextDueFrame_ 初值即为 kMaxFrames)
+    const uint64_t due = (totalMelFrames - nextDueFrame_) / stride + 1;
+    if (backlog) {
+      // 积压中：这些窗口的音频已过时，不推理
+      skipped_.fetch_add(due, std::memory_order_relaxed);
+      nextDueFrame_ += due * stride;
+      deferred_ = true;
+      return false;
+    }
+    // 一次送入跨过的中间窗口直接丢弃，只保留最新一个
+    if (due > 1) skipped_.fetch_add(due - 1, std::memory_order_relaxed);
+  } else if (backlog || !deferred_) {
+    return false;
+  }
+  deferred_ = false;
+  nextDueFrame_ = totalMelFrames + stride;
+  scheduled_.fetch_add(1, std::memory_order_relaxed);
+  return true;
+}
+
+void InferenceScheduler::reset() {
+  nextDueFrame_ = kMaxFrames;
+  deferred_ = false;
+}
+
+void InferenceScheduler::resume(uint64_t totalMelFrames) {
+  nextDueFrame_ = std::max<uint64_t>(totalMelFrames, kMaxFrames);
+  deferred_ = false;
+}
+
+}  // namespace silenceguard
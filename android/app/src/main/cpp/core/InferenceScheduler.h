@@ -0,0 +1,54 @@
+// SilenceGuard Pro — 滑动窗口推理调度器
+// 以可配置步长 (如 100/160/250ms) 对重叠的 50 帧 Mel 窗口触发推理；
+// 上一次推理期间分析队列又积压了新块、或一次送入的帧跨过多个步长时跳过过期窗口，只推理最新窗口：
+// 积压期间照常计算 Mel，但不推理，追上队列后立即对最新窗口推理一次 (以算力换延迟)
+
+#ifndef SILENCEGUARD_INFERENCESCHEDULER_H
+#define SILENCEGUARD_INFERENCESCHEDULER_H
+
+#include <atomic>
+#include <cstdint>
+
+namespace silenceguard {
+
+constexpr int kDefaultInferenceStrideMs = 160;
+constexpr int kMinInferenceStrideMs = 10;   // 一个 hop
+constexpr int kMaxInferenceStrideMs = 500;  // 一个完整窗口
+
+class InferenceScheduler {
+ public:
+  explicit InferenceScheduler(int strideMs = kDefaultInferenceStrideMs);
+
+  /** 步长 (ms)，按 10ms hop 取整并限制在 [10, 500]；可在任意线程调用 */
+  void setStrideMs(int strideMs);
+  int strideMs() const;
+
+  /**
+   * 新 Mel 帧到达后调用 (totalMelFrames 为累计帧数)；backlog 表示本块之后队列中还有待分析的块
+   * 返回 true 表示应立即对最新窗口推理。积压期间到期的窗口不推理、计为跳过，追上后的第一次调用即触发
+   */
+  bool shouldRun(uint64_t totalMelFrames, bool backlog = false);
+
+  void reset();
+
+  /**
+   * Mel 流在一段空档后续上 (VAD 门重新打开)：空档内没有产生帧，不计为跳过的窗口；
+   * 下一次 shouldRun 即触发 (仍须凑满第一个窗口)
+   */
+  void resume(uint64_t totalMelFrames);
+
+  /** 已调度的推理次数 / 因积压或被同一次送入中更新的窗口取代而跳过的窗口数 */
+  uint64_t scheduledWindows() const { return scheduled_.load(std::memory_order_relaxed); }
+  uint64_t skippedWindows() const { return skipped_.load(std::memory_order_relaxed); }
+
+ private:
+  std::atomic<int> strideFrames_;
+  uint64_t nextDueFrame_;
+  bool deferred_ = false;  // 积压期间有窗口到期：追上后立即推理
+  std::atomic<uint64_t> scheduled_{0};
+  std::atomic<uint64_t> skipped_{0};
+};
+
+}  // namespace silenceguard
+
+#endif  // SILENCEGUARD_INFERENCESCHEDULER_H
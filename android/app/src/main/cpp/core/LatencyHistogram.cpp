@@ -0,0 +1,68 @@
+#include "LatencyHistogram.h"
+#include <algorithm>
+
+namespace silenceguard {
+
+namespace {
+
+inline int highestBit(uint64_t v) {
+#if defined(__GNUC__) || defined(__clang__)
+  return 63 - __builtin_clzll(v);
+#else
+  int b = 0;
+  while (v >>= 1) ++b;
+  return b;
+#endif
+}
+
+}  // namespace
+
+int LatencyHistogram::bucketIndex(uint64_t ns) {
+  // [0, 16) 线性；之后每个 [2^e, 2^(e+1)) 取最高 4 位以下的 4 位作子桶
+  if (ns < static_cast<uint64_t>(kSubBuckets)) return static_cast<int>(ns);
+  int e = std::min(highestBit(ns), kMaxExponent);
+  if (e == kMaxExponent) return kBuckets - 1;
+  int sub = static_cast<int>((ns >> (e - kSubBucketBits)) & (kSubBuckets - 1));
+  return (e - kSubBucketBits + 1) * kSubBuckets + sub;
+}
+
+uint64_t LatencyHistogram::bucketUpperBound(int index) {
+  if (index < kSubBuckets) return static_cast<uint64_t>(index);
+  int e = index / kSubBuckets + kSubBucketBits - 1;
+  uint64_t sub = static_cast<uint64_t>(index % kSubBuckets);
+  uint64_t width = 1ull << (e - kSubBucketBits);
+  return (1ull << e) + (sub + 1) * width - 1;
+}
+
+void LatencyHistogram::record(uint64_t ns) {
+  buckets_[bucketIndex(ns)].fetch_add(1, std::memory_order_relaxed);
+  count_.fetch_add(1, std::memory_order_relaxed);
+  sum_.fetch_add(ns, std::memory_order_relaxed);
+  uint64_t prev = max_.load(std::memory_order_relaxed);
+  while (ns > prev && !max_.compare_exchange_weak(prev, ns, std::memory_order_relaxed)) {
+  }
+}
+
+uint64_t LatencyHistogram::percentile(double q) const {
+  uint64_t total = 0;
+  for (const auto& b : buckets_) total += b.load(std::memory_order_relaxed);
+  if (total == 0) return 0;
+
+  q = std::max(0.0, std::min(1.0, q));
+  const uint64_t rank = std::max<uint64_t>(1, static_cast<uint64_t>(q * static_cast<double>(total) + 0.5));
+  uint64_t seen = 0;
+  for (int i = 0; i < kBuckets; ++i) {
+    seen += buckets_[i].load(std::memory_order_relaxed);
+    if (seen >= rank) return std::min(bucketUpperBound(i), maxNs());
+  }
+  return maxNs();
+}
+
+void LatencyHistogram::reset() {
+  for (auto& b : buckets_) b.store(0, std::memory_order_relaxed);
+  count_.store(0, std::memory_order_relaxed);
+  sum_.store(0, std::memory_order_relaxed);
+  max_.store(0, std::memory_order_relaxed);
+}
+
+}  // namespace silenceguard
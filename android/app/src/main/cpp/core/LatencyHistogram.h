@@ -0,0 +1,45 @@
+// SilenceGuard Pro — 无锁 HDR 风格延迟直方图
+// 对数-线性分桶：每个 2 的幂区间再分 16 个子桶 (相对误差 ≤ 6.25%)，覆盖 1ns – 约 68s；
+// record 只做 relaxed fetch_add，可在 HAL / 分析线程热路径并发调用；快照读取不阻塞写入
+
+#ifndef SILENCEGUARD_LATENCYHISTOGRAM_H
+#define SILENCEGUARD_LATENCYHISTOGRAM_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace silenceguard {
+
+class LatencyHistogram {
+ public:
+  static constexpr int kSubBucketBits = 4;
+  static constexpr int kSubBuckets = 1 << kSubBucketBits;
+  static constexpr int kMaxExponent = 36;  // 2^36 ns ≈ 68s，更大的值计入最后一个桶
+  static constexpr int kBuckets = (kMaxExponent - kSubBucketBits + 1) * kSubBuckets + 1;
+
+  void record(uint64_t ns);
+
+  uint64_t count() const { return count_.load(std::memory_order_relaxed); }
+  uint64_t sumNs() const { return sum_.load(std::memory_order_relaxed); }
+  uint64_t maxNs() const { return max_.load(std::memory_order_relaxed); }
+
+  /** 分位数 q ∈ [0, 1]，返回所在桶的上界 (ns)；无样本时为 0 */
+  uint64_t percentile(double q) const;
+
+  /** 清零 (与 record 并发时可能丢失少量样本) */
+  void reset();
+
+ private:
+  static int bucketIndex(uint64_t ns);
+  static uint64_t bucketUpperBound(int index);
+
+  std::atomic<uint64_t> buckets_[kBuckets] = {};
+  std::atomic<uint64_t> count_{0};
+  std::atomic<uint64_t> sum_{0};
+  std::atomic<uint64_t> max_{0};
+};
+
+}  // namespace silenceguard
+
+#endif  // SILENCEGUARD_LATENCYHISTOGRAM_H
@@ -4,31 +4,113 @@
 
 namespace silenceguard {
 
-RingBuffer::RingBuffer() { std::memset(buffer_, 0, sizeof(buffer_)); }
+namespace {
+size_t roundUpPow2(size_t n) {
+  size_t p = 1;
+  while (p < n) p <<= 1;
+  return p;
+}
+
+// 环内样本以 relaxed 原子逐个读写 (与普通 load / store 同一条指令)：生产者覆盖消费者正在拷贝的
+// 槽位时不构成数据竞争，撕裂由 claim_pos_ 复查发现；peekLast / ptrAt 只在生产者线程使用
+void storeSamples(int16_t* dst, const int16_t* src, size_t n) {
+  for (size_t i = 0; i < n; ++i) __atomic_store_n(dst + i, src[i], __ATOMIC_RELAXED);
+}
+
+void loadSamples(int16_t* dst, const int16_t* src, size_t n) {
+  for (size_t i = 0; i < n; ++i) dst[i] = __atomic_load_n(src + i, __ATOMIC_RELAXED);
+}
+}  // namespace
+
+RingBuffer::RingBuffer(size_t capacityFrames)
+    : capacity_(roundUpPow2(std::max<size_t>(capacityFrames, 2))),
+      mask_(capacity_ - 1),
+      buffer_(new int16_t[capacity_]) {
+  std::memset(buffer_.get(), 0, capacity_ * sizeof(int16_t));
+}
 
 RingBuffer::~RingBuffer() = default;
 
 void RingBuffer::write(const int16_t* data, size_t frames) {
-  if (frames == 0) return;
-  for (size_t i = 0; i < frames; ++i) {
-    buffer_[write_pos_ % kRingCapacityFrames] = data[i];
-    write_pos_++;
+  if (!data || frames == 0) return;
+  uint64_t w = write_pos_.load(std::memory_order_relaxed);
+
+  // 超过容量的部分只保留最后 capacity 个样本
+  if (frames > capacity_) {
+    w += frames - capacity_;
+    data += frames - capacity_;
+    frames = capacity_;
   }
-  size_ = std::min(size_ + frames, kRingCapacityFrames);
+
+  // 先公布覆盖范围：读端看到本次写入的任一样本时 (经栅栏配对) 必然也看到 claim
+  claim_pos_.store(w + frames, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+
+  size_t idx = static_cast<size_t>(w) & mask_;
+  size_t first = std::min(frames, capacity_ - idx);
+  storeSamples(buffer_.get() + idx, data, first);
+  if (frames > first) storeSamples(buffer_.get(), data + first, frames - first);
+
+  write_pos_.store(w + frames, std::memory_order_release);
+}
+
+size_t RingBuffer::peekLast(size_t frames, PcmSpan* first, PcmSpan* second) const {
+  uint64_t w = write_pos_.load(std::memory_order_acquire);
+  size_t n = static_cast<size_t>(std::min<uint64_t>({frames, capacity_, w}));
+
+  size_t start = static_cast<size_t>(w - n) & mask_;
+  size_t firstLen = std::min(n, capacity_ - start);
+  if (first) *first = PcmSpan{buffer_.get() + start, firstLen};
+  if (second) *second = PcmSpan{buffer_.get(), n - firstLen};
+  return n;
+}
+
+int16_t* RingBuffer::ptrAt(size_t frameOffset) {
+  uint64_t w = write_pos_.load(std::memory_order_acquire);
+  return &buffer_[static_cast<size_t>(w - frameOffset) & mask_];
 }
 
 size_t RingBuffer::read(int16_t* out, size_t frames) {
-  size_t read_pos = write_pos_ >= size_ ? write_pos_ - size_ : 0;
-  size_t n = std::min(frames, size_);
-  for (size_t i = 0; i < n; ++i) {
-    out[i] = buffer_[(read_pos + i) % kRingCapacityFrames];
+  if (!out || frames == 0) return 0;
+  uint64_t r = read_pos_.load(std::memory_order_relaxed);
+  const uint64_t w = write_pos_.load(std::memory_order_acquire);
+
+  // 消费者落后超过一整圈：跳到仍有效的最旧样本
+  if (w - r > capacity_) {
+    overruns_.fetch_add(w - capacity_ - r, std::memory_order_relaxed);
+    r = w - capacity_;
   }
+
+  size_t n = static_cast<size_t>(std::min<uint64_t>(frames, w - r));
+  size_t idx = static_cast<size_t>(r) & mask_;
+  size_t first = std::min(n, capacity_ - idx);
+  loadSamples(out, buffer_.get() + idx, first);
+  if (n > first) loadSamples(out + first, buffer_.get(), n - first);
+
+  // 复查：拷贝期间生产者可能已套圈，位置 < claim - capacity 的样本不可信，丢弃该前缀
+  std::atomic_thread_fence(std::memory_order_acquire);
+  const uint64_t claim = claim_pos_.load(std::memory_order_relaxed);
+  read_pos_.store(r + n, std::memory_order_release);
+  if (claim <= r + capacity_) return n;
+  const size_t lost = static_cast<size_t>(std::min<uint64_t>(n, claim - capacity_ - r));
+  overruns_.fetch_add(lost, std::memory_order_relaxed);
+  std::memmove(out, out + lost, (n - lost) * sizeof(int16_t));
+  return n - lost;
+}
+
+size_t RingBuffer::discard(size_t frames) {
+  uint64_t r = read_pos_.load(std::memory_order_relaxed);
+  const uint64_t w = write_pos_.load(std::memory_order_acquire);
+  if (w - r > capacity_) r = w - capacity_;
+  size_t n = static_cast<size_t>(std::min<uint64_t>(frames, w - r));
+  read_pos_.store(r + n, std::memory_order_release);
   return n;
 }
 
-int16_t* RingBuffer::ptrAt(size_t frameOffset) {
-  size_t idx = (write_pos_ + kRingCapacityFrames - frameOffset) % kRingCapacityFrames;
-  return &buffer_[idx];
+size_t RingBuffer::available() const {
+  uint64_t w = write_pos_.load(std::memory_order_acquire);
+  uint64_t r = read_pos_.load(std::memory_order_acquire);
+  return static_cast<size_t>(std::min<uint64_t>(w - r, capacity_));
 }
 
 }  // namespace silenceguard
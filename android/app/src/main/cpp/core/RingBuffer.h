@@ -1,31 +1,86 @@
 // SilenceGuard Pro — 环形缓冲区 (NEXT_IMPROVEMENTS §4.1)
 // 用于 "时间机器"：回溯修改已发生的违规起始音节
+// 单生产者/单消费者无锁实现：容量为 2 的幂，读写下标 acquire/release，
+// 批量拷贝 (最多两段)，peekLast 以两段连续 span 零拷贝暴露 "最近 N 个样本"
+// 生产者从不等待：套圈时覆盖最旧样本。写入前先公布将覆盖到的位置 (claim)，
+// read 拷贝后复查 claim，丢弃拷贝期间被覆盖的前缀 (seqlock 式校验)，不会返回撕裂的样本
 
 #ifndef SILENCEGUARD_RINGBUFFER_H
 #define SILENCEGUARD_RINGBUFFER_H
 
+#include <atomic>
 #include <cstddef>
 #include <cstdint>
+#include <memory>
 
 namespace silenceguard {
 
-// 约 200ms @ 16kHz mono 16bit → 6400 样本
-constexpr size_t kRingCapacityFrames = 6400;
+// 默认约 512ms @ 16kHz mono 16bit → 8192 样本 (2 的幂)
+constexpr size_t kRingCapacityFrames = 8192;
+
+/** 环内一段连续样本 (只读视图) */
+struct PcmSpan {
+  const int16_t* data = nullptr;
+  size_t frames = 0;
+};
 
 class RingBuffer {
  public:
-  RingBuffer();
+  /** capacityFrames 向上取整到 2 的幂 */
+  explicit RingBuffer(size_t capacityFrames = kRingCapacityFrames);
   ~RingBuffer();
 
+  RingBuffer(const RingBuffer&) = delete;
+  RingBuffer& operator=(const RingBuffer&) = delete;
+
+  size_t capacity() const { return capacity_; }
+
+  // ---- 生产者 ----
+
+  /**
+   * 追加样本 (最多两段拷贝)，永不阻塞；
+   * 消费者落后超过容量时最旧的未读样本被覆盖 (read 会跳过并计入 overruns，含 read 拷贝期间被覆盖的)
+   */
   void write(const int16_t* data, size_t frames);
-  size_t read(int16_t* out, size_t frames);
-  // 获取某时间偏移处的指针，用于 applyCrossFade / applySineWave
+
+  /**
+   * 零拷贝读取最近 frames 个样本：first 为较旧的一段，second 为回绕后的一段 (可能为空)
+   * 返回实际覆盖的样本数 (<= min(frames, capacity, totalWritten))
+   * span 在生产者再写入 capacity - frames 个样本之前保持有效
+   */
+  size_t peekLast(size_t frames, PcmSpan* first, PcmSpan* second) const;
+
+  /** 获取距写指针 frameOffset 个样本处的指针，用于 applyCrossFade / applySineWave */
   int16_t* ptrAt(size_t frameOffset);
 
+  /** 累计写入样本数 (绝对采样位置) */
+  uint64_t totalWritten() const { return write_pos_.load(std::memory_order_acquire); }
+
+  // ---- 消费者 ----
+
+  /**
+   * 读出并消费最多 frames 个最旧的未读样本，返回实际读取数；
+   * 与生产者并发时返回的样本保证是连续且未被覆盖的 (拷贝期间被套圈的前缀不返回)
+   */
+  size_t read(int16_t* out, size_t frames);
+
+  /** 丢弃最多 frames 个最旧的未读样本，返回实际丢弃数 */
+  size_t discard(size_t frames);
+
+  /** 未读样本数 (<= capacity) */
+  size_t available() const;
+
+  /** 因消费者落后而被覆盖丢弃的样本数 */
+  uint64_t overruns() const { return overruns_.load(std::memory_order_relaxed); }
+
  private:
-  int16_t buffer_[kRingCapacityFrames];
-  size_t write_pos_ = 0;
-  size_t size_ = 0;
+  size_t capacity_;
+  size_t mask_;
+  std::unique_ptr<int16_t[]> buffer_;
+  alignas(64) std::atomic<uint64_t> write_pos_{0};
+  std::atomic<uint64_t> claim_pos_{0};  // 进行中的写入结束位置：位置 < claim - capacity 的槽位可能已被覆盖
+  alignas(64) std::atomic<uint64_t> read_pos_{0};
+  std::atomic<uint64_t> overruns_{0};
 };
 
 }  // namespace silenceguard
@@ -0,0 +1,64 @@
+// SilenceGuard Pro — 单生产者/单消费者 PCM 块队列 (wait-free)
+// 生产者 = HAL in_read 线程，只做一次 memcpy + release store；消费者 = 分析线程
+// 队列满时直接丢块 (由调用方计数)，生产者永不等待
+
+#ifndef SILENCEGUARD_SPSCBLOCKQUEUE_H
+#define SILENCEGUARD_SPSCBLOCKQUEUE_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+namespace silenceguard {
+
+template <size_t kSlots, size_t kBlockFrames>
+class SpscBlockQueue {
+  static_assert(kSlots >= 2 && (kSlots & (kSlots - 1)) == 0, "kSlots must be a power of two");
+
+ public:
+  struct Block {
+    int64_t enqueueNs;  // 入队时刻 (steady clock)，用于统计迟到块
+    uint64_t position;  // pcm[0] 的绝对采样位置 (丢块后仍与 HAL 输出对齐)
+    uint32_t frames;
+    int16_t pcm[kBlockFrames];
+  };
+
+  static constexpr size_t blockFrames() { return kBlockFrames; }
+
+  /** 生产者：拷贝 frames (<= kBlockFrames) 个样本；队列满返回 false */
+  bool tryPush(const int16_t* pcm, size_t frames, int64_t enqueueNs, uint64_t position) {
+    const size_t tail = tail_.load(std::memory_order_relaxed);
+    if (tail - head_.load(std::memory_order_acquire) >= kSlots) return false;
+    Block& b = slots_[tail & (kSlots - 1)];
+    b.enqueueNs = enqueueNs;
+    b.position = position;
+    b.frames = static_cast<uint32_t>(frames);
+    std::memcpy(b.pcm, pcm, frames * sizeof(int16_t));
+    tail_.store(tail + 1, std::memory_order_release);
+    return true;
+  }
+
+  /** 消费者：队首块，空时返回 nullptr；处理完后调用 pop() */
+  const Block* front() const {
+    const size_t head = head_.load(std::memory_order_relaxed);
+    if (head == tail_.load(std::memory_order_acquire)) return nullptr;
+    return &slots_[head & (kSlots - 1)];
+  }
+
+  void pop() { head_.store(head_.load(std::memory_order_relaxed) + 1, std::memory_order_release); }
+
+  /** 近似深度 (任一端调用均安全) */
+  size_t size() const {
+    return tail_.load(std::memory_order_acquire) - head_.load(std::memory_order_acquire);
+  }
+
+ private:
+  alignas(64) std::atomic<size_t> head_{0};
+  alignas(64) std::atomic<size_t> tail_{0};
+  alignas(64) Block slots_[kSlots];
+};
+
+}  // namespace silenceguard
+
+#endif  // SILENCEGUARD_SPSCBLOCKQUEUE_H
@@ -0,0 +1,114 @@
+// SilenceGuard Pro — 三角 Mel 滤波器组
+
+#include "MelFilterbank.h"
+#include <algorithm>
+#include <cmath>
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define SG_MEL_NEON 1
+#elif defined(__SSE2__) || defined(_M_X64)
+#include <xmmintrin.h>
+#define SG_MEL_SSE 1
+#endif
+
+namespace silenceguard {
+
+namespace {
+
+// Slaney: linear below 1 kHz (200/3 Hz per mel), log above (27 mels per factor 6.4)
+constexpr double kSlaneyBreakHz = 1000.0;
+constexpr double kSlaneyHzPerMel = 200.0 / 3.0;
+constexpr double kSlaneyBreakMel = kSlaneyBreakHz / kSlaneyHzPerMel;  // 15
+const double kSlaneyLogStep = std::log(6.4) / 27.0;
+
+double hzToMel(double hz, MelScale scale) {
+    if (scale == MelScale::kHtk) return 2595.0 * std::log10(1.0 + hz / 700.0);
+    if (hz < kSlaneyBreakHz) return hz / kSlaneyHzPerMel;
+    return kSlaneyBreakMel + std::log(hz / kSlaneyBreakHz) / kSlaneyLogStep;
+}
+
+double melToHz(double mel, MelScale scale) {
+    if (scale == MelScale::kHtk) return 700.0 * (std::pow(10.0, mel / 2595.0) - 1.0);
+    if (mel < kSlaneyBreakMel) return mel * kSlaneyHzPerMel;
+    return kSlaneyBreakHz * std::exp(kSlaneyLogStep * (mel - kSlaneyBreakMel));
+}
+
+// Dot product of one filter's contiguous weight span with the power spectrum
+inline float spanDot(const float* x, const float* w, int n) {
+    int i = 0;
+#if defined(SG_MEL_NEON)
+    float32x4_t acc = vdupq_n_f32(0.0f);
+    for (; i + 4 <= n; i += 4) acc = vmlaq_f32(acc, vld1q_f32(x + i), vld1q_f32(w + i));
+    float32x2_t s2 = vadd_f32(vget_low_f32(acc), vget_high_f32(acc));
+    float sum = vget_lane_f32(vpadd_f32(s2, s2), 0);
+#elif defined(SG_MEL_SSE)
+    __m128 acc = _mm_setzero_ps();
+    for (; i + 4 <= n; i += 4) acc = _mm_add_ps(acc, _mm_mul_ps(_mm_loadu_ps(x + i), _mm_loadu_ps(w + i)));
+    acc = _mm_add_ps(acc, _mm_movehl_ps(acc, acc));
+    acc = _mm_add_ss(acc, _mm_shuffle_ps(acc, acc, 1));
+    float sum = _mm_cvtss_f32(acc);
+#else
+    float sum = 0.0f;
+#endif
+    for (; i < n; ++i) sum += x[i] * w[i];
+    return sum;
+}
+
+} // namespace
+
+MelFilterbank::MelFilterbank(int numFilters, int fftSize, int sampleRate,
+                             float fMin, float fMax, MelScale scale)
+    : numBins_(fftSize / 2 + 1) {
+    const double nyquist = sampleRate / 2.0;
+    if (fMax <= 0.0f || fMax > nyquist) fMax = static_cast<float>(nyquist);
+    fMin = std::max(0.0f, std::min(fMin, fMax));
+
+    // numFilters + 2 edge frequencies equally spaced on the Mel axis
+    const double melLo = hzToMel(fMin, scale);
+    const double melHi = hzToMel(fMax, scale);
+    std::vector<double> edges(numFilters + 2);
+    for (int i = 0; i < numFilters + 2; ++i) {
+        edges[i] = melToHz(melLo + (melHi - melLo) * i / (numFilters + 1), scale);
+    }
+
+    const double binHz = static_cast<double>(sampleRate) / fftSize;
+    filters_.reserve(numFilters);
+    weights_.reserve(2 * numBins_);
+
+    for (int m = 0; m < numFilters; ++m) {
+        const double lo = edges[m], center = edges[m + 1], hi = edges[m + 2];
+        const double norm = (scale == MelScale::kSlaney) ? 2.0 / (hi - lo) : 1.0;
+
+        Filter f{0, 0, static_cast<int>(weights_.size())};
+        for (int k = 0; k < numBins_; ++k) {
+            const double hz = k * binHz;
+            double w = std::min((hz - lo) / (center - lo), (hi - hz) / (hi - center));
+            if (w <= 0.0) {
+                if (f.length > 0) break;  // past the right slope
+                continue;
+            }
+            if (f.length == 0) f.startBin = k;
+            weights_.push_back(static_cast<float>(w * norm));
+            ++f.length;
+        }
+
+        // Low filters can be narrower than one FFT bin: fall back to the bin nearest the center
+        if (f.length == 0) {
+            f.startBin = std::min(numBins_ - 1, static_cast<int>(std::lround(center / binHz)));
+            f.length = 1;
+            weights_.push_back(static_cast<float>(norm));
+        }
+        filters_.push_back(f);
+    }
+}
+
+void MelFilterbank::apply(const float* power, float* outEnergies) const {
+    const float* w = weights_.data();
+    for (size_t m = 0; m < filters_.size(); ++m) {
+        const Filter& f = filters_[m];
+        outEnergies[m] = spanDot(power + f.startBin, w + f.weightOffset, f.length);
+    }
+}
+
+}  // namespace silenceguard
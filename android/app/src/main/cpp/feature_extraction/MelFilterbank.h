@@ -0,0 +1,52 @@
+// SilenceGuard Pro — 三角 Mel 滤波器组 (稀疏存储)
+// 每个滤波器只保存 [startBin, startBin + length) 的连续非零权重，
+// 80 × 257 稠密矩阵 (~20k MAC/帧) → ~500 MAC/帧；apply 使用 NEON / SSE 内核，其余平台标量回退
+
+#ifndef SILENCEGUARD_MELFILTERBANK_H
+#define SILENCEGUARD_MELFILTERBANK_H
+
+#include <cstddef>
+#include <vector>
+
+namespace silenceguard {
+
+enum class MelScale {
+  kHtk,     // mel = 2595·log10(1 + f/700)，峰值为 1 的三角
+  kSlaney,  // 1kHz 以下线性、以上对数 (librosa/Slaney)，按带宽面积归一化
+};
+
+class MelFilterbank {
+ public:
+  /**
+   * @param numFilters Mel 通道数 (80)
+   * @param fftSize    FFT 点数 (512)，功率谱 bin 数为 fftSize/2 + 1
+   * @param sampleRate 采样率 (16000)
+   * @param fMin/fMax  频率范围 (Hz)，fMax <= 0 时取 Nyquist
+   */
+  MelFilterbank(int numFilters, int fftSize, int sampleRate,
+                float fMin = 0.0f, float fMax = 0.0f,
+                MelScale scale = MelScale::kHtk);
+
+  /** power: numBins() 个功率谱值；outEnergies: numFilters() 个滤波器能量 */
+  void apply(const float* power, float* outEnergies) const;
+
+  int numFilters() const { return static_cast<int>(filters_.size()); }
+  int numBins() const { return numBins_; }
+  /** 非零权重总数 = 每帧 MAC 次数 */
+  size_t nonZeroWeights() const { return weights_.size(); }
+
+ private:
+  struct Filter {
+    int startBin;
+    int length;
+    int weightOffset;  // weights_ 中的起始下标
+  };
+
+  int numBins_;
+  std::vector<Filter> filters_;
+  std::vector<float> weights_;  // 所有滤波器的非零权重首尾相接
+};
+
+}  // namespace silenceguard
+
+#endif  // SILENCEGUARD_MELFILTERBANK_H
@@ -1,105 +1,85 @@
 // SilenceGuard Pro — Mel 谱特征提取 (Phase 2 真实实现)
 
 #include "MelSpectrogram.h"
+#include "MelFilterbank.h"
+#include "RealFft.h"
 #include <vector>
 #include <cmath>
 #include <algorithm>
-#include <complex>
+#include <memory>
 
 namespace silenceguard {
 
 namespace {
 
 // DSP Constants
-constexpr float kPreEmphasisCoeff = 0.97f;
 constexpr float kPi = 3.14159265358979323846f;
-constexpr int kFftSize = 512; // Next power of 2 for 400 samples (25ms @ 16kHz)
-constexpr int kFrameLen = 400; // 25ms
-constexpr int kFrameStep = 160;// 10ms
+constexpr float kLogFloor = 1e-9f;
 
-// Hann Window
-std::vector<float> g_window;
-// Mel Filterbank
-std::vector<std::vector<float>> g_melFilters;
+// Batch path kernel (computeMelFrames is single-threaded like before)
+std::unique_ptr<MelFrameKernel> g_kernel;
+std::vector<float> g_emphasized;
 
 void initDSP() {
-    if (!g_window.empty()) return;
-    
-    // 1. Hann Window
-    g_window.resize(kFrameLen);
-    for (int i = 0; i < kFrameLen; ++i) {
-        g_window[i] = 0.5f * (1.0f - std::cos(2.0f * kPi * i / (kFrameLen - 1)));
-    }
-
-    // 2. Mel Filterbank (Simplified 80 bins, 0-8000Hz)
-    // In production, this should be pre-computed or loaded from config
-    // Stub: Create identity-like simplified filters for POC
-    // Real implementation requires standard Mel-scale conversion and triangle filters
-    g_melFilters.resize(kMelBins, std::vector<float>(kFftSize / 2 + 1, 0.0f));
-    // ... Fill with real weights ...
+    if (g_kernel) return;
+    g_kernel = std::make_unique<MelFrameKernel>();
+    g_emphasized.assign(kWindowSamples, 0.0f);
 }
 
-// Simple DFT (Slow, O(N^2), but dependency-free for POC)
-// Production should use FFTW or KissFFT
-void simpleDft(const std::vector<float>& pcm, std::vector<float>& magSpec) {
-    int N = kFftSize;
-    magSpec.resize(N / 2 + 1);
-    for (int k = 0; k <= N / 2; ++k) {
-        float re = 0.0f;
-        float im = 0.0f;
-        float angleTerm = -2.0f * kPi * k / N;
-        for (int n = 0; n < N; ++n) {
-            float input = (n < pcm.size()) ? pcm[n] : 0.0f;
-            re += input * std::cos(angleTerm * n);
-            im += input * std::sin(angleTerm * n);
-        }
-        magSpec[k] = std::sqrt(re * re + im * im);
+} // namespace
+
+MelFrameKernel::MelFrameKernel()
+    : window_(kWindowSamples),
+      fft_(std::make_unique<RealFft>(kFftSize)),
+      // 80 HTK triangles over 0-8000Hz on the power spectrum
+      bank_(std::make_unique<MelFilterbank>(kMelBins, kFftSize, kSampleRate,
+                                            0.0f, kSampleRate / 2.0f, MelScale::kHtk)),
+      frame_(kFftSize, 0.0f),
+      power_(fft_->numBins(), 0.0f) {
+    // Hann Window
+    for (int i = 0; i < kWindowSamples; ++i) {
+        window_[i] = 0.5f * (1.0f - std::cos(2.0f * kPi * i / (kWindowSamples - 1)));
     }
 }
 
-} // namespace
+MelFrameKernel::~MelFrameKernel() = default;
+
+void MelFrameKernel::compute(const float* emphasized, float* outMel) {
+    // 1. Windowing (zero tail [kWindowSamples, kFftSize) stays zero)
+    for (int i = 0; i < kWindowSamples; ++i) frame_[i] = emphasized[i] * window_[i];
+
+    // 2. FFT -> Power
+    fft_->powerSpectrum(frame_.data(), power_.data());
+
+    // 3. Mel Filterbank -> Log
+    bank_->apply(power_.data(), outMel);
+    for (int m = 0; m < kMelBins; ++m) {
+        outMel[m] = std::log(std::max(outMel[m], kLogFloor));
+    }
+}
 
 int computeMelFrames(const int16_t* audio, size_t numFrames,
                      float* outMel, size_t maxOutFrames) {
     if (!audio || numFrames == 0 || !outMel || maxOutFrames == 0) return 0;
-    
+
     initDSP();
 
     size_t outFrameCount = 0;
     size_t pos = 0;
-    
-    // Temporary buffers
-    std::vector<float> frame(kFftSize, 0.0f);
-    std::vector<float> spc;
+    float* frame = g_emphasized.data();
 
-    while (outFrameCount < maxOutFrames && pos + kFrameLen <= numFrames) {
-        // 1. Pre-emphasis & Windowing
+    while (outFrameCount < maxOutFrames && pos + kWindowSamples <= numFrames) {
+        // Pre-emphasis (x[n] - 0.97·x[n-1], continuous across frames)
         float prev = (pos == 0) ? 0.0f : static_cast<float>(audio[pos - 1]);
-        for (int i = 0; i < kFrameLen; ++i) {
+        for (int i = 0; i < kWindowSamples; ++i) {
             float curr = static_cast<float>(audio[pos + i]);
-            frame[i] = (curr - kPreEmphasisCoeff * prev) * g_window[i];
+            frame[i] = curr - kPreEmphasisCoeff * prev;
             prev = curr;
         }
-        // Zero padding handled by resize kFftSize
-
-        // 2. FFT -> Magnitude
-        simpleDft(frame, spc);
-
-        // 3. Mel Filterbank -> Log
-        for (int m = 0; m < kMelBins; ++m) {
-            float energy = 0.0f;
-            // Simplified mapping for POC: just avg bins
-            // Real impl needs matrix mult
-            int startBin = m * (spc.size() / kMelBins);
-            int endBin = (m + 1) * (spc.size() / kMelBins);
-            for (int k = startBin; k < endBin && k < spc.size(); ++k) {
-                energy += spc[k];
-            }
-            if (energy < 1e-9f) energy = 1e-9f;
-            outMel[outFrameCount * kMelBins + m] = std::log(energy);
-        }
 
-        pos += kFrameStep;
+        g_kernel->compute(frame, outMel + outFrameCount * kMelBins);
+
+        pos += kHopSamples;
         outFrameCount++;
     }
 
@@ -7,6 +7,8 @@
 
 #include <cstddef>
 #include <cstdint>
+#include <memory>
+#include <vector>
 
 namespace silenceguard {
 
@@ -16,6 +18,31 @@ constexpr int kMaxFrames = 50;
 constexpr int kSampleRate = 16000;
 constexpr int kHopMs = 10;
 constexpr int kHopSamples = kSampleRate * kHopMs / 1000;  // 160
+constexpr int kWindowSamples = 400;                       // 25ms 分析窗
+constexpr int kFftSize = 512;                             // 400 → 下一个 2 的幂
+constexpr float kPreEmphasisCoeff = 0.97f;
+
+class RealFft;
+class MelFilterbank;
+
+/**
+ * 单帧 Mel 内核：已预加重的 kWindowSamples 点帧 → 加窗 → 功率谱 → 80 维 log-Mel
+ * 持有 FFT / 滤波器组 / 工作区，compute 无堆分配；非线程安全，每个使用方持有一份
+ */
+class MelFrameKernel {
+ public:
+  MelFrameKernel();
+  ~MelFrameKernel();
+
+  void compute(const float* emphasized, float* outMel);
+
+ private:
+  std::vector<float> window_;  // Hann, kWindowSamples
+  std::unique_ptr<RealFft> fft_;
+  std::unique_ptr<MelFilterbank> bank_;
+  std::vector<float> frame_;  // kFftSize，尾部零填充
+  std::vector<float> power_;
+};
 
 /** 将 PCM 帧转为 Mel 谱 [1, time_frames, 80]，供 TFLite 输入 */
 int computeMelFrames(const int16_t* audio, size_t numFrames,
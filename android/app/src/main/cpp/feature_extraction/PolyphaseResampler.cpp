@@ -0,0 +1,206 @@
+// SilenceGuard Pro — 流式多相重采样器
+
+#include "PolyphaseResampler.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <map>
+#include <mutex>
+#include <numeric>
+#include <utility>
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define SG_RS_NEON 1
+#elif defined(__AVX2__)
+#include <immintrin.h>
+#define SG_RS_AVX2 1
+#elif defined(__SSE2__) || defined(_M_X64)
+#include <xmmintrin.h>
+#define SG_RS_SSE 1
+#endif
+
+namespace silenceguard {
+
+/** 一个比例 (L/M) 的系数表：coef[p × taps + j] = h[p + (taps-1-j)·L]，与输入窗口顺序对齐 */
+struct PolyphaseResampler::Bank {
+  int up = 1;    // L
+  int down = 1;  // M
+  int taps = 0;
+  double delay = 0.0;
+  std::vector<float> coef;
+};
+
+namespace {
+
+constexpr int kTapAlign = 8;              // 点积长度对齐到 8 (AVX2 一次 8 路，NEON / SSE 两次 4 路)
+constexpr double kStopbandDb = 70.0;
+constexpr double kPassFraction = 0.4375;  // 通带边 / min(输入, 输出) 采样率 (16k 输出时为 7 kHz)
+constexpr double kPi = 3.14159265358979323846;
+
+// 零阶修正贝塞尔函数 (Kaiser 窗)：级数求和到相对精度 1e-12
+double besselI0(double x) {
+  double sum = 1.0, term = 1.0;
+  const double q = x * x / 4.0;
+  for (int k = 1; k < 64 && term > 1e-12 * sum; ++k) {
+    term *= q / (static_cast<double>(k) * k);
+    sum += term;
+  }
+  return sum;
+}
+
+std::shared_ptr<const PolyphaseResampler::Bank> design(int up, int down, int inRate, int outRate) {
+  auto bank = std::make_shared<PolyphaseResampler::Bank>();
+  bank->up = up;
+  bank->down = down;
+
+  // 原型在 inRate·L 上设计：通带 / 阻带边按较低的采样率取，过渡带宽决定长度 (Kaiser 经验公式)
+  const double proto = static_cast<double>(inRate) * up;
+  const double base = std::min(inRate, outRate);
+  const double pass = kPassFraction * base, stop = 0.5 * base;
+  const double width = (stop - pass) / proto;
+  const int length = static_cast<int>(std::ceil((kStopbandDb - 7.95) / (14.36 * width))) + 1;
+  const int taps = ((length + up - 1) / up + kTapAlign - 1) / kTapAlign * kTapAlign;
+  const int total = taps * up;
+  const double beta = 0.1102 * (kStopbandDb - 8.7);
+  const double cutoff = 0.5 * (pass + stop) / proto;  // 归一化到原型采样率
+  const double center = 0.5 * (total - 1);
+  const double norm = besselI0(beta);
+
+  std::vector<double> h(total);
+  double sum = 0.0;
+  for (int m = 0; m < total; ++m) {
+    const double t = m - center;
+    const double sinc = t == 0.0 ? 2.0 * cutoff : std::sin(2.0 * kPi * cutoff * t) / (kPi * t);
+    const double r = t / (0.5 * total);
+    const double w = std::abs(r) < 1.0 ? besselI0(beta * std::sqrt(1.0 - r * r)) / norm : 0.0;
+    h[m] = sinc * w;
+    sum += h[m];
+  }
+  // 直流增益 L：插零上采样后每个相位的增益为 1
+  const double gain = up / sum;
+
+  bank->taps = taps;
+  bank->delay = (total - 1) / (2.0 * up);
+  bank->coef.resize(static_cast<size_t>(total));
+  for (int p = 0; p < up; ++p) {
+    float* row = &bank->coef[static_cast<size_t>(p) * taps];
+    for (int j = 0; j < taps; ++j) row[j] = static_cast<float>(h[p + (taps - 1 - j) * up] * gain);
+  }
+  return bank;
+}
+
+// 同一比例的实例共享系数表 (44.1k→16k 约 120 KB)；只在构造时加锁
+std::shared_ptr<const PolyphaseResampler::Bank> sharedBank(int inRate, int outRate) {
+  static std::mutex mutex;
+  static std::map<std::pair<int, int>, std::weak_ptr<const PolyphaseResampler::Bank>> cache;
+  const int g = std::gcd(inRate, outRate);
+  const int up = outRate / g, down = inRate / g;
+  std::lock_guard<std::mutex> lock(mutex);
+  std::weak_ptr<const PolyphaseResampler::Bank>& slot = cache[{inRate, outRate}];
+  std::shared_ptr<const PolyphaseResampler::Bank> bank = slot.lock();
+  if (!bank) {
+    bank = design(up, down, inRate, outRate);
+    slot = bank;
+  }
+  return bank;
+}
+
+// 一个输出样本：系数行与输入窗口的点积，n 为 kTapAlign 的整数倍
+inline float dot(const float* w, const float* x, int n) {
+  int i = 0;
+#if defined(SG_RS_AVX2)
+  __m256 acc0 = _mm256_setzero_ps();
+  for (; i < n; i += 8) acc0 = _mm256_add_ps(acc0, _mm256_mul_ps(_mm256_loadu_ps(w + i), _mm256_loadu_ps(x + i)));
+  __m128 acc = _mm_add_ps(_mm256_castps256_ps128(acc0), _mm256_extractf128_ps(acc0, 1));
+  acc = _mm_add_ps(acc, _mm_movehl_ps(acc, acc));
+  acc = _mm_add_ss(acc, _mm_shuffle_ps(acc, acc, 1));
+  return _mm_cvtss_f32(acc);
+#elif defined(SG_RS_SSE)
+  __m128 acc0 = _mm_setzero_ps(), acc1 = _mm_setzero_ps();
+  for (; i < n; i += 8) {
+    acc0 = _mm_add_ps(acc0, _mm_mul_ps(_mm_loadu_ps(w + i), _mm_loadu_ps(x + i)));
+    acc1 = _mm_add_ps(acc1, _mm_mul_ps(_mm_loadu_ps(w + i + 4), _mm_loadu_ps(x + i + 4)));
+  }
+  __m128 acc = _mm_add_ps(acc0, acc1);
+  acc = _mm_add_ps(acc, _mm_movehl_ps(acc, acc));
+  acc = _mm_add_ss(acc, _mm_shuffle_ps(acc, acc, 1));
+  return _mm_cvtss_f32(acc);
+#elif defined(SG_RS_NEON)
+  float32x4_t acc0 = vdupq_n_f32(0.0f), acc1 = vdupq_n_f32(0.0f);
+  for (; i < n; i += 8) {
+    acc0 = vmlaq_f32(acc0, vld1q_f32(w + i), vld1q_f32(x + i));
+    acc1 = vmlaq_f32(acc1, vld1q_f32(w + i + 4), vld1q_f32(x + i + 4));
+  }
+  float32x4_t acc = vaddq_f32(acc0, acc1);
+  float32x2_t s2 = vadd_f32(vget_low_f32(acc), vget_high_f32(acc));
+  return vget_lane_f32(vpadd_f32(s2, s2), 0);
+#else
+  float sum = 0.0f;
+  for (; i < n; ++i) sum += w[i] * x[i];
+  return sum;
+#endif
+}
+
+}  // namespace
+
+bool PolyphaseResampler::supports(int inRate, int outRate) {
+  if (inRate < kMinRate || inRate > kMaxRate || outRate < kMinRate || outRate > kMaxRate) return false;
+  return outRate / std::gcd(inRate, outRate) <= kMaxPhases;
+}
+
+PolyphaseResampler::PolyphaseResampler(int inRate, int outRate) : inRate_(inRate), outRate_(outRate) {
+  if (!supports(inRate, outRate)) return;
+  bank_ = sharedBank(inRate, outRate);
+  buf_.resize(static_cast<size_t>(bank_->taps) - 1 + kBlockFrames);
+  reset();
+}
+
+PolyphaseResampler::~PolyphaseResampler() = default;
+
+int PolyphaseResampler::taps() const { return bank_ ? bank_->taps : 0; }
+
+double PolyphaseResampler::delay() const { return bank_ ? bank_->delay : 0.0; }
+
+size_t PolyphaseResampler::maxOutput(size_t n) const {
+  if (!bank_) return 0;
+  return (n * static_cast<size_t>(bank_->up) + bank_->down - 1) / bank_->down + 1;
+}
+
+void PolyphaseResampler::reset() {
+  if (!bank_) return;
+  // 预填 taps-1 个零：第一个输出的窗口恰好以第一个输入样本结尾
+  fill_ = static_cast<size_t>(bank_->taps) - 1;
+  std::fill(buf_.begin(), buf_.begin() + fill_, 0.0f);
+  next_ = 0;
+  phase_ = 0;
+}
+
+size_t PolyphaseResampler::process(const float* in, size_t n, float* out) {
+  if (!bank_) return 0;
+  const Bank& b = *bank_;
+  const size_t taps = static_cast<size_t>(b.taps);
+  size_t produced = 0;
+  while (n > 0) {
+    const size_t take = std::min(n, buf_.size() - fill_);
+    std::memcpy(buf_.data() + fill_, in, take * sizeof(float));
+    fill_ += take;
+    in += take;
+    n -= take;
+
+    // 输出 k 的窗口起点 = floor(k·M / L)，相位 = k·M mod L
+    while (next_ + taps <= fill_) {
+      out[produced++] = dot(&b.coef[static_cast<size_t>(phase_) * taps], buf_.data() + next_, b.taps);
+      phase_ += b.down;
+      next_ += static_cast<size_t>(phase_ / b.up);
+      phase_ %= b.up;
+    }
+    // 保留下一个窗口起点之后的样本 (taps ≥ M/L，故 next_ ≤ fill_)
+    fill_ -= next_;
+    std::memmove(buf_.data(), buf_.data() + next_, fill_ * sizeof(float));
+    next_ = 0;
+  }
+  return produced;
+}
+
+}  // namespace silenceguard
@@ -0,0 +1,64 @@
+// SilenceGuard Pro — 流式多相重采样器 (有理比例 L/M，如 48k→16k = 1/3、44.1k→16k = 160/441)
+// 原型低通为 Kaiser 窗 sinc (阻带 ≥70 dB，通带边 0.4375·min(输入, 输出) 采样率，阻带边为其 Nyquist)，
+// 按相位拆成 L 组、每组系数倒序连续存放：每个输出样本为一次长度 taps 的向量点积 (NEON / SSE / AVX2)
+// 跨调用保存历史样本与相位；同一比例的系数表在实例间共享；只在一个线程使用
+
+#ifndef SILENCEGUARD_POLYPHASERESAMPLER_H
+#define SILENCEGUARD_POLYPHASERESAMPLER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace silenceguard {
+
+class PolyphaseResampler {
+ public:
+  static constexpr int kMinRate = 8000;
+  static constexpr int kMaxRate = 192000;
+  static constexpr int kMaxPhases = 1024;       // L 的上限 (系数表大小 = L × taps)
+  static constexpr size_t kBlockFrames = 1024;  // 内部按块送入，任意长度的输入都无堆分配
+
+  /** 比例约分后 L ≤ kMaxPhases 且两个采样率都在 [kMinRate, kMaxRate] 内时可用 */
+  static bool supports(int inRate, int outRate);
+
+  PolyphaseResampler(int inRate, int outRate);
+  ~PolyphaseResampler();
+
+  PolyphaseResampler(const PolyphaseResampler&) = delete;
+  PolyphaseResampler& operator=(const PolyphaseResampler&) = delete;
+
+  bool valid() const { return bank_ != nullptr; }
+  int inRate() const { return inRate_; }
+  int outRate() const { return outRate_; }
+  /** 每个输出样本的点积长度 (向量宽度的整数倍) */
+  int taps() const;
+
+  /** 送入 n 个输入样本可能产出的最大输出数 */
+  size_t maxOutput(size_t n) const;
+
+  /** 送入 n 个 mono 样本，输出写入 out (容量 ≥ maxOutput(n))；返回输出样本数 */
+  size_t process(const float* in, size_t n, float* out);
+
+  /** 群延迟 (输入样本)：第 k 个输出对应输入时刻 k·inRate/outRate - delay() */
+  double delay() const;
+
+  /** 清空历史与相位 (断流后) */
+  void reset();
+
+  struct Bank;
+
+ private:
+  int inRate_;
+  int outRate_;
+  std::shared_ptr<const Bank> bank_;
+  std::vector<float> buf_;  // 历史 taps-1 个样本 + 本块输入
+  size_t fill_ = 0;         // buf_ 中的有效样本数
+  size_t next_ = 0;         // 下一个输出的窗口起点 (buf_ 下标)
+  int phase_ = 0;           // 下一个输出的相位 (0 .. L-1)
+};
+
+}  // namespace silenceguard
+
+#endif  // SILENCEGUARD_POLYPHASERESAMPLER_H
@@ -0,0 +1,168 @@
+// SilenceGuard Pro — 实数输入 FFT
+
+#include "RealFft.h"
+#include <cmath>
+
+namespace silenceguard {
+
+namespace {
+
+constexpr double kPi = 3.14159265358979323846;
+
+int roundUpPow2(int n) {
+    int p = 8;
+    while (p < n) p <<= 1;
+    return p;
+}
+
+int log2Int(int n) {
+    int l = 0;
+    while ((1 << l) < n) ++l;
+    return l;
+}
+
+} // namespace
+
+RealFft::RealFft(int size)
+    : size_(roundUpPow2(size)), half_(size_ / 2) {
+    const int M = half_;
+    const int bits = log2Int(M);
+
+    // 1. Bit-reversal permutation (radix-2² butterflies consume plain bit-reversed input)
+    bitrev_.resize(M);
+    for (int i = 0; i < M; ++i) {
+        uint32_t r = 0;
+        for (int b = 0; b < bits; ++b) {
+            if (i & (1 << b)) r |= 1u << (bits - 1 - b);
+        }
+        bitrev_[i] = r;
+    }
+
+    // 2. Radix-4 stage twiddles: for sub-DFT size L, k∈[0,L): w = e^{-2πik/4L}, w², w³
+    for (int L = (bits & 1) ? 2 : 1; L < M; L *= 4) {
+        for (int k = 0; k < L; ++k) {
+            double a = -2.0 * kPi * k / (4.0 * L);
+            stageTw_.push_back(static_cast<float>(std::cos(a)));
+            stageTw_.push_back(static_cast<float>(std::sin(a)));
+            stageTw_.push_back(static_cast<float>(std::cos(2.0 * a)));
+            stageTw_.push_back(static_cast<float>(std::sin(2.0 * a)));
+            stageTw_.push_back(static_cast<float>(std::cos(3.0 * a)));
+            stageTw_.push_back(static_cast<float>(std::sin(3.0 * a)));
+        }
+    }
+
+    // 3. Real split twiddles e^{-2πik/N}, k∈[0, M/2]; the upper half follows from symmetry
+    splitTw_.resize(2 * (M / 2 + 1));
+    for (int k = 0; k <= M / 2; ++k) {
+        double a = -2.0 * kPi * k / size_;
+        splitTw_[2 * k] = static_cast<float>(std::cos(a));
+        splitTw_[2 * k + 1] = static_cast<float>(std::sin(a));
+    }
+
+    work_.resize(2 * M);
+    re_.resize(numBins());
+    im_.resize(numBins());
+}
+
+void RealFft::complexForward() {
+    const int M = half_;
+    float* z = work_.data();
+    int L = 1;
+
+    // Odd log2(M): one radix-2 stage first so the rest is pure radix-4
+    if (log2Int(M) & 1) {
+        for (int s = 0; s < M; s += 2) {
+            float ar = z[2 * s], ai = z[2 * s + 1];
+            float br = z[2 * s + 2], bi = z[2 * s + 3];
+            z[2 * s] = ar + br;     z[2 * s + 1] = ai + bi;
+            z[2 * s + 2] = ar - br; z[2 * s + 3] = ai - bi;
+        }
+        L = 2;
+    }
+
+    // Radix-4 (two merged radix-2 DIT stages): four size-L DFTs A,B,C,D → one size-4L DFT
+    const float* tw = stageTw_.data();
+    for (; L < M; L *= 4) {
+        const int span = 4 * L;
+        for (int s = 0; s < M; s += span) {
+            for (int k = 0; k < L; ++k) {
+                const float* t = tw + 6 * k;
+                float* p0 = z + 2 * (s + k);
+                float* p1 = p0 + 2 * L;
+                float* p2 = p1 + 2 * L;
+                float* p3 = p2 + 2 * L;
+
+                float ar = p0[0], ai = p0[1];
+                // b = w²·B, c = w·C, d = w³·D
+                float br = p1[0] * t[2] - p1[1] * t[3], bi = p1[0] * t[3] + p1[1] * t[2];
+                float cr = p2[0] * t[0] - p2[1] * t[1], ci = p2[0] * t[1] + p2[1] * t[0];
+                float dr = p3[0] * t[4] - p3[1] * t[5], di = p3[0] * t[5] + p3[1] * t[4];
+
+                float e0r = ar + br, e0i = ai + bi;
+                float e1r = ar - br, e1i = ai - bi;
+                float s0r = cr + dr, s0i = ci + di;
+                float s1r = cr - dr, s1i = ci - di;
+
+                p0[0] = e0r + s0r; p0[1] = e0i + s0i;
+                p2[0] = e0r - s0r; p2[1] = e0i - s0i;
+                // X1 = E1 - i·(c-d), X3 = E1 + i·(c-d)
+                p1[0] = e1r + s1i; p1[1] = e1i - s1r;
+                p3[0] = e1r - s1i; p3[1] = e1i + s1r;
+            }
+        }
+        tw += 6 * L;
+    }
+}
+
+void RealFft::forward(const float* in, float* outRe, float* outIm) {
+    const int M = half_;
+
+    // Pack even/odd samples as z[n] = x[2n] + i·x[2n+1], in bit-reversed order
+    for (int n = 0; n < M; ++n) {
+        uint32_t r = bitrev_[n];
+        work_[2 * r] = in[2 * n];
+        work_[2 * r + 1] = in[2 * n + 1];
+    }
+    complexForward();
+
+    // Split: X[k] = Fe + W^k·Fo, Fe = (Z[k] + Z*[M-k]) / 2, Fo = -i·(Z[k] - Z*[M-k]) / 2
+    const float* z = work_.data();
+    for (int k = 0; k <= M; ++k) {
+        int i0 = (k == M) ? 0 : k;
+        int i1 = (k == 0) ? 0 : M - k;
+        float zr = z[2 * i0], zi = z[2 * i0 + 1];
+        float cr = z[2 * i1], ci = -z[2 * i1 + 1];
+
+        float fer = 0.5f * (zr + cr), fei = 0.5f * (zi + ci);
+        float dr = zr - cr, di = zi - ci;
+        float for_ = 0.5f * di, foi = -0.5f * dr;
+
+        float wr, wi;
+        if (k <= M / 2) {
+            wr = splitTw_[2 * k];
+            wi = splitTw_[2 * k + 1];
+        } else {
+            // W^k = -conj(W^{M-k})
+            wr = -splitTw_[2 * (M - k)];
+            wi = splitTw_[2 * (M - k) + 1];
+        }
+        outRe[k] = fer + wr * for_ - wi * foi;
+        outIm[k] = fei + wr * foi + wi * for_;
+    }
+}
+
+void RealFft::magnitudeSpectrum(const float* in, float* outMag) {
+    forward(in, re_.data(), im_.data());
+    for (int k = 0; k < numBins(); ++k) {
+        outMag[k] = std::sqrt(re_[k] * re_[k] + im_[k] * im_[k]);
+    }
+}
+
+void RealFft::powerSpectrum(const float* in, float* outPower) {
+    forward(in, re_.data(), im_.data());
+    for (int k = 0; k < numBins(); ++k) {
+        outPower[k] = re_[k] * re_[k] + im_[k] * im_[k];
+    }
+}
+
+}  // namespace silenceguard
@@ -0,0 +1,48 @@
+// SilenceGuard Pro — 实数输入 FFT (替代 O(N²) DFT)
+// 打包实数 FFT：N 点实序列 → N/2 点复数 FFT (radix-4，奇数级时补一级 radix-2) → 后处理拆分
+// 旋转因子与位反转表在构造时计算，工作区预分配，forward 路径无堆分配、无三角函数调用
+
+#ifndef SILENCEGUARD_REALFFT_H
+#define SILENCEGUARD_REALFFT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace silenceguard {
+
+class RealFft {
+ public:
+  /** size 须为 2 的幂 (>= 8)，否则向上取整到 2 的幂 */
+  explicit RealFft(int size);
+
+  int size() const { return size_; }
+  /** 单边谱 bin 数：size/2 + 1 */
+  int numBins() const { return size_ / 2 + 1; }
+
+  /** in: size() 个实数样本；outRe/outIm: 各 numBins() 个 */
+  void forward(const float* in, float* outRe, float* outIm);
+
+  /** |X[k]|，写入 numBins() 个 */
+  void magnitudeSpectrum(const float* in, float* outMag);
+
+  /** |X[k]|²，写入 numBins() 个 */
+  void powerSpectrum(const float* in, float* outPower);
+
+ private:
+  // N/2 点复数 FFT，原地作用于 work_ (交错 re/im)
+  void complexForward();
+
+  int size_;
+  int half_;                        // 复数 FFT 点数 M = N/2
+  std::vector<uint32_t> bitrev_;    // M 点位反转索引
+  std::vector<float> stageTw_;      // radix-4 各级 w, w², w³ (交错 re/im)
+  std::vector<float> splitTw_;      // 实数拆分 e^{-2πik/N}, k∈[0, M/2]
+  std::vector<float> work_;         // 2*M 交错复数工作区
+  std::vector<float> re_;           // forward 输出暂存 (numBins)
+  std::vector<float> im_;
+};
+
+}  // namespace silenceguard
+
+#endif  // SILENCEGUARD_REALFFT_H
@@ -0,0 +1,93 @@
+// SilenceGuard Pro — 流式 Mel 提取器
+
+#include "StreamingMelExtractor.h"
+#include <algorithm>
+#include <cstring>
+
+namespace silenceguard {
+
+namespace {
+// Samples carried over after each frame: window overlap (400 - 160)
+constexpr size_t kOverlapSamples = kWindowSamples - kHopSamples;
+}
+
+StreamingMelExtractor::StreamingMelExtractor()
+    : pending_(kWindowSamples, 0.0f),
+      mel_(static_cast<size_t>(kMaxFrames) * kMelBins, 0.0f) {}
+
+void StreamingMelExtractor::reset() {
+    prevSample_ = 0.0f;
+    pendingCount_ = 0;
+    head_ = 0;
+    totalFrames_ = 0;
+}
+
+int StreamingMelExtractor::push(const int16_t* pcm, size_t frames) {
+    if (!pcm || frames == 0) return 0;
+
+    int produced = 0;
+    size_t pos = 0;
+    while (pos < frames) {
+        // 1. Pre-emphasis into the pending window until it holds kWindowSamples
+        size_t n = std::min(frames - pos, kWindowSamples - pendingCount_);
+        float* dst = pending_.data() + pendingCount_;
+        float prev = prevSample_;
+        for (size_t i = 0; i < n; ++i) {
+            float curr = static_cast<float>(pcm[pos + i]);
+            dst[i] = curr - kPreEmphasisCoeff * prev;
+            prev = curr;
+        }
+        prevSample_ = prev;
+        pendingCount_ += n;
+        pos += n;
+
+        if (pendingCount_ < static_cast<size_t>(kWindowSamples)) break;
+
+        // 2. One new hop: compute its row, then keep the 240-sample overlap
+        kernel_.compute(pending_.data(), mel_.data() + head_ * kMelBins);
+        head_ = (head_ + 1) % kMaxFrames;
+        ++totalFrames_;
+        ++produced;
+
+        std::memmove(pending_.data(), pending_.data() + kHopSamples, kOverlapSamples * sizeof(float));
+        pendingCount_ = kOverlapSamples;
+    }
+    return produced;
+}
+
+int StreamingMelExtractor::availableFrames() const {
+    return static_cast<int>(std::min<uint64_t>(totalFrames_, kMaxFrames));
+}
+
+int StreamingMelExtractor::copyLatest(float* out, int frames) const {
+    if (!out) return 0;
+    MelRows first, second;
+    frames = latestRows(frames, &first, &second);
+    if (frames == 0) return 0;
+    std::memcpy(out, first.data, first.frames * kMelBins * sizeof(float));
+    if (second.frames > 0) {
+        std::memcpy(out + first.frames * kMelBins, second.data, second.frames * kMelBins * sizeof(float));
+    }
+    return frames;
+}
+
+int StreamingMelExtractor::latestRows(int frames, MelRows* first, MelRows* second) const {
+    frames = std::min(frames, availableFrames());
+    return rowsAt(totalFrames_ - std::max(frames, 0), frames, first, second);
+}
+
+int StreamingMelExtractor::rowsAt(uint64_t firstFrame, int frames, MelRows* first, MelRows* second) const {
+    *first = MelRows{};
+    *second = MelRows{};
+    const uint64_t oldest = totalFrames_ - static_cast<uint64_t>(availableFrames());
+    if (frames <= 0 || firstFrame < oldest || firstFrame + frames > totalFrames_) return 0;
+
+    // Ring row of firstFrame, then at most two contiguous segments
+    size_t start = (head_ + kMaxFrames - static_cast<size_t>(totalFrames_ - firstFrame)) % kMaxFrames;
+    int head = static_cast<int>(std::min<size_t>(frames, kMaxFrames - start));
+    *first = {mel_.data() + start * kMelBins, head};
+    if (head < frames) *second = {mel_.data(), frames - head};
+    return frames;
+}
+
+}  // namespace silenceguard
@@ -0,0 +1,67 @@
+// SilenceGuard Pro — 流式 Mel 提取器
+// 跨 HAL 回调保存预加重状态、不足一帧的尾部样本与滚动 50×80 特征矩阵，
+// 每次 push 只计算新增的 10ms hop；任意 HAL 周期 (240/480/1024 帧…) 均可
+
+#ifndef SILENCEGUARD_STREAMINGMELEXTRACTOR_H
+#define SILENCEGUARD_STREAMINGMELEXTRACTOR_H
+
+#include "MelSpectrogram.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace silenceguard {
+
+/** 滚动矩阵中按时间顺序连续的若干行 [frames × kMelBins] */
+struct MelRows {
+  const float* data = nullptr;
+  int frames = 0;
+};
+
+class StreamingMelExtractor {
+ public:
+  StreamingMelExtractor();
+
+  /** 送入 16kHz mono PCM；返回本次新产生的 Mel 帧数 */
+  int push(const int16_t* pcm, size_t frames);
+
+  /** 清空全部流状态 (新会话 / 断流后) */
+  void reset();
+
+  /** 累计产生的 Mel 帧数 */
+  uint64_t totalFrames() const { return totalFrames_; }
+
+  /** 滚动矩阵中可用的帧数 (<= kMaxFrames) */
+  int availableFrames() const;
+
+  /**
+   * 按时间顺序拷贝最近 frames 帧 (<= availableFrames()) 到 out [frames × kMelBins]
+   * 返回实际拷贝帧数
+   */
+  int copyLatest(float* out, int frames) const;
+
+  /**
+   * 最近 frames 帧在滚动矩阵中的位置 (零拷贝)：至多两段，first 在前；second 可能为空
+   * 视图在下一次 push / reset 前有效；返回总帧数
+   */
+  int latestRows(int frames, MelRows* first, MelRows* second) const;
+
+  /**
+   * 从累计帧号 firstFrame 起的 frames 帧 (流式推理按块取新帧)；同样至多两段、零拷贝
+   * 任何一帧已滚出矩阵或尚未产生则返回 0
+   */
+  int rowsAt(uint64_t firstFrame, int frames, MelRows* first, MelRows* second) const;
+
+ private:
+  MelFrameKernel kernel_;
+  float prevSample_ = 0.0f;      // 预加重状态 x[n-1]
+  std::vector<float> pending_;   // 已预加重、尚未凑满一帧的样本 (kWindowSamples)
+  size_t pendingCount_ = 0;
+  std::vector<float> mel_;       // 滚动矩阵 kMaxFrames × kMelBins
+  size_t head_ = 0;              // 下一帧写入行
+  uint64_t totalFrames_ = 0;
+};
+
+}  // namespace silenceguard
+
+#endif  // SILENCEGUARD_STREAMINGMELEXTRACTOR_H
@@ -0,0 +1,129 @@
+// SilenceGuard Pro — 流式语音活动检测
+
+#include "VoiceActivityDetector.h"
+#include "MelSpectrogram.h"
+#include "RealFft.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace silenceguard {
+
+namespace {
+constexpr int kHistorySamples = VoiceActivityDetector::kSpectrumSize - kHopSamples;  // 96
+constexpr float kFloorRiseDb = 0.02f;    // 每 hop 上升 0.02 dB (2 dB/s)
+constexpr float kMinFloorDb = -100.0f;
+constexpr float kPowerEpsilon = 1e-10f;  // 数字静音的能量 / 功率谱下限
+constexpr float kPi = 3.14159265358979f;
+
+int msToHops(int ms) { return std::max(0, (ms + kHopMs - 1) / kHopMs); }
+}  // namespace
+
+VoiceActivityDetector::VoiceActivityDetector()
+    : fft_(new RealFft(kSpectrumSize)),
+      window_(kSpectrumSize, 0.0f),
+      hann_(kSpectrumSize),
+      frame_(kSpectrumSize),
+      power_(kSpectrumSize / 2 + 1),
+      floorDb_(options_.energyDb) {
+  for (int i = 0; i < kSpectrumSize; ++i) hann_[i] = 0.5f - 0.5f * std::cos(2.0f * kPi * i / kSpectrumSize);
+  hangoverHops_ = msToHops(options_.hangoverMs);
+}
+
+VoiceActivityDetector::~VoiceActivityDetector() = default;
+
+void VoiceActivityDetector::setOptions(const VadOptions& options) {
+  options_ = options;
+  hangoverHops_ = msToHops(options_.hangoverMs);
+  hold_ = std::min(hold_, hangoverHops_);
+}
+
+void VoiceActivityDetector::reset() {
+  std::fill(window_.begin(), window_.end(), 0.0f);
+  pending_ = 0;
+  lastSample_ = 0.0f;
+  floorDb_ = options_.energyDb;
+  onset_ = 0;
+  hold_ = 0;
+  open_ = false;
+}
+
+bool VoiceActivityDetector::process(const int16_t* pcm, size_t frames) {
+  if (!options_.enabled) return true;
+  bool wasOpen = open_;
+  size_t pos = 0;
+  while (pos < frames) {
+    const size_t n = std::min(frames - pos, static_cast<size_t>(kHopSamples) - pending_);
+    float* dst = window_.data() + kHistorySamples + pending_;
+    for (size_t i = 0; i < n; ++i) dst[i] = static_cast<float>(pcm[pos + i]) * (1.0f / 32768.0f);
+    pending_ += n;
+    pos += n;
+    if (pending_ < static_cast<size_t>(kHopSamples)) break;
+
+    const bool speech = classifyHop();
+    hops_.fetch_add(1, std::memory_order_relaxed);
+    if (speech) speech_hops_.fetch_add(1, std::memory_order_relaxed);
+    onset_ = speech ? onset_ + 1 : 0;
+    if (open_) {
+      if (speech) {
+        hold_ = hangoverHops_;
+      } else if (hold_ > 0) {
+        --hold_;
+      } else {
+        open_ = false;
+      }
+    } else if (onset_ >= kOnsetHops) {
+      open_ = true;
+      hold_ = hangoverHops_;
+      openings_.fetch_add(1, std::memory_order_relaxed);
+    }
+    wasOpen = wasOpen || open_;
+
+    std::memmove(window_.data(), window_.data() + kHopSamples, kHistorySamples * sizeof(float));
+    pending_ = 0;
+  }
+  return wasOpen;
+}
+
+// 新 hop 位于 window_ 尾部 kHopSamples 个样本；级联判决，廉价特征不通过时不做 FFT
+bool VoiceActivityDetector::classifyHop() {
+  const float* hop = window_.data() + kHistorySamples;
+  float energy = 0.0f;
+  int crossings = 0;
+  float prev = lastSample_;
+  for (int i = 0; i < kHopSamples; ++i) {
+    energy += hop[i] * hop[i];
+    crossings += (hop[i] >= 0.0f) != (prev >= 0.0f) ? 1 : 0;
+    prev = hop[i];
+  }
+  lastSample_ = prev;
+  const float energyDb = 10.0f * std::log10(energy / kHopSamples + kPowerEpsilon);
+
+  // 底噪最小值跟踪：语音的词间停顿足以把它拉回，持续的稳态背景会被逐渐抬升的底噪吸收
+  floorDb_ = energyDb < floorDb_ ? energyDb : floorDb_ + kFloorRiseDb;
+  floorDb_ = std::max(floorDb_, kMinFloorDb);
+  if (energyDb < std::max(options_.energyDb, floorDb_ + options_.marginDb)) return false;
+
+  // 过零率过低为直流 / 工频哼声 / 低频轰鸣；落在语音区间即判语音，
+  // 偏高时 (清辅音或噪声) 须频谱足够 "不平" 才算，宽带噪声在此被拒
+  const float zcr = static_cast<float>(crossings) / kHopSamples;
+  if (zcr < options_.zcrMin) return false;
+  if (zcr <= options_.zcrMax) return true;
+  return spectralFlatness() <= options_.flatnessMax;
+}
+
+// 几何均值 / 算术均值 (不含直流)：白噪声 ≈ 0.56，纯音 / 浊音 → 0
+float VoiceActivityDetector::spectralFlatness() {
+  for (int i = 0; i < kSpectrumSize; ++i) frame_[i] = window_[i] * hann_[i];
+  fft_->powerSpectrum(frame_.data(), power_.data());
+  const int bins = kSpectrumSize / 2;
+  float logSum = 0.0f, sum = 0.0f;
+  for (int k = 1; k <= bins; ++k) {
+    const float p = power_[k] + kPowerEpsilon;
+    logSum += std::log(p);
+    sum += p;
+  }
+  return std::exp(logSum / bins) / (sum / bins);
+}
+
+}  // namespace silenceguard
@@ -0,0 +1,90 @@
+// SilenceGuard Pro — 流式语音活动检测 (VAD 门控)
+// 逐 10ms hop 计算能量、过零率与谱平坦度：能量先筛 (低于绝对下限或自适应底噪 + 余量即判非语音)，
+// 通过后才做 256 点 FFT 求平坦度；连续 kOnsetHops 个语音帧开门，最后一个语音帧后保持 hangover
+// 门关闭期间引擎跳过 Mel 提取与推理；只在分析线程使用，计数器可在任意线程读取
+
+#ifndef SILENCEGUARD_VOICEACTIVITYDETECTOR_H
+#define SILENCEGUARD_VOICEACTIVITYDETECTOR_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace silenceguard {
+
+/** UPDATE_CONFIG "vad": {...} */
+struct VadOptions {
+  bool enabled = true;
+  float energyDb = -55.0f;    // 绝对能量下限 (dBFS)
+  float marginDb = 10.0f;     // 高于跟踪底噪的余量 (dB)：稳态背景噪声 / 音乐逐渐被门控
+  float zcrMin = 0.01f;       // 语音过零率区间 (次 / 样本)：低于下限为哼声 / 轰鸣
+  float zcrMax = 0.35f;
+  float flatnessMax = 0.30f;  // 过零率高于上限时的谱平坦度上限 (白噪声 ≈0.56)
+  int hangoverMs = 300;       // 最后一个语音帧后保持开门
+  int preRollMs = 300;        // 开门时从环形缓冲回补的历史音频 (补上起始辅音)
+
+  bool operator==(const VadOptions& o) const {
+    return enabled == o.enabled && energyDb == o.energyDb && marginDb == o.marginDb && zcrMin == o.zcrMin &&
+           zcrMax == o.zcrMax && flatnessMax == o.flatnessMax && hangoverMs == o.hangoverMs &&
+           preRollMs == o.preRollMs;
+  }
+  bool operator!=(const VadOptions& o) const { return !(*this == o); }
+};
+
+class RealFft;
+
+class VoiceActivityDetector {
+ public:
+  static constexpr int kOnsetHops = 2;        // 20ms：单个脉冲 / 爆音不开门
+  static constexpr int kSpectrumSize = 256;   // 平坦度 FFT 点数 (16ms @ 16kHz)
+
+  VoiceActivityDetector();
+  ~VoiceActivityDetector();
+
+  /** 新阈值下一个 hop 生效；门状态与底噪保留 */
+  void setOptions(const VadOptions& options);
+  const VadOptions& options() const { return options_; }
+
+  /**
+   * 送入 16kHz mono PCM，逐 hop 更新门状态 (不足一个 hop 的尾部留到下次)
+   * 返回本块内门是否开过 (开着进入或中途打开)；未启用时恒为 true
+   */
+  bool process(const int16_t* pcm, size_t frames);
+
+  bool isOpen() const { return open_; }
+
+  /** 清空流状态 (门关闭、底噪重新跟踪)；计数器保持累计 */
+  void reset();
+
+  /** 已判决的 hop 数 / 其中判为语音的 hop 数 / 开门次数 */
+  uint64_t hops() const { return hops_.load(std::memory_order_relaxed); }
+  uint64_t speechHops() const { return speech_hops_.load(std::memory_order_relaxed); }
+  uint64_t openings() const { return openings_.load(std::memory_order_relaxed); }
+
+ private:
+  bool classifyHop();
+  float spectralFlatness();
+
+  VadOptions options_;
+  int hangoverHops_ = 0;
+  std::unique_ptr<RealFft> fft_;
+  std::vector<float> window_;    // 最近 kSpectrumSize 个样本 (归一化到 ±1)，新 hop 追加在尾部
+  std::vector<float> hann_;
+  std::vector<float> frame_;     // 加窗后的 FFT 输入
+  std::vector<float> power_;
+  size_t pending_ = 0;           // window_ 尾部尚未凑满一个 hop 的样本数
+  float lastSample_ = 0.0f;      // 跨 hop 的过零判断
+  float floorDb_;                // 跟踪底噪：遇到更低能量立即下降，否则缓慢上升
+  int onset_ = 0;                // 连续语音 hop 数
+  int hold_ = 0;                 // 剩余 hangover hop 数
+  bool open_ = false;
+  std::atomic<uint64_t> hops_{0};
+  std::atomic<uint64_t> speech_hops_{0};
+  std::atomic<uint64_t> openings_{0};
+};
+
+}  // namespace silenceguard
+
+#endif  // SILENCEGUARD_VOICEACTIVITYDETECTOR_H
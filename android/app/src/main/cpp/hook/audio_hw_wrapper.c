@@ -10,12 +10,27 @@ extern void* ProtectionEngine_getInstance(void);
 extern void ProtectionEngine_pushToBuffer(void* engine, const void* buffer, size_t bytes);
 extern int ProtectionEngine_shouldIntercept(void* engine);
 extern void ProtectionEngine_setTestInterceptEnabled(void* engine, int enabled);
+extern void ProtectionEngine_processLookahead(void* engine, int16_t* buffer, size_t frames);
+extern void ProtectionEngine_sessionPushToBuffer(void* session, const void* buffer, size_t bytes);
+extern void ProtectionEngine_sessionProcessLookahead(void* session, void* buffer, size_t bytes);
+extern int ProtectionEngine_sessionShouldIntercept(void* session);
+extern void ProtectionEngine_sessionApplyBeep(void* session, void* buffer, size_t bytes);
+extern void* ProtectionEngine_getDefaultSession(void* engine);
+extern void ProtectionEngine_sessionSetToneSampleRate(void* session, int sampleRate);
 extern void AudioInjector_applyBeep(int16_t* buffer, size_t frames);
 extern void AudioInjector_processWithRingBuffer(int16_t* buffer, size_t frames, size_t crossFadeFrames);
+extern void AudioInjector_setToneSampleRate(int sampleRate);
 
 // 占位：原始 HAL in_read 的签名（实际由厂商 audio.primary 实现）
 // static ssize_t original_in_read(struct audio_stream_in* stream, void* buffer, size_t bytes);
 
+// 代理 open_input_stream 成功后调用：哔声振荡器 (含默认会话延迟线的掩蔽哔声) 按 HAL 实际采样率 (config->sample_rate) 生成
+void silenceguard_on_stream_open(uint32_t sampleRate) {
+    AudioInjector_setToneSampleRate((int)sampleRate);
+    ProtectionEngine_sessionSetToneSampleRate(ProtectionEngine_getDefaultSession(ProtectionEngine_getInstance()),
+                                              (int)sampleRate);
+}
+
 // 代理 in_read：数据进入直播 App 前在此劫持
 // 1. 调用原始 HAL 读取麦克风
 // 2. 送入 ProtectionEngine 分析
@@ -33,18 +48,36 @@ ssize_t silenceguard_in_read_proxy(void* engine, void* buffer, size_t bytes) {
     // 为了 POC，我们将 buffer 视为有效数据直接处理
     ssize_t ret = bytes; // 假设读取成功
     
-    // 步骤 2: 将数据送入分析引擎 (非阻塞，零拷贝)
+    // 步骤 2: 将数据送入分析引擎 (异步模式下仅拷入 SPSC 队列，Mel/TFLite 在分析线程执行)
     ProtectionEngine_pushToBuffer(engine, buffer, (size_t)ret);
     
-    // 步骤 3: 检查是否有阻断指令
+    // 步骤 3 (Phase 3 时间机器): 前视延迟线——输出延后 lookahead_ms，
+    // 分析线程登记的拦截区间在音频送出前回溯掩蔽 (交叉淡入/淡出)；lookahead_ms = 0 时直通
+    ProtectionEngine_processLookahead(engine, (int16_t*)buffer, (size_t)ret / sizeof(int16_t));
+    
+    // 步骤 4: 检查是否有阻断指令 (原子读取，不持锁；无延迟线时的即时拦截与 POC 测试拦截)
     // Phase 2: 由 TFLite + 变体匹配结果驱动 shouldIntercept
     // Phase 1 POC: 由 setTestInterceptEnabled 强制驱动
     if (ProtectionEngine_shouldIntercept(engine)) {
         size_t frames = (size_t)ret / sizeof(int16_t);
-        // 执行实时篡改：写入哔声
-        // 在 Phase 3 中，这里会改为 AudioInjector_processWithRingBuffer 调用以实现回溯平滑
+        // 执行实时篡改：写入哔声 (回溯平滑由步骤 3 的延迟线完成)
         AudioInjector_applyBeep((int16_t*)buffer, frames);
     }
     
     return ret;
 }
+
+// 多路采集：每个代理的输入流在 open_input_stream 时以 config 的采样率 / 声道数 / 格式
+// ProtectionEngine_openSessionWithFormat 得到自己的会话 (48kHz 立体声等原生格式，分析侧自动下混 + 重采样)，
+// in_read 走会话接口，buffer 保持原生格式；各流的缓冲 / 掩蔽 / 拦截状态与哔声振荡器互不干扰 (流程同上)
+ssize_t silenceguard_session_read_proxy(void* session, void* buffer, size_t bytes) {
+    if (!session || !buffer) return -1;
+    ssize_t ret = bytes;
+
+    ProtectionEngine_sessionPushToBuffer(session, buffer, (size_t)ret);
+    ProtectionEngine_sessionProcessLookahead(session, buffer, (size_t)ret);
+    if (ProtectionEngine_sessionShouldIntercept(session)) {
+        ProtectionEngine_sessionApplyBeep(session, buffer, (size_t)ret);
+    }
+    return ret;
+}
@@ -1,6 +1,14 @@
 #include "ConfMatrix.h"
+#include "EditDistance.h"
+#include "KeywordGraph.h"
+#include "PhonemeDtw.h"
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <cstdio>
+#include <cstring>
 #include <fstream>
-#include <iostream>
 #include <sstream>
 #include <vector>
 #include <string>
@@ -11,126 +19,397 @@
 namespace silenceguard {
 
 namespace {
-// Simple manual JSON parser for structure: {"key": ["v1", "v2"], ...}
-// Avoids huge dependencies like jsoncpp for this specific use case.
-std::unordered_map<std::string, std::vector<std::string>> g_conf_matrix;
-
-std::string trim(const std::string& str) {
-    size_t first = str.find_first_not_of(" \t\n\r\"");
-    if (std::string::npos == first) return str;
-    size_t last = str.find_last_not_of(" \t\n\r\"");
-    return str.substr(first, (last - first + 1));
-}
-
-void parseJson(const std::string& json) {
-    g_conf_matrix.clear();
-    size_t pos = 0;
-    while (pos < json.length()) {
-        // Find key
-        size_t keyStart = json.find('"', pos);
-        if (keyStart == std::string::npos) break;
-        size_t keyEnd = json.find('"', keyStart + 1);
-        if (keyEnd == std::string::npos) break;
-        
-        std::string key = json.substr(keyStart + 1, keyEnd - keyStart - 1);
-        
-        // Find array start
-        size_t arrayStart = json.find('[', keyEnd);
-        if (arrayStart == std::string::npos) break;
-        
-        // Find array end
-        size_t arrayEnd = json.find(']', arrayStart);
-        if (arrayEnd == std::string::npos) break;
-        
-        // Parse array elements
-        std::vector<std::string> values;
-        size_t valStart = arrayStart + 1;
-        while (valStart < arrayEnd) {
-            size_t vStart = json.find('"', valStart);
-            if (vStart == std::string::npos || vStart > arrayEnd) break;
-            size_t vEnd = json.find('"', vStart + 1);
-            if (vEnd == std::string::npos) break;
-            values.push_back(json.substr(vStart + 1, vEnd - vStart - 1));
-            valStart = vEnd + 1;
-        }
-        g_conf_matrix[key] = values;
-        pos = arrayEnd + 1;
+
+constexpr char kMagic[4] = {'S', 'G', 'C', 'M'};
+constexpr uint32_t kVersion = 1;
+constexpr uint32_t kByteOrder = 0x01020304u;  // 按本机字节序写入；读到其他值即字节序不符
+constexpr uint32_t kMaxEntries = 1u << 24;    // 段长度上限，防止损坏文件头导致的溢出
+
+struct FileHeader {
+    char magic[4];
+    uint32_t version;
+    uint32_t byteOrder;
+    uint32_t phonemes;
+    uint32_t variants;
+    uint32_t hashSlots;
+    uint32_t nameBytes;
+    uint32_t reserved;
+};
+static_assert(sizeof(FileHeader) == 32, "binary layout");
+
+uint32_t fnv1a(const char* s) {
+    uint32_t h = 2166136261u;
+    for (; *s; ++s) h = (h ^ static_cast<unsigned char>(*s)) * 16777619u;
+    return h;
+}
+
+// 各段总字节数；超限返回 0
+uint64_t imageSize(uint64_t phonemes, uint64_t variants, uint64_t hashSlots, uint64_t nameBytes) {
+    if (phonemes > kMaxEntries || variants > kMaxEntries || hashSlots > 2 * uint64_t{kMaxEntries} ||
+        nameBytes > 64 * uint64_t{kMaxEntries}) {
+        return 0;
     }
+    return sizeof(FileHeader) + 4 * (phonemes + (phonemes + 1) + variants + hashSlots) + nameBytes;
 }
 
-// Levenshtein Distance
-int editDistance(const std::string& s1, const std::string& s2) {
-    const size_t m = s1.length();
-    const size_t n = s2.length();
-    if (m == 0) return n;
-    if (n == 0) return m;
+// 最小 JSON 读取器，只接受 {"key": ["v1", "v2"], ...}；支持转义与 \uXXXX
+class JsonReader {
+ public:
+    explicit JsonReader(const std::string& s) : s_(s) {}
+
+    bool consume(char c) {
+        skipSpace();
+        if (pos_ >= s_.size() || s_[pos_] != c) return false;
+        ++pos_;
+        return true;
+    }
 
-    std::vector<std::vector<int>> dp(m + 1, std::vector<int>(n + 1));
+    bool peek(char c) {
+        skipSpace();
+        return pos_ < s_.size() && s_[pos_] == c;
+    }
 
-    for (size_t i = 0; i <= m; ++i) dp[i][0] = i;
-    for (size_t j = 0; j <= n; ++j) dp[0][j] = j;
+    bool atEnd() {
+        skipSpace();
+        return pos_ == s_.size();
+    }
 
-    for (size_t i = 1; i <= m; ++i) {
-        for (size_t j = 1; j <= n; ++j) {
-            int cost = (s1[i - 1] == s2[j - 1]) ? 0 : 1;
-            dp[i][j] = std::min({
-                dp[i - 1][j] + 1,      // deletion
-                dp[i][j - 1] + 1,      // insertion
-                dp[i - 1][j - 1] + cost // substitution
-            });
+    bool string(std::string* out) {
+        if (!consume('"')) return false;
+        out->clear();
+        while (pos_ < s_.size()) {
+            const char c = s_[pos_++];
+            if (c == '"') return true;
+            if (c != '\\') {
+                out->push_back(c);
+                continue;
+            }
+            if (pos_ >= s_.size()) return false;
+            const char e = s_[pos_++];
+            switch (e) {
+                case '"': case '\\': case '/': out->push_back(e); break;
+                case 'b': out->push_back('\b'); break;
+                case 'f': out->push_back('\f'); break;
+                case 'n': out->push_back('\n'); break;
+                case 'r': out->push_back('\r'); break;
+                case 't': out->push_back('\t'); break;
+                case 'u': {
+                    if (pos_ + 4 > s_.size()) return false;
+                    unsigned cp = 0;
+                    for (int k = 0; k < 4; ++k) {
+                        const char h = s_[pos_++];
+                        cp <<= 4;
+                        if (h >= '0' && h <= '9') cp |= static_cast<unsigned>(h - '0');
+                        else if (h >= 'a' && h <= 'f') cp |= static_cast<unsigned>(h - 'a' + 10);
+                        else if (h >= 'A' && h <= 'F') cp |= static_cast<unsigned>(h - 'A' + 10);
+                        else return false;
+                    }
+                    if (cp == 0) return false;  // 名字以 NUL 结尾存放
+                    if (cp < 0x80) {
+                        out->push_back(static_cast<char>(cp));
+                    } else if (cp < 0x800) {
+                        out->push_back(static_cast<char>(0xC0 | (cp >> 6)));
+                        out->push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+                    } else {
+                        out->push_back(static_cast<char>(0xE0 | (cp >> 12)));
+                        out->push_back(static_cast<char>(0x80 | ((cp >> 6) & 0x3F)));
+                        out->push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+                    }
+                    break;
+                }
+                default: return false;
+            }
         }
+        return false;
+    }
+
+ private:
+    void skipSpace() {
+        while (pos_ < s_.size() && (s_[pos_] == ' ' || s_[pos_] == '\t' || s_[pos_] == '\n' || s_[pos_] == '\r'))
+            ++pos_;
     }
-    return dp[m][n];
+
+    const std::string& s_;
+    size_t pos_ = 0;
+};
+
+// 当前快照 (std::atomic_load / atomic_store 发布)
+std::shared_ptr<const CompiledConfMatrix> g_current;
+
+bool hasMagic(const char* path) {
+    char head[sizeof(kMagic)] = {};
+    FILE* f = fopen(path, "rb");
+    if (!f) return false;
+    const size_t n = fread(head, 1, sizeof(head), f);
+    fclose(f);
+    return n == sizeof(head) && memcmp(head, kMagic, sizeof(head)) == 0;
 }
 
 } // namespace
 
-bool loadConfMatrix(const char* path) {
-    if (!path) return false;
+// ---------------------------------------------------------
+// CompiledConfMatrix
+// ---------------------------------------------------------
+
+CompiledConfMatrix::~CompiledConfMatrix() {
+    if (mapped_) munmap(mapped_, mappedBytes_);
+}
+
+std::shared_ptr<const CompiledConfMatrix> CompiledConfMatrix::fromJson(const std::string& json) {
+    // 解析：名字按首次出现的顺序驻留为 id；重复的 key 以最后一次为准
+    std::vector<std::string> names;
+    std::unordered_map<std::string, uint32_t> ids;
+    std::vector<std::vector<uint32_t>> rows;
+    auto intern = [&](const std::string& name) {
+        auto it = ids.emplace(name, static_cast<uint32_t>(names.size()));
+        if (it.second) {
+            names.push_back(name);
+            rows.emplace_back();
+        }
+        return it.first->second;
+    };
+
+    JsonReader in(json);
+    if (!in.consume('{')) return nullptr;
+    std::string key, value;
+    if (!in.peek('}')) {
+        do {
+            if (!in.string(&key) || !in.consume(':') || !in.consume('[')) return nullptr;
+            std::vector<uint32_t> row;
+            if (!in.peek(']')) {
+                do {
+                    if (!in.string(&value)) return nullptr;
+                    row.push_back(intern(value));
+                } while (in.consume(','));
+            }
+            if (!in.consume(']')) return nullptr;
+            rows[intern(key)] = std::move(row);
+        } while (in.consume(','));
+    }
+    if (!in.consume('}') || !in.atEnd()) return nullptr;
+
+    // 编译为文件映像
+    const uint32_t phonemes = static_cast<uint32_t>(names.size());
+    uint64_t variantCount = 0, nameBytes = 0;
+    for (const auto& row : rows) variantCount += row.size();
+    for (const auto& n : names) nameBytes += n.size() + 1;
+    if (nameBytes == 0) nameBytes = 1;  // 名字区至少一个 NUL，校验末字节用
+    uint32_t hashSlots = 1;
+    while (hashSlots < 2 * phonemes) hashSlots <<= 1;
+    const uint64_t bytes = imageSize(phonemes, variantCount, hashSlots, nameBytes);
+    if (bytes == 0) return nullptr;
+
+    std::shared_ptr<CompiledConfMatrix> cm(new CompiledConfMatrix());
+    cm->owned_.assign(static_cast<size_t>((bytes + 3) / 4), 0u);
+    uint8_t* image = reinterpret_cast<uint8_t*>(cm->owned_.data());
+    FileHeader header{};
+    memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.version = kVersion;
+    header.byteOrder = kByteOrder;
+    header.phonemes = phonemes;
+    header.variants = static_cast<uint32_t>(variantCount);
+    header.hashSlots = hashSlots;
+    header.nameBytes = static_cast<uint32_t>(nameBytes);
+    memcpy(image, &header, sizeof(header));
+
+    uint32_t* nameOffset = reinterpret_cast<uint32_t*>(image + sizeof(FileHeader));
+    uint32_t* rowStart = nameOffset + phonemes;
+    uint32_t* variants = rowStart + phonemes + 1;
+    uint32_t* hash = variants + variantCount;
+    char* nameArea = reinterpret_cast<char*>(hash + hashSlots);
+    uint32_t at = 0, v = 0;
+    for (uint32_t id = 0; id < phonemes; ++id) {
+        nameOffset[id] = at;
+        memcpy(nameArea + at, names[id].c_str(), names[id].size() + 1);
+        at += static_cast<uint32_t>(names[id].size() + 1);
+        rowStart[id] = v;
+        for (uint32_t var : rows[id]) variants[v++] = var;
+        for (uint32_t slot = fnv1a(names[id].c_str()) & (hashSlots - 1);; slot = (slot + 1) & (hashSlots - 1)) {
+            if (hash[slot] == 0) {
+                hash[slot] = id + 1;
+                break;
+            }
+        }
+    }
+    rowStart[phonemes] = v;
+    if (!cm->attach(image, static_cast<size_t>(bytes))) return nullptr;
+    return cm;
+}
+
+std::shared_ptr<const CompiledConfMatrix> CompiledConfMatrix::mapFile(const char* path) {
+    if (!path) return nullptr;
+    const int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return nullptr;
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size < static_cast<off_t>(sizeof(FileHeader))) {
+        close(fd);
+        return nullptr;
+    }
+    const size_t bytes = static_cast<size_t>(st.st_size);
+    void* data = mmap(nullptr, bytes, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);  // 映射不依赖文件描述符
+    if (data == MAP_FAILED) return nullptr;
+
+    std::shared_ptr<CompiledConfMatrix> cm(new CompiledConfMatrix());
+    cm->mapped_ = data;
+    cm->mappedBytes_ = bytes;
+    if (!cm->attach(static_cast<const uint8_t*>(data), bytes)) return nullptr;
+    return cm;
+}
+
+bool CompiledConfMatrix::attach(const uint8_t* data, size_t bytes) {
+    FileHeader header;
+    if (bytes < sizeof(header)) return false;
+    memcpy(&header, data, sizeof(header));
+    if (memcmp(header.magic, kMagic, sizeof(kMagic)) != 0 || header.version != kVersion ||
+        header.byteOrder != kByteOrder) {
+        return false;
+    }
+    if (header.hashSlots == 0 || (header.hashSlots & (header.hashSlots - 1)) != 0 ||
+        header.hashSlots <= header.phonemes || header.nameBytes == 0) {
+        return false;
+    }
+    const uint64_t expected = imageSize(header.phonemes, header.variants, header.hashSlots, header.nameBytes);
+    if (expected == 0 || expected > bytes) return false;
+
+    image_ = data;
+    imageBytes_ = static_cast<size_t>(expected);
+    phonemes_ = header.phonemes;
+    variantCount_ = header.variants;
+    hashSlots_ = header.hashSlots;
+    nameBytes_ = header.nameBytes;
+    nameOffset_ = reinterpret_cast<const uint32_t*>(data + sizeof(FileHeader));
+    rowStart_ = nameOffset_ + phonemes_;
+    variants_ = rowStart_ + phonemes_ + 1;
+    hash_ = variants_ + variantCount_;
+    names_ = reinterpret_cast<const char*>(hash_ + hashSlots_);
+    // 名字区以 NUL 收尾：任何界内偏移都读得到结尾
+    return names_[nameBytes_ - 1] == '\0' && rowStart_[0] == 0 && rowStart_[phonemes_] == variantCount_;
+}
+
+bool CompiledConfMatrix::writeFile(const char* path) const {
+    if (!path || !image_) return false;
+    const std::string tmp = std::string(path) + ".tmp";
+    FILE* f = fopen(tmp.c_str(), "wb");
+    if (!f) return false;
+    const bool ok = fwrite(image_, 1, imageBytes_, f) == imageBytes_;
+    if (fclose(f) != 0 || !ok || rename(tmp.c_str(), path) != 0) {
+        remove(tmp.c_str());
+        return false;
+    }
+    return true;
+}
+
+int CompiledConfMatrix::idOf(const char* name) const {
+    if (!name || phonemes_ == 0) return -1;
+    const uint32_t mask = hashSlots_ - 1;
+    uint32_t slot = fnv1a(name) & mask;
+    for (uint32_t probe = 0; probe < hashSlots_; ++probe, slot = (slot + 1) & mask) {
+        const uint32_t entry = hash_[slot];
+        if (entry == 0) return -1;
+        const char* candidate = this->name(static_cast<int>(entry - 1));
+        if (candidate && strcmp(candidate, name) == 0) return static_cast<int>(entry - 1);
+    }
+    return -1;
+}
+
+const char* CompiledConfMatrix::name(int id) const {
+    if (id < 0 || static_cast<uint32_t>(id) >= phonemes_) return nullptr;
+    const uint32_t offset = nameOffset_[id];
+    return offset < nameBytes_ ? names_ + offset : nullptr;
+}
+
+int CompiledConfMatrix::variants(int id, int32_t* out, int maxOut) const {
+    if (id < 0 || static_cast<uint32_t>(id) >= phonemes_ || !out || maxOut <= 0) return 0;
+    const uint32_t begin = rowStart_[id];
+    const uint32_t end = std::min(rowStart_[id + 1], variantCount_);
+    int count = 0;
+    for (uint32_t i = begin; i < end && count < maxOut; ++i) {
+        if (variants_[i] < phonemes_) out[count++] = static_cast<int32_t>(variants_[i]);
+    }
+    return count;
+}
+
+int CompiledConfMatrix::variantNames(int id, const char** out, int maxOut) const {
+    if (id < 0 || static_cast<uint32_t>(id) >= phonemes_ || !out || maxOut <= 0) return 0;
+    const uint32_t begin = rowStart_[id];
+    const uint32_t end = std::min(rowStart_[id + 1], variantCount_);
+    int count = 0;
+    for (uint32_t i = begin; i < end && count < maxOut; ++i) {
+        const char* variant = variants_[i] < phonemes_ ? name(static_cast<int>(variants_[i])) : nullptr;
+        if (variant) out[count++] = variant;
+    }
+    return count;
+}
+
+// ---------------------------------------------------------
+// 加载与发布
+// ---------------------------------------------------------
+
+std::shared_ptr<const CompiledConfMatrix> currentConfMatrix() {
+    return std::atomic_load(&g_current);
+}
+
+namespace {
+
+std::shared_ptr<const CompiledConfMatrix> readJsonFile(const char* path) {
     std::ifstream file(path);
-    if (!file.is_open()) return false;
-    
+    if (!file.is_open()) return nullptr;
     std::stringstream buffer;
     buffer << file.rdbuf();
-    parseJson(buffer.str());
-    return !g_conf_matrix.empty();
+    return CompiledConfMatrix::fromJson(buffer.str());
+}
+
+}  // namespace
+
+bool loadConfMatrix(const char* path) {
+    if (!path) return false;
+    std::shared_ptr<const CompiledConfMatrix> cm =
+        hasMagic(path) ? CompiledConfMatrix::mapFile(path) : readJsonFile(path);
+    if (!cm || cm->size() == 0) return false;
+    std::atomic_store(&g_current, cm);
+    return true;
 }
 
-int getPhonemeVariants(const char* target, const char** outVariants, int maxOut) {
-    if (!target || !outVariants || maxOut <= 0) return 0;
-    
-    std::string key(target);
-    if (g_conf_matrix.find(key) == g_conf_matrix.end()) return 0;
-    
-    const auto& vars = g_conf_matrix[key];
+bool compileConfMatrix(const char* jsonPath, const char* binaryPath) {
+    if (!jsonPath || !binaryPath) return false;
+    std::shared_ptr<const CompiledConfMatrix> cm = readJsonFile(jsonPath);
+    return cm && cm->writeFile(binaryPath);
+}
+
+int getPhonemeVariants(const char* target, char* nameBuf, size_t bufBytes, const char** outVariants, int maxOut) {
+    if (!target || !nameBuf || !outVariants || maxOut <= 0) return 0;
+    const std::shared_ptr<const CompiledConfMatrix> cm = currentConfMatrix();
+    if (!cm) return 0;
+    // 先取名字区指针，再逐个拷入 nameBuf 并改指向拷贝 (快照释放后调用方仍可用)
+    const int n = cm->variantNames(cm->idOf(target), outVariants, maxOut);
+    size_t used = 0;
     int count = 0;
-    for (const auto& v : vars) {
-        if (count >= maxOut) break;
-        // WARNING: Returning internal string c_str() requires map to outlive usage
-        // For static usage this is acceptable, but be careful with threads
-        outVariants[count++] = v.c_str(); 
+    for (; count < n; ++count) {
+        const size_t bytes = strlen(outVariants[count]) + 1;
+        if (bytes > bufBytes - used) break;
+        memcpy(nameBuf + used, outVariants[count], bytes);
+        outVariants[count] = nameBuf + used;
+        used += bytes;
     }
     return count;
 }
 
-// Placeholder for Phase 2: Currently assumes input is already phoneme strings
-// Real implementation would decode posteriors to phonemes first.
+// Posteriorgram DTW over the default phoneme unit table (see PhonemeDtw.h)
 float calculatePhonemeSimilarity(const float* posteriorsA, int lenA,
                                 const float* posteriorsB, int lenB) {
-    // Stub: Treat pointer address as string data for now to compile
-    // In real implementation: Decode argmax(posteriors) -> phoneme string
-    (void)posteriorsA; (void)lenA; (void)posteriorsB; (void)lenB;
-    return 0.0f; 
+    static const int kDefaultUnits = PhonemeUnits().size();
+    return calculatePhonemeSimilarity(posteriorsA, lenA, posteriorsB, lenB, kDefaultUnits);
+}
+
+float calculatePhonemeSimilarity(const float* posteriorsA, int lenA,
+                                const float* posteriorsB, int lenB, int dim) {
+    return phonemeDtwSimilarity(posteriorsA, lenA, posteriorsB, lenB, dim);
 }
 // Bridge for direct string comparison (similar to JS implementation)
 float calculateStringSimilarity(const char* s1, const char* s2) {
-    std::string a(s1);
-    std::string b(s2);
-    if (a == b) return 1.0f;
-    int dist = editDistance(a, b);
-    int maxLen = std::max(a.length(), b.length());
-    if (maxLen == 0) return 1.0f;
-    return 1.0f - (float)dist / maxLen;
+    if (!s1 || !s2) return 0.0f;
+    return editSimilarity(s1, strlen(s1), s2, strlen(s2));
 }
 
 }  // namespace silenceguard
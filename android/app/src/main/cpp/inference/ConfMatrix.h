@@ -1,25 +1,106 @@
 // SilenceGuard Pro — 变体混淆矩阵 (NEXT_IMPROVEMENTS §3.2)
 // conf_matrix.json: "s" -> ["s","sh","x"], "yi" -> ["yi","wei","yu"], ...
-// Phase 2: 接入真实 JSON 解析与 DTW 相似度
+// 载入后编译为不可变的 CompiledConfMatrix (音素名驻留为稠密 id，变体 CSR)，以快照原子发布；
+// 其内存布局即二进制文件格式 (conf_matrix.bin)，可直接 mmap
+// 音素后验图相似度由 PhonemeDtw 实现
 
 #ifndef SILENCEGUARD_CONFMATRIX_H
 #define SILENCEGUARD_CONFMATRIX_H
 
 #include <cstddef>
 #include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
 
 namespace silenceguard {
 
-/** 从 assets 或路径加载 conf_matrix.json，Phase 2 实现；当前占位返回 false */
+/**
+ * 编译后的混淆矩阵，只读、可跨线程共享
+ * 二进制布局 (小端，4 字节对齐)：32 字节文件头 | nameOffset[P] | rowStart[P + 1] | variants[V] |
+ * hash[H] (名字 FNV-1a 开放寻址，存 id + 1，0 为空) | 名字区 (NUL 结尾)
+ * mmap 时只校验文件头与各段长度 (O(1))，逐次访问再做越界检查，损坏文件不会读出界
+ */
+class CompiledConfMatrix {
+ public:
+  ~CompiledConfMatrix();
+  CompiledConfMatrix(const CompiledConfMatrix&) = delete;
+  CompiledConfMatrix& operator=(const CompiledConfMatrix&) = delete;
+
+  /** 解析 JSON 并编译；格式错误返回 nullptr (空对象得到空矩阵) */
+  static std::shared_ptr<const CompiledConfMatrix> fromJson(const std::string& json);
+  /** 映射二进制文件；文件头 / 段长度不符返回 nullptr */
+  static std::shared_ptr<const CompiledConfMatrix> mapFile(const char* path);
+  /** 写出二进制形式 (先写临时文件再 rename，读者不会看到半个文件) */
+  bool writeFile(const char* path) const;
+
+  int size() const { return static_cast<int>(phonemes_); }
+  int variantTotal() const { return static_cast<int>(variantCount_); }
+  bool isMapped() const { return mapped_ != nullptr; }
+
+  /** 名字 → id；未知返回 -1 */
+  int idOf(const char* name) const;
+  /** id → 名字 (指针在本矩阵存活期间有效)；越界返回 nullptr */
+  const char* name(int id) const;
+  /** id 的变体 id 写入 out (最多 maxOut 个)，返回写入数量；不分配 */
+  int variants(int id, int32_t* out, int maxOut) const;
+  /** 同上，写入变体名字 (指向名字区，本矩阵存活期间有效)；不分配 */
+  int variantNames(int id, const char** out, int maxOut) const;
+
+ private:
+  CompiledConfMatrix() = default;
+  bool attach(const uint8_t* data, size_t bytes);
+
+  std::vector<uint32_t> owned_;     // 由 JSON 编译时的存储 (即文件映像)
+  void* mapped_ = nullptr;          // mmap 区域
+  size_t mappedBytes_ = 0;
+  const uint8_t* image_ = nullptr;  // 文件映像起点
+  size_t imageBytes_ = 0;
+
+  uint32_t phonemes_ = 0;
+  uint32_t variantCount_ = 0;
+  uint32_t hashSlots_ = 0;
+  uint32_t nameBytes_ = 0;
+  const uint32_t* nameOffset_ = nullptr;
+  const uint32_t* rowStart_ = nullptr;
+  const uint32_t* variants_ = nullptr;
+  const uint32_t* hash_ = nullptr;
+  const char* names_ = nullptr;
+};
+
+/**
+ * 加载混淆矩阵：文件以 "SGCM" 开头按二进制 mmap，否则按 JSON 解析；成功 (非空) 后原子替换当前快照，
+ * 已取得旧快照的读者不受影响
+ */
 bool loadConfMatrix(const char* path);
 
-/** 获取音素变体列表：target 为 key（如 "s"），outVariants 写入最多 maxOut 个变体；返回写入数量。占位返回 0 */
-int getPhonemeVariants(const char* target, const char** outVariants, int maxOut);
+/** 当前快照；未加载时为 nullptr。持有期间名字指针与变体表保持有效 */
+std::shared_ptr<const CompiledConfMatrix> currentConfMatrix();
+
+/** 把 JSON 编译为二进制文件 (构建期 / 首次启动时缓存) */
+bool compileConfMatrix(const char* jsonPath, const char* binaryPath);
+
+/**
+ * 获取音素变体列表：target 为 key（如 "s"），变体名字依次拷入调用方的 nameBuf (各自 NUL 结尾)，
+ * outVariants 写入最多 maxOut 个指向 nameBuf 的指针；返回写入数量 (nameBuf 放不下时就此截止)
+ * 兼容接口：不分配、不加锁，结果不受之后的重载影响；持有快照时用 variantNames 直接取名字区指针
+ */
+int getPhonemeVariants(const char* target, char* nameBuf, size_t bufBytes, const char** outVariants, int maxOut);
 
-/** 音素序列相似度 (DTW)，Phase 2 实现；占位返回 0.f */
+/** 拼音串相似度：1 - 编辑距离 / 较长串长度 (位并行，见 EditDistance.h)；批量打分用 editDistanceBatch */
+float calculateStringSimilarity(const char* s1, const char* s2);
+
+/**
+ * 音素后验图相似度 (带约束 DTW，见 PhonemeDtw.h)：lenA / lenB 为帧数，每帧一行默认音素单元表
+ * (blank + 声母 + 韵母) 上的后验；返回 0–1
+ */
 float calculatePhonemeSimilarity(const float* posteriorsA, int lenA,
                                  const float* posteriorsB, int lenB);
 
+/** 同上，行宽 dim 由调用方给出 (自定义单元表) */
+float calculatePhonemeSimilarity(const float* posteriorsA, int lenA,
+                                 const float* posteriorsB, int lenB, int dim);
+
 }  // namespace silenceguard
 
 #endif  // SILENCEGUARD_CONFMATRIX_H
@@ -0,0 +1,130 @@
+#include "EditDistance.h"
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+namespace silenceguard {
+
+namespace {
+
+using Peq = uint64_t[256];
+
+// 每线程一张常驻全零的位表：用前只写模式串出现的字节，用后只清这些项 (免去每次 2 KB 清零)
+thread_local Peq t_peq = {};
+
+// 模式串每个字节出现位置的位掩码
+void buildPeq(const unsigned char* p, size_t m, Peq peq) {
+  for (size_t i = 0; i < m; ++i) peq[p[i]] |= uint64_t{1} << i;
+}
+
+void clearPeq(const unsigned char* p, size_t m, Peq peq) {
+  for (size_t i = 0; i < m; ++i) peq[p[i]] = 0;
+}
+
+inline int capped(int d, int maxDistance) { return maxDistance >= 0 && d > maxDistance ? maxDistance + 1 : d; }
+
+/**
+ * Myers / Hyyrö：按列推进 DP，列内相邻格的差 (+1 / -1) 以 Pv / Mv 位向量表示，score 跟踪最后一行
+ * 最后一行每列至多变化 1，故 score - 剩余列数 > maxDistance 时结果必然超限
+ */
+int bitParallel(const Peq peq, size_t m, const unsigned char* t, size_t n, int maxDistance) {
+  const uint64_t last = uint64_t{1} << (m - 1);
+  uint64_t pv = ~uint64_t{0}, mv = 0;
+  int score = static_cast<int>(m);
+  for (size_t j = 0; j < n; ++j) {
+    const uint64_t eq = peq[t[j]];
+    const uint64_t xv = eq | mv;
+    const uint64_t xh = (((eq & pv) + pv) ^ pv) | eq;
+    uint64_t ph = mv | ~(xh | pv);
+    uint64_t mh = pv & xh;
+    if (ph & last) {
+      ++score;
+    } else if (mh & last) {
+      --score;
+    }
+    ph = (ph << 1) | 1;  // 第 0 行 D[0][j] = j：水平差恒为 +1
+    mh <<= 1;
+    pv = mh | ~(xv | ph);
+    mv = ph & xv;
+    if (maxDistance >= 0 && score - static_cast<int>(n - j - 1) > maxDistance) return maxDistance + 1;
+  }
+  return capped(score, maxDistance);
+}
+
+// 两串都超过 64 字节：两行 DP，整行最小值超限即退出
+int rowDp(const unsigned char* a, size_t m, const unsigned char* b, size_t n, int maxDistance) {
+  std::vector<int> prev(n + 1), cur(n + 1);
+  for (size_t j = 0; j <= n; ++j) prev[j] = static_cast<int>(j);
+  for (size_t i = 1; i <= m; ++i) {
+    cur[0] = static_cast<int>(i);
+    int rowMin = cur[0];
+    for (size_t j = 1; j <= n; ++j) {
+      cur[j] = std::min({prev[j] + 1, cur[j - 1] + 1, prev[j - 1] + (a[i - 1] == b[j - 1] ? 0 : 1)});
+      rowMin = std::min(rowMin, cur[j]);
+    }
+    if (maxDistance >= 0 && rowMin > maxDistance) return maxDistance + 1;
+    prev.swap(cur);
+  }
+  return capped(prev[n], maxDistance);
+}
+
+float similarityOf(int distance, size_t lenA, size_t lenB) {
+  const size_t longer = std::max(lenA, lenB);
+  return longer == 0 ? 1.0f : 1.0f - static_cast<float>(distance) / static_cast<float>(longer);
+}
+
+}  // namespace
+
+int editDistance(const char* a, size_t lenA, const char* b, size_t lenB, int maxDistance) {
+  if (lenA > lenB) {
+    std::swap(a, b);
+    std::swap(lenA, lenB);
+  }
+  if (maxDistance >= 0 && lenB - lenA > static_cast<size_t>(maxDistance)) return maxDistance + 1;
+  if (lenA == 0) return capped(static_cast<int>(lenB), maxDistance);
+  const unsigned char* p = reinterpret_cast<const unsigned char*>(a);
+  const unsigned char* t = reinterpret_cast<const unsigned char*>(b);
+  if (lenA > kBitParallelMaxLength) return rowDp(p, lenA, t, lenB, maxDistance);
+  buildPeq(p, lenA, t_peq);
+  const int d = bitParallel(t_peq, lenA, t, lenB, maxDistance);
+  clearPeq(p, lenA, t_peq);
+  return d;
+}
+
+float editSimilarity(const char* a, size_t lenA, const char* b, size_t lenB) {
+  return similarityOf(editDistance(a, lenA, b, lenB), lenA, lenB);
+}
+
+int editDistanceBatch(const char* query, const char* const* candidates, int count, int maxDistance,
+                      int32_t* distances, float* similarities) {
+  if (!query || !candidates || !distances || count <= 0) return -1;
+  const size_t m = strlen(query);
+  const unsigned char* q = reinterpret_cast<const unsigned char*>(query);
+  const bool shared = m > 0 && m <= kBitParallelMaxLength;
+  // 查询的位表在整批内复用；候选走 editDistance 时 (查询超过 64 字节) 位表不被占用
+  if (shared) buildPeq(q, m, t_peq);
+
+  int best = -1;
+  for (int k = 0; k < count; ++k) {
+    const char* cand = candidates[k] ? candidates[k] : "";
+    const size_t n = strlen(cand);
+    const size_t gap = m > n ? m - n : n - m;
+    int d;
+    if (maxDistance >= 0 && gap > static_cast<size_t>(maxDistance)) {
+      d = maxDistance + 1;
+    } else if (shared) {
+      d = n == 0 ? capped(static_cast<int>(m), maxDistance)
+                 : bitParallel(t_peq, m, reinterpret_cast<const unsigned char*>(cand), n, maxDistance);
+    } else {
+      d = editDistance(query, m, cand, n, maxDistance);
+    }
+    distances[k] = d;
+    const bool within = maxDistance < 0 || d <= maxDistance;
+    if (similarities) similarities[k] = within ? similarityOf(d, m, n) : 0.0f;
+    if (within && (best < 0 || d < distances[best])) best = k;
+  }
+  if (shared) clearPeq(q, m, t_peq);
+  return best;
+}
+
+}  // namespace silenceguard
@@ -0,0 +1,34 @@
+// SilenceGuard Pro — 有界编辑距离 (拼音串模糊匹配)
+// Myers / Hyyrö 位并行 Levenshtein：较短一方不超过 64 字节时每个字节一次 64 位字运算；
+// maxDistance 截断：距离下界超过即提前退出。按字节比较 (与原 DP 一致)
+
+#ifndef SILENCEGUARD_EDITDISTANCE_H
+#define SILENCEGUARD_EDITDISTANCE_H
+
+#include <cstddef>
+#include <cstdint>
+
+namespace silenceguard {
+
+constexpr size_t kBitParallelMaxLength = 64;
+
+/**
+ * Levenshtein 距离；maxDistance >= 0 时距离超过它即返回 maxDistance + 1
+ * 两串都超过 64 字节时回退到两行 DP (会分配)
+ */
+int editDistance(const char* a, size_t lenA, const char* b, size_t lenB, int maxDistance = -1);
+
+/** 1 - 距离 / 较长串长度；两串皆空为 1 */
+float editSimilarity(const char* a, size_t lenA, const char* b, size_t lenB);
+
+/**
+ * 一个查询对一组候选 (NUL 结尾)：查询的匹配位表只建一次，不分配 (查询与候选都超过 64 字节时除外)
+ * distances[k] 为距离，超过 maxDistance (>= 0 时) 记 maxDistance + 1；similarities 可为 nullptr
+ * 返回距离最小的候选下标 (并列取靠前者)；全部超出截断返回 -1
+ */
+int editDistanceBatch(const char* query, const char* const* candidates, int count, int maxDistance,
+                      int32_t* distances, float* similarities = nullptr);
+
+}  // namespace silenceguard
+
+#endif  // SILENCEGUARD_EDITDISTANCE_H
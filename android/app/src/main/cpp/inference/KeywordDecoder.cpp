@@ -0,0 +1,126 @@
+#include "KeywordDecoder.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace silenceguard {
+
+void KeywordDecoder::setGraph(std::shared_ptr<const KeywordGraph> graph) {
+  graph_ = std::move(graph);
+  cur_.clear();
+  next_.clear();
+  const size_t slots = graph_ ? static_cast<size_t>(graph_->nodeCount()) * 2 : 0;
+  slot_.assign(slots, 0);
+  stamp_.assign(slots, 0);
+  epoch_ = 0;
+  logp_.assign(graph_ ? static_cast<size_t>(graph_->unitCount()) : 0, 0.0f);
+  lastHitEnd_.assign(graph_ ? static_cast<size_t>(graph_->keywordCount()) : 0, -1);
+  peakActive_ = 0;
+  if (graph_) {
+    cur_.reserve(static_cast<size_t>(options_.maxActive) * 2);
+    next_.reserve(static_cast<size_t>(options_.maxActive) * 2);
+  }
+}
+
+bool KeywordDecoder::accepts(int unitCount) const {
+  return graph_ && graph_->nodeCount() > 1 && graph_->unitCount() == unitCount;
+}
+
+void KeywordDecoder::reset() {
+  cur_.clear();
+  std::fill(lastHitEnd_.begin(), lastHitEnd_.end(), -1);
+}
+
+int KeywordDecoder::advance(const float* posteriors, int frames, KeywordHit* hits, int maxHits) {
+  if (!graph_ || !posteriors) return 0;
+  const int units = graph_->unitCount();
+  int found = 0;
+  for (int f = 0; f < frames; ++f) {
+    found += step(posteriors + static_cast<size_t>(f) * units, hits + found, maxHits - found);
+  }
+  return found;
+}
+
+void KeywordDecoder::relax(int32_t node, int32_t blank, float score, int64_t start) {
+  const size_t key = static_cast<size_t>(node) * 2 + static_cast<size_t>(blank);
+  if (stamp_[key] == epoch_) {
+    Token& t = next_[static_cast<size_t>(slot_[key])];
+    // Viterbi：同一状态只保留最优；分数相同取更早的起点 (命中区间覆盖整个单元)
+    if (score > t.score || (score == t.score && start < t.start)) {
+      t.score = score;
+      t.start = start;
+    }
+    return;
+  }
+  stamp_[key] = epoch_;
+  slot_[key] = static_cast<int32_t>(next_.size());
+  next_.push_back({node, blank, score, start});
+}
+
+int KeywordDecoder::step(const float* frame, KeywordHit* hits, int maxHits) {
+  const KeywordGraph& g = *graph_;
+  const int units = g.unitCount();
+  const int64_t t = frame_++;
+
+  // 相对后验：log p(u) - log max p，逐帧 <= 0；完全匹配的路径得分为 0
+  float peak = 0.0f;
+  for (int u = 0; u < units; ++u) peak = std::max(peak, frame[u]);
+  if (!(peak > 0.0f)) return 0;
+  const float logPeak = std::log(peak);
+  for (int u = 0; u < units; ++u) {
+    logp_[u] = frame[u] > 0.0f ? std::max(options_.logFloor, std::log(frame[u]) - logPeak) : options_.logFloor;
+  }
+  const float logBlank = logp_[g.blank()];
+
+  if (++epoch_ == 0) {  // 回绕：清空标记
+    std::fill(stamp_.begin(), stamp_.end(), 0);
+    epoch_ = 1;
+  }
+  next_.clear();
+
+  // 任意帧起始：根的子节点每帧以 0 分重新播种
+  for (const int32_t* c = g.childrenBegin(0); c != g.childrenEnd(0); ++c) {
+    relax(*c, 0, g.penalty(*c) + logp_[g.unit(*c)], t);
+  }
+  for (const Token& tok : cur_) {
+    if (t - tok.start >= options_.maxSpanFrames) continue;
+    const int u = g.unit(tok.node);
+    if (!tok.blank) relax(tok.node, 0, tok.score + logp_[u], tok.start);  // 单元持续
+    relax(tok.node, 1, tok.score + logBlank, tok.start);                 // 进入 blank
+    for (const int32_t* c = g.childrenBegin(tok.node); c != g.childrenEnd(tok.node); ++c) {
+      // CTC：相同单元相邻时必须隔一个 blank
+      if (!tok.blank && g.unit(*c) == u) continue;
+      relax(*c, 0, tok.score + g.penalty(*c) + logp_[g.unit(*c)], tok.start);
+    }
+  }
+
+  // 束剪枝 + 直方图剪枝
+  float best = -std::numeric_limits<float>::infinity();
+  for (const Token& tok : next_) best = std::max(best, tok.score);
+  const float floor = best - options_.beam;
+  cur_.clear();
+  for (const Token& tok : next_) {
+    if (tok.score >= floor) cur_.push_back(tok);
+  }
+  if (cur_.size() > static_cast<size_t>(options_.maxActive)) {
+    std::nth_element(cur_.begin(), cur_.begin() + options_.maxActive, cur_.end(),
+                     [](const Token& a, const Token& b) { return a.score > b.score; });
+    cur_.resize(static_cast<size_t>(options_.maxActive));
+  }
+  peakActive_ = std::max(peakActive_, cur_.size());
+
+  // 终止节点：单元上 (非 blank) 的令牌即完成一条关键词路径
+  int found = 0;
+  for (const Token& tok : cur_) {
+    if (tok.blank || !g.isFinal(tok.node)) continue;
+    const float score = std::exp(tok.score / static_cast<float>(t - tok.start + 1));
+    for (const int32_t* k = g.keywordsBegin(tok.node); k != g.keywordsEnd(tok.node); ++k) {
+      if (score < g.threshold(*k) || tok.start <= lastHitEnd_[*k]) continue;
+      lastHitEnd_[*k] = t;
+      if (found < maxHits) hits[found++] = {*k, score, tok.start, t};
+    }
+  }
+  return found;
+}
+
+}  // namespace silenceguard
@@ -0,0 +1,83 @@
+// SilenceGuard Pro — 关键词检索 (KWS) 解码器
+// 在 KeywordGraph 上对逐帧音素后验做 CTC 令牌传递：任意帧可起始，Viterbi 合并，
+// 束剪枝 + 活跃令牌上限，每帧开销只取决于活跃令牌数，不随词表规模增长
+
+#ifndef SILENCEGUARD_KEYWORDDECODER_H
+#define SILENCEGUARD_KEYWORDDECODER_H
+
+#include "KeywordGraph.h"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace silenceguard {
+
+/** 一次命中：帧号为解码器自 reset 起累计的后验帧 */
+struct KeywordHit {
+  int keywordId = -1;  // UPDATE_CONFIG keywords 数组下标
+  float score = 0.0f;  // 置信度 0–1：路径上逐帧相对后验 (含变体惩罚) 的几何平均
+  int64_t startFrame = 0;
+  int64_t endFrame = 0;  // 含
+};
+
+struct KeywordDecoderOptions {
+  float beam = 10.0f;        // 相对当前最优令牌的对数分差，超出即剪枝
+  int maxActive = 1024;      // 活跃令牌上限 (直方图剪枝)
+  int maxSpanFrames = 200;   // 单个令牌最长持续帧数，超出丢弃 (避免跨越长静音拼接)
+  float logFloor = -16.0f;   // 后验取对数的下限
+};
+
+class KeywordDecoder {
+ public:
+  KeywordDecoder() = default;
+
+  /** 换图：清空令牌与命中记录；nullptr 表示停用 */
+  void setGraph(std::shared_ptr<const KeywordGraph> graph);
+  const std::shared_ptr<const KeywordGraph>& graph() const { return graph_; }
+  void setOptions(const KeywordDecoderOptions& options) { options_ = options; }
+
+  /** 有关键词可检索，且 unitCount 与单元表一致 */
+  bool accepts(int unitCount) const;
+
+  /** 丢弃所有令牌 (流不连续)；帧号继续累计 */
+  void reset();
+
+  /**
+   * 送入 frames 帧后验 [frames × unitCount] (softmax 概率)；命中写入 hits (最多 maxHits)，返回命中数
+   * 同一关键词的新命中必须起始于上一次命中结束之后
+   */
+  int advance(const float* posteriors, int frames, KeywordHit* hits, int maxHits);
+
+  int64_t frameCount() const { return frame_; }
+  size_t activeTokens() const { return cur_.size(); }
+  size_t peakActiveTokens() const { return peakActive_; }
+
+ private:
+  struct Token {
+    int32_t node;
+    int32_t blank;  // 0：停在节点单元上；1：节点单元之后的 blank
+    float score;
+    int64_t start;
+  };
+
+  void relax(int32_t node, int32_t blank, float score, int64_t start);
+  int step(const float* frame, KeywordHit* hits, int maxHits);
+
+  std::shared_ptr<const KeywordGraph> graph_;
+  KeywordDecoderOptions options_;
+  std::vector<Token> cur_;
+  std::vector<Token> next_;
+  // (节点, blank) → next_ 下标；stamp 标记本帧是否已写入，免去每帧清零 O(节点数) 的数组
+  std::vector<int32_t> slot_;
+  std::vector<uint32_t> stamp_;
+  uint32_t epoch_ = 0;
+  std::vector<float> logp_;
+  std::vector<int64_t> lastHitEnd_;  // 按关键词 id
+  int64_t frame_ = 0;
+  size_t peakActive_ = 0;
+};
+
+}  // namespace silenceguard
+
+#endif  // SILENCEGUARD_KEYWORDDECODER_H
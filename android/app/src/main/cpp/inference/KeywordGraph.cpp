@@ -0,0 +1,245 @@
+#include "KeywordGraph.h"
+#include "ConfMatrix.h"
+#include <algorithm>
+#include <unordered_map>
+
+namespace silenceguard {
+
+namespace {
+
+// 声母 (含 y / w 作为零声母写法)；双字母在前，最长匹配
+const char* const kInitials[] = {"zh", "ch", "sh", "b", "p", "m", "f", "d", "t", "n", "l", "g",
+                                 "k",  "h",  "j",  "q", "x", "r", "z", "c", "s", "y", "w"};
+
+const char* const kFinals[] = {"a",   "o",   "e",   "i",    "u",    "v",    "ai",  "ei",   "ui",
+                               "ao",  "ou",  "iu",  "ie",   "ve",   "er",   "an",  "en",   "in",
+                               "un",  "vn",  "ang", "eng",  "ing",  "ong",  "ia",  "iao",  "ian",
+                               "iang", "iong", "ua", "uo",  "uai",  "uan",  "uang", "ue"};
+
+constexpr int kMaxVariants = 16;
+
+// 小写、去声调数字、ü / u: 记作 v
+std::string normalizeSyllable(const std::string& s) {
+  std::string out;
+  out.reserve(s.size());
+  for (size_t i = 0; i < s.size(); ++i) {
+    unsigned char c = static_cast<unsigned char>(s[i]);
+    if (c == 0xC3 && i + 1 < s.size() && static_cast<unsigned char>(s[i + 1]) == 0xBC) {  // "ü"
+      out.push_back('v');
+      ++i;
+    } else if (c == ':' && !out.empty() && out.back() == 'u') {
+      out.back() = 'v';
+    } else if (c >= 'A' && c <= 'Z') {
+      out.push_back(static_cast<char>(c - 'A' + 'a'));
+    } else if (c >= 'a' && c <= 'z') {
+      out.push_back(static_cast<char>(c));
+    }
+  }
+  return out;
+}
+
+size_t initialLength(const std::string& syllable) {
+  for (const char* ini : kInitials) {
+    const size_t n = std::char_traits<char>::length(ini);
+    if (syllable.size() > n && syllable.compare(0, n, ini) == 0) return n;
+  }
+  return 0;
+}
+
+struct Alternative {
+  std::vector<int> units;
+  float penalty;
+};
+
+void addAlternative(const std::string& syllable, float penalty, const PhonemeUnits& units,
+                    std::vector<Alternative>* alts) {
+  Alternative alt{{}, penalty};
+  if (!splitSyllable(syllable, units, &alt.units)) return;
+  for (Alternative& a : *alts) {
+    if (a.units == alt.units) {
+      a.penalty = std::max(a.penalty, penalty);
+      return;
+    }
+  }
+  alts->push_back(std::move(alt));
+}
+
+// 混淆矩阵中 key 的变体名 (指针随快照存活)
+int variantNames(const CompiledConfMatrix* conf, const std::string& key, const char** out) {
+  if (!conf) return 0;
+  int32_t ids[kMaxVariants];
+  const int n = conf->variants(conf->idOf(key.c_str()), ids, kMaxVariants);
+  int count = 0;
+  for (int i = 0; i < n; ++i) {
+    if (const char* name = conf->name(ids[i])) out[count++] = name;
+  }
+  return count;
+}
+
+// 一个音节的全部候选：原音节、整音节变体、声母变体 + 原韵母、原声母 + 韵母变体
+std::vector<Alternative> expandSyllable(const std::string& raw, const PhonemeUnits& units, float penalty,
+                                        const CompiledConfMatrix* conf) {
+  std::vector<Alternative> alts;
+  const std::string syllable = normalizeSyllable(raw);
+  addAlternative(syllable, 0.0f, units, &alts);
+  if (alts.empty()) return alts;  // 原音节不可拆：整个关键词作废
+
+  const char* variants[kMaxVariants];
+  int n = variantNames(conf, syllable, variants);
+  for (int i = 0; i < n; ++i) addAlternative(normalizeSyllable(variants[i]), penalty, units, &alts);
+
+  const size_t split = initialLength(syllable);
+  const std::string initial = syllable.substr(0, split);
+  const std::string final = syllable.substr(split);
+  if (!initial.empty()) {
+    n = variantNames(conf, initial, variants);
+    for (int i = 0; i < n; ++i) addAlternative(normalizeSyllable(variants[i]) + final, penalty, units, &alts);
+  }
+  n = variantNames(conf, final, variants);
+  for (int i = 0; i < n; ++i) addAlternative(initial + normalizeSyllable(variants[i]), penalty, units, &alts);
+  return alts;
+}
+
+}  // namespace
+
+// ---------------------------------------------------------
+// PhonemeUnits
+// ---------------------------------------------------------
+
+PhonemeUnits::PhonemeUnits() {
+  names_.push_back("<blank>");
+  for (const char* s : kInitials) names_.push_back(s);
+  for (const char* s : kFinals) names_.push_back(s);
+}
+
+PhonemeUnits::PhonemeUnits(std::vector<std::string> names, int blank) : names_(std::move(names)), blank_(blank) {
+  if (blank_ < 0 || blank_ >= size()) blank_ = 0;
+}
+
+int PhonemeUnits::indexOf(const std::string& name) const {
+  for (int i = 0; i < size(); ++i)
+    if (i != blank_ && names_[i] == name) return i;
+  return -1;
+}
+
+bool splitSyllable(const std::string& syllable, const PhonemeUnits& units, std::vector<int>* out) {
+  out->clear();
+  if (syllable.empty()) return false;
+  // 整音节本身就是单元 (自定义表、或 m / n / ng 这类叹词)
+  const int whole = units.indexOf(syllable);
+  const size_t split = initialLength(syllable);
+  if (split == 0 || whole >= 0) {
+    if (whole < 0) return false;
+    out->push_back(whole);
+    return true;
+  }
+  const int ini = units.indexOf(syllable.substr(0, split));
+  const int fin = units.indexOf(syllable.substr(split));
+  if (ini < 0 || fin < 0) return false;
+  out->push_back(ini);
+  out->push_back(fin);
+  return true;
+}
+
+// ---------------------------------------------------------
+// KeywordGraph
+// ---------------------------------------------------------
+
+std::shared_ptr<const KeywordGraph> KeywordGraph::compile(const std::vector<KeywordSpec>& keywords,
+                                                          const PhonemeUnits& units,
+                                                          const KeywordGraphOptions& options,
+                                                          KeywordGraphReport* report) {
+  auto graph = std::make_shared<KeywordGraph>();
+  graph->unitCount_ = units.size();
+  graph->blank_ = units.blank();
+  graph->threshold_.reserve(keywords.size());
+
+  // 构建期：节点 (父, 单元, 是否变体首单元) → id；变体首节点带惩罚，不与精确路径共享
+  std::vector<int32_t> parent{-1};
+  std::vector<int32_t> unit{-1};
+  std::vector<float> penalty{0.0f};
+  std::vector<std::pair<int32_t, int32_t>> finals;  // (节点, 关键词)
+  std::unordered_map<uint64_t, int32_t> edges;
+  auto child = [&](int32_t from, int u, float pen) {
+    const uint64_t key = (static_cast<uint64_t>(from) << 32) | (static_cast<uint64_t>(u) << 1) | (pen < 0.0f ? 1 : 0);
+    auto it = edges.find(key);
+    if (it != edges.end()) return it->second;
+    const int32_t id = static_cast<int32_t>(unit.size());
+    parent.push_back(from);
+    unit.push_back(u);
+    penalty.push_back(pen);
+    edges.emplace(key, id);
+    return id;
+  };
+
+  // 整个编译期间钉住同一份混淆矩阵快照，并发重载不影响本次展开
+  const std::shared_ptr<const CompiledConfMatrix> conf = currentConfMatrix();
+  KeywordGraphReport rep;
+  struct Frontier {
+    int32_t node;
+    float penalty;
+  };
+  for (size_t k = 0; k < keywords.size(); ++k) {
+    const KeywordSpec& spec = keywords[k];
+    graph->threshold_.push_back(spec.threshold);
+
+    std::vector<std::vector<Alternative>> slots;
+    bool valid = !spec.pinyin.empty();
+    for (const std::string& syl : spec.pinyin) {
+      if (!valid) break;
+      slots.push_back(expandSyllable(syl, units, options.variantPenalty, conf.get()));
+      valid = !slots.back().empty();
+    }
+    if (!valid) {
+      ++rep.rejected;
+      continue;
+    }
+
+    // 逐音节扩展前沿；超过上限时保留惩罚最小的路径
+    std::vector<Frontier> frontier{{0, 0.0f}}, next;
+    for (const std::vector<Alternative>& alts : slots) {
+      next.clear();
+      for (const Frontier& f : frontier) {
+        for (const Alternative& alt : alts) {
+          int32_t node = f.node;
+          for (size_t i = 0; i < alt.units.size(); ++i) node = child(node, alt.units[i], i == 0 ? alt.penalty : 0.0f);
+          next.push_back({node, f.penalty + alt.penalty});
+        }
+      }
+      if (static_cast<int>(next.size()) > options.maxPathsPerKeyword) {
+        std::stable_sort(next.begin(), next.end(),
+                         [](const Frontier& a, const Frontier& b) { return a.penalty > b.penalty; });
+        next.resize(static_cast<size_t>(std::max(1, options.maxPathsPerKeyword)));
+      }
+      frontier.swap(next);
+    }
+    for (const Frontier& f : frontier) finals.push_back({f.node, static_cast<int32_t>(k)});
+    rep.paths += static_cast<int>(frontier.size());
+    ++rep.keywords;
+  }
+
+  // 定型为 CSR：子节点与终止关键词
+  const int32_t n = static_cast<int32_t>(unit.size());
+  graph->unit_ = std::move(unit);
+  graph->penalty_ = std::move(penalty);
+  graph->childStart_.assign(static_cast<size_t>(n) + 1, 0);
+  for (int32_t i = 1; i < n; ++i) ++graph->childStart_[static_cast<size_t>(parent[i]) + 1];
+  for (int32_t i = 0; i < n; ++i) graph->childStart_[i + 1] += graph->childStart_[i];
+  graph->children_.resize(static_cast<size_t>(n > 0 ? n - 1 : 0));
+  std::vector<int32_t> fill(graph->childStart_.begin(), graph->childStart_.end() - 1);
+  for (int32_t i = 1; i < n; ++i) graph->children_[fill[parent[i]]++] = i;
+
+  std::sort(finals.begin(), finals.end());
+  finals.erase(std::unique(finals.begin(), finals.end()), finals.end());
+  graph->finalStart_.assign(static_cast<size_t>(n) + 1, 0);
+  for (const auto& f : finals) ++graph->finalStart_[static_cast<size_t>(f.first) + 1];
+  for (int32_t i = 0; i < n; ++i) graph->finalStart_[i + 1] += graph->finalStart_[i];
+  graph->finals_.reserve(finals.size());
+  for (const auto& f : finals) graph->finals_.push_back(f.second);
+
+  rep.nodes = n;
+  if (report) *report = rep;
+  return graph;
+}
+
+}  // namespace silenceguard
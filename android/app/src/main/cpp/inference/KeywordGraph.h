@@ -0,0 +1,101 @@
+// SilenceGuard Pro — 关键词图 (KWS 解码的静态部分)
+// UPDATE_CONFIG 的拼音音节序列 → 声母 / 韵母单元前缀树，并按 ConfMatrix 的混淆变体展开；
+// 编译后只读，可在任意线程构建后整体交给 KeywordDecoder
+
+#ifndef SILENCEGUARD_KEYWORDGRAPH_H
+#define SILENCEGUARD_KEYWORDGRAPH_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace silenceguard {
+
+/**
+ * 音素单元表：下标即模型后验的列号 (CTC：列 0 为 blank)
+ * 默认表为 blank + 普通话声母 (含 y / w) + 韵母 (ü 记作 v)；真实模型可经 phoneme_units 下发自己的表
+ */
+class PhonemeUnits {
+ public:
+  PhonemeUnits();  // 默认表
+  explicit PhonemeUnits(std::vector<std::string> names, int blank = 0);
+
+  int size() const { return static_cast<int>(names_.size()); }
+  int blank() const { return blank_; }
+  const std::string& name(int unit) const { return names_[unit]; }
+  /** 未知单元返回 -1 */
+  int indexOf(const std::string& name) const;
+
+ private:
+  std::vector<std::string> names_;
+  int blank_ = 0;
+};
+
+/** 一个待编译的关键词：拼音音节 (无声调，小写) 与命中阈值 (置信度 0–1) */
+struct KeywordSpec {
+  std::vector<std::string> pinyin;
+  float threshold = 0.85f;
+
+  bool operator==(const KeywordSpec& o) const { return pinyin == o.pinyin && threshold == o.threshold; }
+  bool operator!=(const KeywordSpec& o) const { return !(*this == o); }
+};
+
+struct KeywordGraphOptions {
+  float variantPenalty = -1.0f;  // 走混淆变体的对数惩罚 (每个被替换的音节)
+  int maxPathsPerKeyword = 64;   // 单个关键词展开的路径上限 (按惩罚从小到大保留)
+};
+
+/** 编译统计 */
+struct KeywordGraphReport {
+  int keywords = 0;   // 成功编译
+  int rejected = 0;   // 含未知单元被跳过
+  int paths = 0;      // 展开后的路径总数 (含变体)
+  int nodes = 0;
+};
+
+/**
+ * 前缀树：节点 0 为根；其余节点发射一个单元，进入时计入 penalty
+ * 子节点以 CSR 存放；终止节点列出在此结束的关键词 id (UPDATE_CONFIG 中的下标)
+ */
+class KeywordGraph {
+ public:
+  /** 编译；无可用关键词时仍返回空图 (只有根) */
+  static std::shared_ptr<const KeywordGraph> compile(const std::vector<KeywordSpec>& keywords,
+                                                     const PhonemeUnits& units,
+                                                     const KeywordGraphOptions& options = KeywordGraphOptions(),
+                                                     KeywordGraphReport* report = nullptr);
+
+  int nodeCount() const { return static_cast<int>(unit_.size()); }
+  int unitCount() const { return unitCount_; }
+  int blank() const { return blank_; }
+  int keywordCount() const { return static_cast<int>(threshold_.size()); }
+
+  int unit(int node) const { return unit_[node]; }
+  float penalty(int node) const { return penalty_[node]; }
+  const int32_t* childrenBegin(int node) const { return children_.data() + childStart_[node]; }
+  const int32_t* childrenEnd(int node) const { return children_.data() + childStart_[node + 1]; }
+  const int32_t* keywordsBegin(int node) const { return finals_.data() + finalStart_[node]; }
+  const int32_t* keywordsEnd(int node) const { return finals_.data() + finalStart_[node + 1]; }
+  bool isFinal(int node) const { return finalStart_[node] != finalStart_[node + 1]; }
+  float threshold(int keyword) const { return threshold_[keyword]; }
+
+ private:
+  int unitCount_ = 0;
+  int blank_ = 0;
+  std::vector<int32_t> unit_;
+  std::vector<float> penalty_;
+  std::vector<int32_t> childStart_;  // nodeCount + 1
+  std::vector<int32_t> children_;
+  std::vector<int32_t> finalStart_;  // nodeCount + 1
+  std::vector<int32_t> finals_;
+  std::vector<float> threshold_;     // 按关键词 id；未编译的关键词保留条目但不会命中
+};
+
+/** 拼音音节拆为声母 + 韵母单元 (零声母音节只有韵母)；任一单元不在表中返回 false */
+bool splitSyllable(const std::string& syllable, const PhonemeUnits& units, std::vector<int>* out);
+
+}  // namespace silenceguard
+
+#endif  // SILENCEGUARD_KEYWORDGRAPH_H
@@ -0,0 +1,241 @@
+#include "PhonemeDtw.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define SG_DTW_NEON 1
+#elif defined(__SSE2__) || defined(_M_X64)
+#include <xmmintrin.h>
+#define SG_DTW_SSE 1
+#endif
+
+namespace silenceguard {
+
+namespace {
+
+constexpr float kInf = std::numeric_limits<float>::infinity();
+constexpr float kMinDot = 1e-6f;  // 帧距离上限 -log(1e-6) ≈ 13.8
+
+inline float dot(const float* a, const float* b, int n) {
+  int i = 0;
+#if defined(SG_DTW_NEON)
+  float32x4_t acc0 = vdupq_n_f32(0.0f), acc1 = vdupq_n_f32(0.0f);
+  for (; i + 8 <= n; i += 8) {
+    acc0 = vmlaq_f32(acc0, vld1q_f32(a + i), vld1q_f32(b + i));
+    acc1 = vmlaq_f32(acc1, vld1q_f32(a + i + 4), vld1q_f32(b + i + 4));
+  }
+  for (; i + 4 <= n; i += 4) acc0 = vmlaq_f32(acc0, vld1q_f32(a + i), vld1q_f32(b + i));
+  float32x4_t acc = vaddq_f32(acc0, acc1);
+  float32x2_t s2 = vadd_f32(vget_low_f32(acc), vget_high_f32(acc));
+  float sum = vget_lane_f32(vpadd_f32(s2, s2), 0);
+#elif defined(SG_DTW_SSE)
+  __m128 acc0 = _mm_setzero_ps(), acc1 = _mm_setzero_ps();
+  for (; i + 8 <= n; i += 8) {
+    acc0 = _mm_add_ps(acc0, _mm_mul_ps(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i)));
+    acc1 = _mm_add_ps(acc1, _mm_mul_ps(_mm_loadu_ps(a + i + 4), _mm_loadu_ps(b + i + 4)));
+  }
+  for (; i + 4 <= n; i += 4) acc0 = _mm_add_ps(acc0, _mm_mul_ps(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i)));
+  __m128 acc = _mm_add_ps(acc0, acc1);
+  acc = _mm_add_ps(acc, _mm_movehl_ps(acc, acc));
+  acc = _mm_add_ss(acc, _mm_shuffle_ps(acc, acc, 1));
+  float sum = _mm_cvtss_f32(acc);
+#else
+  float sum = 0.0f;
+#endif
+  for (; i < n; ++i) sum += a[i] * b[i];
+  return sum;
+}
+
+// dst = max(dst, src)
+inline void maxInto(float* dst, const float* src, int n) {
+  int i = 0;
+#if defined(SG_DTW_NEON)
+  for (; i + 4 <= n; i += 4) vst1q_f32(dst + i, vmaxq_f32(vld1q_f32(dst + i), vld1q_f32(src + i)));
+#elif defined(SG_DTW_SSE)
+  for (; i + 4 <= n; i += 4) _mm_storeu_ps(dst + i, _mm_max_ps(_mm_loadu_ps(dst + i), _mm_loadu_ps(src + i)));
+#endif
+  for (; i < n; ++i) dst[i] = std::max(dst[i], src[i]);
+}
+
+// -log(q·t)：内积钳位到 [kMinDot, 1]，距离非负
+inline float frameCost(const float* q, const float* t, int dim) {
+  return -std::log(std::min(1.0f, std::max(kMinDot, dot(q, t, dim))));
+}
+
+// Sakoe-Chiba 斜带：模板第 j 行对应查询 [c - r, c + r]，c = j · (n-1)/(m-1)
+// 半径至少为 ceil(斜率 / 2)，保证相邻两行的带首尾相接、总有可行路径
+struct Band {
+  int n;
+  int radius;
+  double slope;
+
+  Band(int queryFrames, int templateFrames, int requested) : n(queryFrames) {
+    const int longer = std::max(queryFrames, templateFrames);
+    slope = templateFrames > 1 ? static_cast<double>(queryFrames - 1) / (templateFrames - 1) : 0.0;
+    radius = requested >= 0 ? requested : std::max(2, longer / 10);
+    radius = std::max({radius, 1, static_cast<int>(std::ceil(slope / 2.0))});
+    if (templateFrames == 1) radius = std::max(radius, queryFrames - 1);  // 单行模板须覆盖整个查询
+  }
+
+  void range(int j, int* lo, int* hi) const {
+    const double c = j * slope;
+    *lo = std::max(0, static_cast<int>(std::ceil(c - radius)));
+    *hi = std::min(n - 1, static_cast<int>(std::floor(c + radius)));
+  }
+};
+
+/**
+ * 带约束 DTW 代价 (对称权重)；逐行早停：行最小值 + 后续行下界 (tail[j + 1]) 超过 bound 即返回 kInf
+ * rows 为 2n 的工作区
+ */
+float dtwCost(const float* q, const float* t, int m, int dim, const Band& band, float bound, const float* tail,
+              float* rows) {
+  const int n = band.n;
+  float* buf[2] = {rows, rows + n};
+  int usedLo[2] = {0, 0}, usedHi[2] = {n - 1, n - 1};
+  std::fill(rows, rows + 2 * static_cast<size_t>(n), kInf);
+  int p = 0;  // buf[p] 为上一行
+  for (int j = 0; j < m; ++j) {
+    const float* prev = buf[p];
+    float* cur = buf[p ^ 1];
+    // 清掉两行前留在该缓冲里的值，带外保持 kInf
+    std::fill(cur + usedLo[p ^ 1], cur + usedHi[p ^ 1] + 1, kInf);
+    int lo, hi;
+    band.range(j, &lo, &hi);
+    usedLo[p ^ 1] = lo;
+    usedHi[p ^ 1] = hi;
+
+    const float* tj = t + static_cast<size_t>(j) * dim;
+    float rowMin = kInf;
+    for (int i = lo; i <= hi; ++i) {
+      const float d = frameCost(q + static_cast<size_t>(i) * dim, tj, dim);
+      float g;
+      if (i == 0 && j == 0) {
+        g = 2.0f * d;
+      } else {
+        g = prev[i] + d;                                      // 模板前进
+        if (i > lo) g = std::min(g, cur[i - 1] + d);          // 查询前进
+        if (i > 0) g = std::min(g, prev[i - 1] + 2.0f * d);   // 对角
+      }
+      cur[i] = g;
+      rowMin = std::min(rowMin, g);
+    }
+    if (rowMin + (tail ? tail[j + 1] : 0.0f) > bound) return kInf;
+    p ^= 1;
+  }
+  return buf[p][n - 1];
+}
+
+}  // namespace
+
+float phonemeDtwSimilarity(const float* a, int framesA, const float* b, int framesB, int dim,
+                           const DtwOptions& options) {
+  PhonemeTemplateMatcher matcher;
+  const PhonemeTemplate tmpl{b, framesB};
+  float score = 0.0f;
+  matcher.match(a, framesA, dim, &tmpl, 1, options, &score);
+  return score;
+}
+
+int PhonemeTemplateMatcher::match(const float* window, int frames, int dim, const PhonemeTemplate* templates,
+                                  int count, const DtwOptions& options, float* scores, DtwStats* stats) {
+  if (count <= 0) return -1;
+  std::fill(scores, scores + count, 0.0f);
+  DtwStats st;
+  st.templates = count;
+  if (!window || frames <= 0 || dim <= 0 || !templates) {
+    if (stats) *stats = st;
+    return -1;
+  }
+  // 归一化代价阈值：相似度 s ↔ 代价 -log(s) · (n + m)
+  const float limit = options.minSimilarity > 0.0f ? -std::log(options.minSimilarity) : kInf;
+  auto valid = [](const PhonemeTemplate& t) { return t.posteriors && t.frames > 0; };
+
+  // 下界：查询在带内的逐维上包络 U_j (按模板长度缓存)，模板第 j 行的下界 = d(U_j, t_j)
+  // 路径至少经过模板每一行一次且后验非负，故 Σ_j d(U_j, t_j) ≤ DTW 代价
+  bounds_.assign(static_cast<size_t>(count), 0.0f);
+  rowBoundsAt_.assign(static_cast<size_t>(count), -1);
+  rowBounds_.clear();
+  if (options.lowerBound) {
+    int longest = 0;
+    for (int k = 0; k < count; ++k)
+      if (valid(templates[k])) longest = std::max(longest, templates[k].frames);
+    envelopeAt_.assign(static_cast<size_t>(longest) + 1, -1);
+    envelope_.clear();
+    for (int k = 0; k < count; ++k) {
+      const PhonemeTemplate& t = templates[k];
+      if (!valid(t)) continue;
+      const Band band(frames, t.frames, options.band);
+      int32_t& at = envelopeAt_[static_cast<size_t>(t.frames)];
+      if (at < 0) {
+        at = static_cast<int32_t>(envelope_.size() / static_cast<size_t>(dim));
+        envelope_.resize(envelope_.size() + static_cast<size_t>(t.frames) * dim);
+        for (int j = 0; j < t.frames; ++j) {
+          int lo, hi;
+          band.range(j, &lo, &hi);
+          float* u = envelope_.data() + (static_cast<size_t>(at) + j) * dim;
+          std::copy(window + static_cast<size_t>(lo) * dim, window + static_cast<size_t>(lo + 1) * dim, u);
+          for (int i = lo + 1; i <= hi; ++i) maxInto(u, window + static_cast<size_t>(i) * dim, dim);
+        }
+      }
+      rowBoundsAt_[k] = static_cast<int32_t>(rowBounds_.size());
+      float sum = 0.0f;
+      for (int j = 0; j < t.frames; ++j) {
+        const float lb = frameCost(envelope_.data() + (static_cast<size_t>(at) + j) * dim,
+                                   t.posteriors + static_cast<size_t>(j) * dim, dim);
+        rowBounds_.push_back(lb);
+        sum += lb;
+      }
+      bounds_[k] = sum / static_cast<float>(frames + t.frames);
+    }
+  }
+
+  // 下界升序：先算最有希望的模板，尽早收紧阈值
+  order_.resize(static_cast<size_t>(count));
+  std::iota(order_.begin(), order_.end(), 0);
+  if (options.lowerBound) {
+    std::stable_sort(order_.begin(), order_.end(), [this](int32_t x, int32_t y) { return bounds_[x] < bounds_[y]; });
+  }
+
+  rows_.resize(2 * static_cast<size_t>(frames));
+  float best = kInf;
+  int bestIndex = -1;
+  for (const int32_t k : order_) {
+    const PhonemeTemplate& t = templates[k];
+    if (!valid(t)) continue;
+    const float bound = options.pruneByBest ? std::min(limit, best) : limit;
+    if (bounds_[k] > bound) {
+      ++st.prunedByBound;
+      continue;
+    }
+    const float* tail = nullptr;
+    if (rowBoundsAt_[k] >= 0) {
+      tail_.assign(static_cast<size_t>(t.frames) + 1, 0.0f);
+      const float* lb = rowBounds_.data() + rowBoundsAt_[k];
+      for (int j = t.frames - 1; j >= 0; --j) tail_[j] = tail_[j + 1] + lb[j];
+      tail = tail_.data();
+    }
+    const Band band(frames, t.frames, options.band);
+    const float weight = static_cast<float>(frames + t.frames);
+    const float cost = dtwCost(window, t.posteriors, t.frames, dim, band, bound * weight, tail, rows_.data());
+    if (cost == kInf) {
+      ++st.abandoned;
+      continue;
+    }
+    ++st.completed;
+    const float normalized = cost / weight;
+    if (normalized > limit) continue;
+    scores[k] = std::exp(-normalized);
+    if (normalized < best) {
+      best = normalized;
+      bestIndex = k;
+    }
+  }
+  if (stats) *stats = st;
+  return bestIndex;
+}
+
+}  // namespace silenceguard
@@ -0,0 +1,66 @@
+// SilenceGuard Pro — 音素后验图 DTW (关键词模板匹配)
+// 帧距离 d = -log(q·t)：两帧音素分布的内积 (SSE / NEON 内核)；Sakoe-Chiba 斜带约束、
+// 对称权重 (对角 2，水平 / 垂直 1，总权重 n + m)；相似度 = exp(-代价 / (n + m))，即逐帧内积的几何平均
+// LB_Keogh：查询在带内的逐维上包络与模板行的距离是 DTW 代价的下界，预筛 + 逐行早停共用
+
+#ifndef SILENCEGUARD_PHONEMEDTW_H
+#define SILENCEGUARD_PHONEMEDTW_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace silenceguard {
+
+struct DtwOptions {
+  int band = -1;               // Sakoe-Chiba 半径 (帧)；< 0 为较长序列的 10% (至少 2)
+  float minSimilarity = 0.0f;  // 低于此相似度视为不匹配：下界剪枝 / 早停后记 0
+  bool lowerBound = true;      // LB_Keogh 预筛与逐行早停
+  bool pruneByBest = true;     // 批量匹配：无望超过当前最优的模板直接早停 (其分数记 0)
+};
+
+/** 批量匹配的剪枝统计 */
+struct DtwStats {
+  int templates = 0;
+  int prunedByBound = 0;  // 下界已超出阈值 / 当前最优，未跑 DTW
+  int abandoned = 0;      // DTW 中途早停
+  int completed = 0;      // 完整算完
+};
+
+/** 一个模板：[frames × dim] 行主序后验 (调用方持有) */
+struct PhonemeTemplate {
+  const float* posteriors = nullptr;
+  int frames = 0;
+};
+
+/** 单对相似度 0–1；低于 options.minSimilarity 时返回 0 */
+float phonemeDtwSimilarity(const float* a, int framesA, const float* b, int framesB, int dim,
+                           const DtwOptions& options = DtwOptions());
+
+/**
+ * 批量匹配：同一查询窗口对多个模板；先算全部下界并按下界升序跑 DTW，以当前最优收紧早停阈值
+ * 工作区跨调用复用 (单线程使用；多线程各持一个实例)
+ */
+class PhonemeTemplateMatcher {
+ public:
+  /**
+   * scores[k] 为模板 k 的相似度 (被剪枝 / 早停的记 0；pruneByBest 时只保证最优者精确)
+   * 返回最优模板下标；无模板达到 minSimilarity 返回 -1
+   */
+  int match(const float* window, int frames, int dim, const PhonemeTemplate* templates, int count,
+            const DtwOptions& options, float* scores, DtwStats* stats = nullptr);
+
+ private:
+  std::vector<float> envelope_;      // 按模板长度缓存的查询上包络
+  std::vector<int32_t> envelopeAt_;  // 模板长度 → envelope_ 行偏移；-1 = 未计算
+  std::vector<float> rowBounds_;     // 全部模板的逐行下界 (拼接)
+  std::vector<int32_t> rowBoundsAt_; // 模板 → rowBounds_ 偏移
+  std::vector<float> tail_;          // 当前模板逐行下界的后缀和
+  std::vector<float> rows_;          // DTW 两行滚动
+  std::vector<float> bounds_;        // 每个模板的归一化下界
+  std::vector<int32_t> order_;
+};
+
+}  // namespace silenceguard
+
+#endif  // SILENCEGUARD_PHONEMEDTW_H
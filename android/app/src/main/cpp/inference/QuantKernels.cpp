@@ -0,0 +1,142 @@
+#include "QuantKernels.h"
+#include <algorithm>
+#include <cmath>
+
+#if defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#define SG_QUANT_NEON 1  // vcvtnq_s32_f32 (就近取偶) 仅 AArch64 提供
+#elif defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define SG_QUANT_SSE2 1
+#endif
+
+namespace silenceguard {
+
+namespace {
+
+// 先在 float 域钳位到 [lo - zp, hi - zp]，转换不会溢出，之后的饱和收窄只是截位
+template <typename T>
+inline T quantizeOne(float x, float invScale, int32_t zeroPoint, float lo, float hi) {
+  float v = std::min(hi, std::max(lo, x * invScale));
+  return static_cast<T>(static_cast<int32_t>(std::lrint(v)) + zeroPoint);
+}
+
+}  // namespace
+
+void quantizeToInt8(const float* src, int8_t* dst, size_t n, float invScale, int32_t zeroPoint) {
+  const float lo = static_cast<float>(-128 - zeroPoint);
+  const float hi = static_cast<float>(127 - zeroPoint);
+  size_t i = 0;
+#if defined(SG_QUANT_SSE2)
+  const __m128 k = _mm_set1_ps(invScale), vlo = _mm_set1_ps(lo), vhi = _mm_set1_ps(hi);
+  const __m128i zp = _mm_set1_epi32(zeroPoint);
+  auto conv = [&](const float* p) {
+    __m128 v = _mm_min_ps(vhi, _mm_max_ps(vlo, _mm_mul_ps(_mm_loadu_ps(p), k)));
+    return _mm_add_epi32(_mm_cvtps_epi32(v), zp);
+  };
+  for (; i + 16 <= n; i += 16) {
+    __m128i a = _mm_packs_epi32(conv(src + i), conv(src + i + 4));
+    __m128i b = _mm_packs_epi32(conv(src + i + 8), conv(src + i + 12));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_packs_epi16(a, b));
+  }
+#elif defined(SG_QUANT_NEON)
+  const float32x4_t vlo = vdupq_n_f32(lo), vhi = vdupq_n_f32(hi);
+  const int32x4_t zp = vdupq_n_s32(zeroPoint);
+  auto conv = [&](const float* p) {
+    float32x4_t v = vminq_f32(vhi, vmaxq_f32(vlo, vmulq_n_f32(vld1q_f32(p), invScale)));
+    return vaddq_s32(vcvtnq_s32_f32(v), zp);
+  };
+  for (; i + 16 <= n; i += 16) {
+    int16x8_t a = vcombine_s16(vqmovn_s32(conv(src + i)), vqmovn_s32(conv(src + i + 4)));
+    int16x8_t b = vcombine_s16(vqmovn_s32(conv(src + i + 8)), vqmovn_s32(conv(src + i + 12)));
+    vst1q_s8(dst + i, vcombine_s8(vqmovn_s16(a), vqmovn_s16(b)));
+  }
+#endif
+  for (; i < n; ++i) dst[i] = quantizeOne<int8_t>(src[i], invScale, zeroPoint, lo, hi);
+}
+
+void quantizeToUInt8(const float* src, uint8_t* dst, size_t n, float invScale, int32_t zeroPoint) {
+  const float lo = static_cast<float>(0 - zeroPoint);
+  const float hi = static_cast<float>(255 - zeroPoint);
+  size_t i = 0;
+#if defined(SG_QUANT_SSE2)
+  const __m128 k = _mm_set1_ps(invScale), vlo = _mm_set1_ps(lo), vhi = _mm_set1_ps(hi);
+  const __m128i zp = _mm_set1_epi32(zeroPoint);
+  auto conv = [&](const float* p) {
+    __m128 v = _mm_min_ps(vhi, _mm_max_ps(vlo, _mm_mul_ps(_mm_loadu_ps(p), k)));
+    return _mm_add_epi32(_mm_cvtps_epi32(v), zp);
+  };
+  for (; i + 16 <= n; i += 16) {
+    __m128i a = _mm_packs_epi32(conv(src + i), conv(src + i + 4));
+    __m128i b = _mm_packs_epi32(conv(src + i + 8), conv(src + i + 12));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_packus_epi16(a, b));
+  }
+#elif defined(SG_QUANT_NEON)
+  const float32x4_t vlo = vdupq_n_f32(lo), vhi = vdupq_n_f32(hi);
+  const int32x4_t zp = vdupq_n_s32(zeroPoint);
+  auto conv = [&](const float* p) {
+    float32x4_t v = vminq_f32(vhi, vmaxq_f32(vlo, vmulq_n_f32(vld1q_f32(p), invScale)));
+    return vaddq_s32(vcvtnq_s32_f32(v), zp);
+  };
+  for (; i + 16 <= n; i += 16) {
+    int16x8_t a = vcombine_s16(vqmovn_s32(conv(src + i)), vqmovn_s32(conv(src + i + 4)));
+    int16x8_t b = vcombine_s16(vqmovn_s32(conv(src + i + 8)), vqmovn_s32(conv(src + i + 12)));
+    vst1q_u8(dst + i, vcombine_u8(vqmovun_s16(a), vqmovun_s16(b)));
+  }
+#endif
+  for (; i < n; ++i) dst[i] = quantizeOne<uint8_t>(src[i], invScale, zeroPoint, lo, hi);
+}
+
+void dequantizeInt8(const int8_t* src, float* dst, size_t n, float scale, int32_t zeroPoint) {
+  size_t i = 0;
+#if defined(SG_QUANT_SSE2)
+  const __m128 k = _mm_set1_ps(scale);
+  const __m128i zp = _mm_set1_epi32(zeroPoint);
+  for (; i + 8 <= n; i += 8) {
+    __m128i x = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(src + i));
+    x = _mm_srai_epi16(_mm_unpacklo_epi8(x, x), 8);  // 符号扩展到 int16
+    __m128i lo = _mm_sub_epi32(_mm_srai_epi32(_mm_unpacklo_epi16(x, x), 16), zp);
+    __m128i hi = _mm_sub_epi32(_mm_srai_epi32(_mm_unpackhi_epi16(x, x), 16), zp);
+    _mm_storeu_ps(dst + i, _mm_mul_ps(_mm_cvtepi32_ps(lo), k));
+    _mm_storeu_ps(dst + i + 4, _mm_mul_ps(_mm_cvtepi32_ps(hi), k));
+  }
+#elif defined(SG_QUANT_NEON)
+  const int32x4_t zp = vdupq_n_s32(zeroPoint);
+  for (; i + 8 <= n; i += 8) {
+    int16x8_t x = vmovl_s8(vld1_s8(src + i));
+    int32x4_t lo = vsubq_s32(vmovl_s16(vget_low_s16(x)), zp);
+    int32x4_t hi = vsubq_s32(vmovl_s16(vget_high_s16(x)), zp);
+    vst1q_f32(dst + i, vmulq_n_f32(vcvtq_f32_s32(lo), scale));
+    vst1q_f32(dst + i + 4, vmulq_n_f32(vcvtq_f32_s32(hi), scale));
+  }
+#endif
+  for (; i < n; ++i) dst[i] = static_cast<float>(static_cast<int32_t>(src[i]) - zeroPoint) * scale;
+}
+
+void dequantizeUInt8(const uint8_t* src, float* dst, size_t n, float scale, int32_t zeroPoint) {
+  size_t i = 0;
+#if defined(SG_QUANT_SSE2)
+  const __m128 k = _mm_set1_ps(scale);
+  const __m128i zp = _mm_set1_epi32(zeroPoint);
+  const __m128i zero = _mm_setzero_si128();
+  for (; i + 8 <= n; i += 8) {
+    __m128i x = _mm_unpacklo_epi8(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(src + i)), zero);
+    __m128i lo = _mm_sub_epi32(_mm_unpacklo_epi16(x, zero), zp);
+    __m128i hi = _mm_sub_epi32(_mm_unpackhi_epi16(x, zero), zp);
+    _mm_storeu_ps(dst + i, _mm_mul_ps(_mm_cvtepi32_ps(lo), k));
+    _mm_storeu_ps(dst + i + 4, _mm_mul_ps(_mm_cvtepi32_ps(hi), k));
+  }
+#elif defined(SG_QUANT_NEON)
+  const int32x4_t zp = vdupq_n_s32(zeroPoint);
+  for (; i + 8 <= n; i += 8) {
+    int16x8_t x = vreinterpretq_s16_u16(vmovl_u8(vld1_u8(src + i)));
+    int32x4_t lo = vsubq_s32(vmovl_s16(vget_low_s16(x)), zp);
+    int32x4_t hi = vsubq_s32(vmovl_s16(vget_high_s16(x)), zp);
+    vst1q_f32(dst + i, vmulq_n_f32(vcvtq_f32_s32(lo), scale));
+    vst1q_f32(dst + i + 4, vmulq_n_f32(vcvtq_f32_s32(hi), scale));
+  }
+#endif
+  for (; i < n; ++i) dst[i] = static_cast<float>(static_cast<int32_t>(src[i]) - zeroPoint) * scale;
+}
+
+}  // namespace silenceguard
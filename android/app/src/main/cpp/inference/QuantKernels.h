@@ -0,0 +1,23 @@
+// SilenceGuard Pro — 量化 / 反量化向量内核 (SSE2 / AArch64 NEON，其余平台标量回退)
+// 全整型 (int8 / uint8) 模型：Mel 特征在线量化写入输入张量，后验反量化为 float
+// 舍入统一为 "就近、平局取偶" (与 cvtps2dq / fcvtns 一致)，向量与标量路径逐位一致
+
+#ifndef SILENCEGUARD_QUANTKERNELS_H
+#define SILENCEGUARD_QUANTKERNELS_H
+
+#include <cstddef>
+#include <cstdint>
+
+namespace silenceguard {
+
+/** dst[i] = sat8(round(src[i] · invScale) + zeroPoint)；invScale = 1 / scale */
+void quantizeToInt8(const float* src, int8_t* dst, size_t n, float invScale, int32_t zeroPoint);
+void quantizeToUInt8(const float* src, uint8_t* dst, size_t n, float invScale, int32_t zeroPoint);
+
+/** dst[i] = (src[i] - zeroPoint) · scale */
+void dequantizeInt8(const int8_t* src, float* dst, size_t n, float scale, int32_t zeroPoint);
+void dequantizeUInt8(const uint8_t* src, float* dst, size_t n, float scale, int32_t zeroPoint);
+
+}  // namespace silenceguard
+
+#endif  // SILENCEGUARD_QUANTKERNELS_H
@@ -0,0 +1,62 @@
+// SilenceGuard Pro — TFLiteRunner 后端上下文 (inference 内部头文件)
+// 每个后端 (TFLiteRunner.cpp / TFLiteRunnerStub.cpp) 派生自己的上下文并实现工厂函数；
+// 发布、租约、预跑与计时由 TFLiteRunnerCommon.cpp 统一处理
+
+#ifndef SILENCEGUARD_TFLITECONTEXT_H
+#define SILENCEGUARD_TFLITECONTEXT_H
+
+#include "TFLiteRunner.h"
+#include <atomic>
+#include <cstdint>
+#include <memory>
+
+namespace silenceguard {
+
+struct TFLiteContext {
+  virtual ~TFLiteContext() = default;
+
+  /**
+   * 对输入张量执行推理；输出缓冲可能在 Invoke 后重新分配，需刷新 outputTensor.data
+   * 流式上下文在此之后互换状态缓冲的角色 (输出状态成为下一次的输入状态)
+   */
+  virtual bool invoke() = 0;
+
+  /** 流式上下文：状态清零 (量化状态填零点)；窗口上下文无状态 */
+  virtual void resetState() {}
+
+  /** 流式上下文：当前输入侧状态的字节数与拷出 / 拷入 (按状态对下标顺序拼接) */
+  virtual size_t stateBytes() const { return 0; }
+  virtual void saveState(uint8_t* /* dst */) const {}
+  virtual void loadState(const uint8_t* /* src */) {}
+
+  // 后端在工厂中填写张量描述 (缓冲移动时在 invoke 内刷新 data)；float 视图由 TFLiteRunnerCommon 据此派生
+  TensorInfo inputTensor;
+  TensorInfo outputTensor;
+
+  // 派生视图：output 对量化模型指向 dequantized
+  ConstFloatSpan output;
+  std::unique_ptr<float[]> dequantized;
+
+  // 流式契约 (见 TFLiteRunner.h)：chunkFrames > 0 时每次 invoke 只送入新帧
+  int chunkFrames = 0;
+  int stateTensors = 0;
+  uint64_t generation = 0;  // 发布时由 TFLiteRunner 赋值
+
+  // 加载计时；firstInferenceUs 由首次 invoke 写入，统计线程并发读取
+  std::atomic<uint32_t> loadUs{0};
+  std::atomic<uint32_t> warmupUs{0};
+  std::atomic<uint32_t> firstInferenceUs{0};
+  std::atomic<int32_t> numThreads{-1};
+  std::atomic<bool> xnnpackApplied{false};
+  bool firstInvokePending = true;
+};
+
+/**
+ * 后端工厂：解析模型、构建解释器、AllocateTensors，检查张量类型与量化参数并填写
+ * inputTensor / outputTensor；不预跑。失败返回空
+ */
+std::unique_ptr<TFLiteContext> createTFLiteContext(const char* path, const TFLiteLoadOptions& options);
+
+}  // namespace silenceguard
+
+#endif  // SILENCEGUARD_TFLITECONTEXT_H
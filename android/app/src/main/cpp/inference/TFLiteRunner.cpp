@@ -1,95 +1,251 @@
 // SilenceGuard Pro — TFLite 推理封装 (Phase 2 真实实现)
 
-#include "TFLiteRunner.h"
+#include "TFLiteContext.h"
+#include <tensorflow/lite/delegates/xnnpack/xnnpack_delegate.h>
 #include <tensorflow/lite/interpreter.h>
 #include <tensorflow/lite/kernels/register.h>
 #include <tensorflow/lite/model.h>
 #include <tensorflow/lite/tools/gen_op_registration.h>
+#include <cstring>
 #include <iostream>
 #include <memory> 
 
 namespace silenceguard {
 
-// Internal state to hide TFLite headers from the .h
-struct TFLiteContext {
+namespace {
+
+// 每个 TFLiteRunner 发布的上下文各自持有模型与解释器 (不再共享文件级全局)
+// 成员顺序决定析构顺序：interpreter 先于其 delegate、delegate 先于 model 释放
+struct InterpreterContext : TFLiteContext {
+    using DelegatePtr = std::unique_ptr<TfLiteDelegate, void (*)(TfLiteDelegate*)>;
+
     std::unique_ptr<tflite::FlatBufferModel> model;
+    DelegatePtr delegate{nullptr, TfLiteXNNPackDelegateDelete};
     std::unique_ptr<tflite::Interpreter> interpreter;
+
+    // 流式状态：每对 (输入 k, 输出 k) 持有两块对齐缓冲，以自定义分配绑定到张量，
+    // 每次 invoke 后互换 —— 本次的输出状态缓冲即下一次的输入状态，不拷贝
+    struct StatePair {
+        int inputIndex;
+        int outputIndex;
+        size_t bytes;
+        uint8_t zeroByte;  // 状态 "零" 的字节值：float 为 0，量化状态为零点
+        void* buffer[2];
+    };
+    std::vector<StatePair> states;
+    std::unique_ptr<uint8_t[]> stateArena;
+    int parity = 0;  // buffer[parity] 当前绑定为输入状态
+
+    bool bindStates() {
+        for (const StatePair& st : states) {
+            if (interpreter->SetCustomAllocationForTensor(st.inputIndex, {st.buffer[parity], st.bytes}) != kTfLiteOk ||
+                interpreter->SetCustomAllocationForTensor(st.outputIndex, {st.buffer[parity ^ 1], st.bytes}) != kTfLiteOk) {
+                return false;
+            }
+        }
+        // 更换自定义分配后按 TFLite 约定调用 AllocateTensors (形状不变，不重新规划)；
+        // 保险起见刷新输入缓冲指针，下一次 writeInput 写到正确位置
+        if (interpreter->AllocateTensors() != kTfLiteOk) return false;
+        inputTensor.data = interpreter->input_tensor(0)->data.raw;
+        return true;
+    }
+
+    bool invoke() override {
+        if (interpreter->Invoke() != kTfLiteOk) {
+            std::cerr << "[SilenceGuard] Inference failed" << std::endl;
+            return false;
+        }
+        // 动态形状的输出可能在 Invoke 后重新分配，刷新视图
+        outputTensor.data = interpreter->output_tensor(0)->data.raw;
+        if (!states.empty()) {
+            parity ^= 1;
+            if (!bindStates()) {
+                std::cerr << "[SilenceGuard] Failed to rebind streaming state" << std::endl;
+                return false;
+            }
+        }
+        return outputTensor.data != nullptr;
+    }
+
+    size_t stateBytes() const override {
+        size_t bytes = 0;
+        for (const StatePair& st : states) bytes += st.bytes;
+        return bytes;
+    }
+
+    // 输入侧缓冲 buffer[parity] 即下一次 invoke 的状态；拷入后绑定不变，无需重新绑定
+    void saveState(uint8_t* dst) const override {
+        for (const StatePair& st : states) {
+            std::memcpy(dst, st.buffer[parity], st.bytes);
+            dst += st.bytes;
+        }
+    }
+
+    void loadState(const uint8_t* src) override {
+        for (const StatePair& st : states) {
+            std::memcpy(st.buffer[parity], src, st.bytes);
+            src += st.bytes;
+        }
+    }
+
+    void resetState() override {
+        for (const StatePair& st : states) {
+            std::memset(st.buffer[0], st.zeroByte, st.bytes);
+            std::memset(st.buffer[1], st.zeroByte, st.bytes);
+        }
+        parity = 0;
+        if (!states.empty() && !bindStates()) {
+            std::cerr << "[SilenceGuard] Failed to bind streaming state" << std::endl;
+        }
+    }
 };
 
-// Global context (Singleton-like for simplicity in this file scope)
-static std::unique_ptr<TFLiteContext> g_ctx;
+// float32 / int8 / uint8 (per-tensor 仿射量化) 之外的输入输出类型不支持
+bool describeTensor(TfLiteTensor* t, TensorInfo* info) {
+    switch (t->type) {
+        case kTfLiteFloat32:
+            info->type = TensorType::kFloat32;
+            info->size = t->bytes / sizeof(float);
+            break;
+        case kTfLiteInt8:
+            info->type = TensorType::kInt8;
+            info->size = t->bytes;
+            break;
+        case kTfLiteUInt8:
+            info->type = TensorType::kUInt8;
+            info->size = t->bytes;
+            break;
+        default:
+            return false;
+    }
+    if (info->type != TensorType::kFloat32) info->quant = {t->params.scale, t->params.zero_point};
+    info->data = t->data.raw;
+    return true;
+}
+
+// 流式契约：输入 k 与输出 k (k >= 1) 成对作为状态；两块乒乓缓冲按 kDefaultTensorAlignment 对齐
+bool setupStates(InterpreterContext* ctx) {
+    tflite::Interpreter* interp = ctx->interpreter.get();
+    const std::vector<int>& ins = interp->inputs();
+    const std::vector<int>& outs = interp->outputs();
+    if (ins.size() <= 1 && outs.size() <= 1) return true;  // 窗口模型
+    if (ins.size() != outs.size()) {
+        std::cerr << "[SilenceGuard] Streaming model needs paired state inputs/outputs ("
+                  << ins.size() << " inputs, " << outs.size() << " outputs)" << std::endl;
+        return false;
+    }
+
+    constexpr size_t kAlign = kDefaultTensorAlignment;
+    auto alignUp = [](size_t n) { return (n + kAlign - 1) / kAlign * kAlign; };
+    size_t arenaBytes = kAlign;
+    for (size_t k = 1; k < ins.size(); ++k) {
+        TfLiteTensor* in = interp->tensor(ins[k]);
+        TfLiteTensor* out = interp->tensor(outs[k]);
+        TensorInfo info;
+        if (!in || !out || in->type != out->type || in->bytes != out->bytes || !describeTensor(in, &info)) {
+            std::cerr << "[SilenceGuard] State tensor pair " << k << " mismatched or unsupported" << std::endl;
+            return false;
+        }
+        const uint8_t zeroByte = static_cast<uint8_t>(info.type == TensorType::kFloat32 ? 0 : info.quant.zeroPoint);
+        ctx->states.push_back({ins[k], outs[k], in->bytes, zeroByte, {nullptr, nullptr}});
+        arenaBytes += 2 * alignUp(in->bytes);
+    }
+
+    ctx->stateArena.reset(new uint8_t[arenaBytes]);
+    uintptr_t p = reinterpret_cast<uintptr_t>(ctx->stateArena.get());
+    p = (p + kAlign - 1) / kAlign * kAlign;
+    for (InterpreterContext::StatePair& st : ctx->states) {
+        st.buffer[0] = reinterpret_cast<void*>(p);
+        p += alignUp(st.bytes);
+        st.buffer[1] = reinterpret_cast<void*>(p);
+        p += alignUp(st.bytes);
+    }
+    ctx->stateTensors = static_cast<int>(ctx->states.size());
+    ctx->resetState();  // 清零并完成首次绑定
+    return true;
+}
+
+const char* typeName(TensorType type) {
+    switch (type) {
+        case TensorType::kInt8: return "int8";
+        case TensorType::kUInt8: return "uint8";
+        default: return "float32";
+    }
+}
+
+}  // namespace
+
+std::unique_ptr<TFLiteContext> createTFLiteContext(const char* path, const TFLiteLoadOptions& options) {
+    auto ctx = std::make_unique<InterpreterContext>();
 
-bool TFLiteRunner::loadModel(const char* path) {
-    if (!g_ctx) g_ctx = std::make_unique<TFLiteContext>();
-    
     // Load model
-    g_ctx->model = tflite::FlatBufferModel::BuildFromFile(path);
-    if (!g_ctx->model) {
+    ctx->model = tflite::FlatBufferModel::BuildFromFile(path);
+    if (!ctx->model) {
         std::cerr << "[SilenceGuard] Failed to load model: " << path << std::endl;
-        loaded_ = false;
-        return false;
+        return nullptr;
     }
 
-    // Build interpreter
-    tflite::ops::builtin::BuiltinOpResolver resolver;
-    tflite::InterpreterBuilder builder(*g_ctx->model, resolver);
-    builder(&g_ctx->interpreter);
+    // Build interpreter：delegate 由下方按选项显式挂载，不使用解析器的默认 delegate
+    tflite::ops::builtin::BuiltinOpResolverWithoutDefaultDelegates resolver;
+    tflite::InterpreterBuilder builder(*ctx->model, resolver);
+    builder(&ctx->interpreter);
 
-    if (!g_ctx->interpreter) {
+    if (!ctx->interpreter) {
         std::cerr << "[SilenceGuard] Failed to build interpreter" << std::endl;
-        loaded_ = false;
-        return false;
+        return nullptr;
+    }
+    if (options.numThreads > 0) ctx->interpreter->SetNumThreads(options.numThreads);
+
+    if (options.useXnnpack) {
+        TfLiteXNNPackDelegateOptions xnnOptions = TfLiteXNNPackDelegateOptionsDefault();
+        if (options.numThreads > 0) xnnOptions.num_threads = options.numThreads;
+        ctx->delegate.reset(TfLiteXNNPackDelegateCreate(&xnnOptions));
+        if (ctx->delegate && ctx->interpreter->ModifyGraphWithDelegate(ctx->delegate.get()) == kTfLiteOk) {
+            ctx->xnnpackApplied.store(true, std::memory_order_relaxed);
+        } else {
+            // 不支持的算子 / 构建未带 XNNPACK：退回内置 CPU 算子
+            std::cerr << "[SilenceGuard] XNNPACK delegate not applied, using builtin kernels" << std::endl;
+        }
     }
 
     // Allocate tensors
-    if (g_ctx->interpreter->AllocateTensors() != kTfLiteOk) {
+    if (ctx->interpreter->AllocateTensors() != kTfLiteOk) {
         std::cerr << "[SilenceGuard] Failed to allocate tensors" << std::endl;
-        loaded_ = false;
-        return false;
+        return nullptr;
     }
 
-    // Verify input shape (Expect [1, 50, 80])
-    // Note: In real production code, add stricter shape checks here.
-    
-    loaded_ = true;
-    std::cout << "[SilenceGuard] TFLite model loaded successfully: " << path << std::endl;
-    return true;
-}
+    // 流式模型：配对状态张量并绑定乒乓缓冲 (会重新 AllocateTensors，须在缓存输入输出之前)
+    if (!setupStates(ctx.get())) return nullptr;
 
-bool TFLiteRunner::run(const float* melInput, size_t melLen, std::vector<float>* posteriors) {
-    if (!loaded_ || !g_ctx || !g_ctx->interpreter) return false;
-    if (!melInput || !posteriors) return false;
-
-    // 1. Fill Input Tensor
-    float* inputTensor = g_ctx->interpreter->typed_input_tensor<float>(0);
-    if (!inputTensor) return false;
-    
-    // Safety check for input size
-    // Assumes input 0 is the Mel-spectrogram
-    size_t inputBytes = g_ctx->interpreter->input_tensor(0)->bytes;
-    if (melLen * sizeof(float) > inputBytes) {
-        // Truncate if too long (or error out)
-        std::memcpy(inputTensor, melInput, inputBytes);
-    } else {
-        std::memcpy(inputTensor, melInput, melLen * sizeof(float));
-    }
-
-    // 2. Run Inference
-    if (g_ctx->interpreter->Invoke() != kTfLiteOk) {
-        std::cerr << "[SilenceGuard] Inference failed" << std::endl;
-        return false;
+    // 检查输入 / 输出张量类型与量化参数
+    // (Expect input [1, 50, 80] 窗口，或流式 [1, C, 80] 新帧块；float32 / int8 / uint8)
+    TfLiteTensor* in = ctx->interpreter->input_tensor(0);
+    TfLiteTensor* out = ctx->interpreter->output_tensor(0);
+    if (!in || !out || !describeTensor(in, &ctx->inputTensor) || !describeTensor(out, &ctx->outputTensor)) {
+        std::cerr << "[SilenceGuard] Unsupported tensor types (float32 / int8 / uint8 in/out expected)" << std::endl;
+        return nullptr;
+    }
+    if (!ctx->states.empty()) {
+        ctx->chunkFrames = static_cast<int>(ctx->inputTensor.size / kInputMelBins);
+        if (ctx->chunkFrames <= 0 || ctx->chunkFrames > kInputFrames) {
+            std::cerr << "[SilenceGuard] Streaming chunk must be 1.." << kInputFrames << " frames" << std::endl;
+            return nullptr;
+        }
     }
 
-    // 3. Read Output
-    float* outputTensor = g_ctx->interpreter->typed_output_tensor<float>(0);
-    if (!outputTensor) return false;
-
-    // Copy to vector
-    int outputElements = g_ctx->interpreter->output_tensor(0)->bytes / sizeof(float);
-    posteriors->resize(outputElements);
-    std::memcpy(posteriors->data(), outputTensor, outputElements * sizeof(float));
-
-    return true;
+    std::cout << "[SilenceGuard] TFLite model loaded successfully: " << path
+              << " (xnnpack " << (ctx->xnnpackApplied.load() ? "on" : "off")
+              << ", threads " << options.numThreads
+              << ", " << typeName(ctx->inputTensor.type) << " -> " << typeName(ctx->outputTensor.type);
+    if (ctx->inputTensor.type != TensorType::kFloat32) {
+        std::cout << ", input scale " << ctx->inputTensor.quant.scale
+                  << " zp " << ctx->inputTensor.quant.zeroPoint;
+    }
+    if (!ctx->states.empty()) {
+        std::cout << ", streaming " << ctx->chunkFrames << " frames/chunk, " << ctx->states.size() << " state tensors";
+    }
+    std::cout << ")" << std::endl;
+    return ctx;
 }
 
 }  // namespace silenceguard
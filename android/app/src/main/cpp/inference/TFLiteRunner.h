@@ -5,9 +5,14 @@
 #ifndef SILENCEGUARD_TFLITERUNNER_H
 #define SILENCEGUARD_TFLITERUNNER_H
 
+#include <atomic>
+#include <condition_variable>
 #include <cstddef>
+#include <cstdint>
+#include <mutex>
 #include <vector>
 #include <string>
+#include <thread>
 
 namespace silenceguard {
 
@@ -16,21 +21,190 @@ constexpr int kInputFrames = 50;
 constexpr int kInputMelBins = 80;
 constexpr int kInputSize = kInputFrames * kInputMelBins;
 
+/** 张量视图：指向解释器内部缓冲，不拥有内存 */
+struct FloatSpan {
+  float* data = nullptr;
+  size_t size = 0;
+};
+
+struct ConstFloatSpan {
+  const float* data = nullptr;
+  size_t size = 0;
+};
+
+/** 张量元素类型：float32 模型直接写入特征；全整型量化模型按 (scale, zero_point) 在线量化 */
+enum class TensorType : uint8_t { kFloat32 = 0, kInt8 = 1, kUInt8 = 2 };
+
+/** 仿射量化参数：real = (q - zeroPoint) · scale (per-tensor) */
+struct QuantParams {
+  float scale = 1.0f;
+  int32_t zeroPoint = 0;
+};
+
+/** 后端张量描述：类型与量化参数在加载时检查后确定；data 指向解释器内部缓冲 */
+struct TensorInfo {
+  TensorType type = TensorType::kFloat32;
+  QuantParams quant;
+  void* data = nullptr;
+  size_t size = 0;  // 元素个数
+};
+
+/** 加载选项：按机型取舍 (也可经 updateConfig 的 tflite_threads / tflite_xnnpack / tflite_warmup 下发) */
+struct TFLiteLoadOptions {
+  bool useXnnpack = true;  // XNNPACK delegate；false 时只用内置 CPU 算子 (不挂任何默认 delegate)
+  int numThreads = -1;     // 解释器与 XNNPACK 线程数，<= 0 为 TFLite 默认
+  int warmupRuns = 0;      // 加载时以合成输入预跑次数，把惰性初始化挪出第一个真实窗口
+
+  bool operator==(const TFLiteLoadOptions& o) const {
+    return useXnnpack == o.useXnnpack && numThreads == o.numThreads && warmupRuns == o.warmupRuns;
+  }
+  bool operator!=(const TFLiteLoadOptions& o) const { return !(*this == o); }
+};
+
+/** 最近一次加载的耗时快照 (µs) */
+struct TFLiteLoadTimings {
+  uint32_t loadUs = 0;            // 解析模型 + 构建解释器 + delegate + AllocateTensors
+  uint32_t warmupUs = 0;          // 全部预跑合计
+  uint32_t firstInferenceUs = 0;  // 加载后第一次 Invoke (预跑的第一次，或无预跑时的首个真实窗口)
+  int32_t numThreads = -1;
+  bool xnnpackApplied = false;
+  TensorType inputType = TensorType::kFloat32;
+  TensorType outputType = TensorType::kFloat32;
+  int32_t chunkFrames = 0;   // 流式模型每次 invoke 的新帧数；0 = 窗口模型
+  int32_t stateTensors = 0;  // 流式模型跨调用携带的状态张量对数
+};
+
+struct TFLiteContext;
+
+/**
+ * 两种模型契约：
+ * - 窗口模型：输入 0 为 [1, 50, 80] 的完整窗口，输出 0 为后验；每次推理重新编码整个窗口
+ * - 流式模型：输入 0 为 [1, C, 80] 的新帧块 (C = chunkFrames)，输出 0 为后验；
+ *   其余输入 k 与输出 k (k >= 1) 按下标成对，为跨调用携带的状态 (卷积缓存、GRU 状态…)，
+ *   类型与字节数必须一致。运行时为每对状态持有两块缓冲并在 invoke 后互换角色 (乒乓)，
+ *   上一次的输出状态直接成为下一次的输入状态，不做拷贝；每次推理只为新音频付费
+ *
+ * 每个实例独占自己的解释器上下文 (TFLiteContext)；换模型时新上下文在实例的加载线程构建 + 预跑，
+ * 就绪后以原子指针交换发布 (RCU)：推理方通过 Lease 钉住当前上下文，旧上下文在没有
+ * Lease 引用后由加载线程回收。读者计数按纪元分成两组：发布时翻转纪元，只等待翻转前
+ * 取得的 Lease (有界)，之后新取的 Lease 计入另一组。音频 / 分析线程从不等待模型加载
+ * 同一实例同一时刻只允许一个 Lease 调用 invoke() (解释器非线程安全，由调用方串行化)
+ */
 class TFLiteRunner {
  public:
   TFLiteRunner() = default;
-  ~TFLiteRunner() = default;
+  ~TFLiteRunner();
+
+  TFLiteRunner(const TFLiteRunner&) = delete;
+  TFLiteRunner& operator=(const TFLiteRunner&) = delete;
 
-  /** 从 assets 或路径加载 encoder.tflite，Phase 2 实现 */
+  /** 同步加载 (默认选项)：先等已提交的后台请求落地，再构建 + 预跑 + 发布后返回 */
   bool loadModel(const char* path);
+  bool loadModel(const char* path, const TFLiteLoadOptions& options);
+
+  /**
+   * 后台加载：只登记请求后立即返回 (从不等待进行中的加载)；构建 + 预跑在加载线程完成后原子发布，
+   * 期间继续使用旧模型推理。加载中再次请求时只保留最新的一个：进行中的构建完成后若已被取代则直接丢弃
+   * (不发布、不回调)，随即构建最新请求
+   * onDone(ok, path) 在加载线程回调，不持有内部锁 (path 仅在回调期间有效)
+   */
+  using LoadCallback = void (*)(bool ok, const char* path, void* user);
+  void loadModelAsync(const char* path, const TFLiteLoadOptions& options,
+                      LoadCallback onDone = nullptr, void* user = nullptr);
+
+  /** 等待已提交的后台请求全部处理完；返回当前是否有可用模型 */
+  bool waitForLoad();
+
+  /** 是否有后台请求未处理完 (任意线程；不阻塞) */
+  bool loading() const { return loading_.load(std::memory_order_acquire); }
+
+  /**
+   * 推理租约 (热路径)：钉住当前上下文直到析构
+   * 1. writeInput() 把特征写入输入张量 [1, 50, 80] (量化模型在写入时量化)；
+   *    float32 模型也可经 input() 取得可写视图直接写入 (量化模型返回空视图)；
+   * 2. invoke() 执行推理；量化输出在此反量化到上下文预分配的 float 缓冲；
+   * 3. output() 读取音素后验 (始终为 float)，视图在下一次 invoke() 或租约析构前有效
+   * 全程无堆分配、无锁；未加载时租约为空
+   */
+  class Lease {
+   public:
+    Lease(Lease&& other) noexcept : runner_(other.runner_), ctx_(other.ctx_), epoch_(other.epoch_) {
+      other.ctx_ = nullptr;
+    }
+    Lease(const Lease&) = delete;
+    Lease& operator=(const Lease&) = delete;
+    Lease& operator=(Lease&&) = delete;
+    ~Lease();
+
+    explicit operator bool() const { return ctx_ != nullptr; }
+    FloatSpan input() const;
+    TensorInfo inputInfo() const;
+    /** 从张量第 offset 个元素起写入 n 个特征 (越界部分截断)；返回是否有可写张量 */
+    bool writeInput(size_t offset, const float* src, size_t n);
+    bool invoke();
+    ConstFloatSpan output() const;
+    TFLiteLoadTimings timings() const;
 
-  /** 推理：melInput 长度为 kInputSize，输出音素后验写入 posteriors */
+    /** 流式模型每次 invoke 应写入的新帧数；0 表示窗口模型 */
+    int chunkFrames() const;
+    /** 状态清零 (流不连续时调用：断流、积压超过滚动矩阵、换会话) */
+    void resetState();
+    /** 上下文代号：进程内唯一 (多个实例之间也不重复)；流式调用方据此发现状态已随模型更换而重置 */
+    uint64_t generation() const;
+
+    /**
+     * 流式状态的保存 / 恢复 (多个流轮流使用同一上下文时)：当前输入侧状态张量按下标顺序拼接
+     * bytes 须等于 stateBytes()；窗口模型为 0 字节
+     */
+    size_t stateBytes() const;
+    bool saveState(void* dst, size_t bytes) const;
+    bool loadState(const void* src, size_t bytes);
+
+   private:
+    friend class TFLiteRunner;
+    Lease(const TFLiteRunner* runner, TFLiteContext* ctx, uint32_t epoch)
+        : runner_(runner), ctx_(ctx), epoch_(epoch) {}
+    const TFLiteRunner* runner_;
+    TFLiteContext* ctx_;
+    uint32_t epoch_;  // 计入的读者组 (0 / 1)
+  };
+
+  Lease acquire() const;
+
+  /** 兼容接口：拷入 melInput 后推理，输出拷贝到 posteriors (会分配)；热路径请用 Lease */
   bool run(const float* melInput, size_t melLen, std::vector<float>* posteriors);
 
-  bool isLoaded() const { return loaded_; }
+  bool isLoaded() const { return current_.load(std::memory_order_acquire) != nullptr; }
+
+  /** 当前模型最近一次加载的耗时；可在任意线程读取 */
+  TFLiteLoadTimings loadTimings() const;
 
  private:
-  bool loaded_ = false;
+  // 构建 + 预跑；失败返回 nullptr
+  static TFLiteContext* build(const char* path, const TFLiteLoadOptions& options);
+  // 发布新上下文并回收旧上下文 (等待宽限期：翻转纪元前取得的 Lease 都已释放)；publishMutex_ 串行化
+  void publish(TFLiteContext* next);
+  // 加载线程：依次取最新请求构建并发布，直到析构
+  void loaderMain();
+
+  struct LoadRequest {
+    std::string path;
+    TFLiteLoadOptions options;
+    LoadCallback onDone = nullptr;
+    void* user = nullptr;
+  };
+
+  mutable std::atomic<TFLiteContext*> current_{nullptr};
+  std::atomic<uint32_t> epoch_{0};          // 低位选择新 Lease 计入的读者组
+  mutable std::atomic<int> readers_[2] = {};
+  std::mutex publishMutex_;
+  std::mutex loaderMutex_;  // 保护以下请求状态与 loader_ 的启动
+  std::condition_variable loaderCv_;
+  LoadRequest pending_;
+  bool hasPending_ = false;
+  bool stopping_ = false;
+  std::thread loader_;                // 首次后台请求时启动，析构时结束
+  std::atomic<bool> loading_{false};  // 请求登记时置位；加载线程处理完且无新请求时 (onDone 之后) 清除
 };
 
 }  // namespace silenceguard
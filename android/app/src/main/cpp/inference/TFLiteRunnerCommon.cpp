@@ -0,0 +1,302 @@
+// SilenceGuard Pro — TFLiteRunner 中与后端无关的部分 (tflite / stub 共用)
+// 加载线程与请求合并、RCU 发布与回收、推理租约、预跑与计时、量化输入 / 反量化输出、兼容 run() 接口
+
+#include "TFLiteContext.h"
+#include "QuantKernels.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <string>
+
+namespace silenceguard {
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// 回收旧上下文时轮询宽限期的间隔
+constexpr auto kGracePoll = std::chrono::microseconds(500);
+
+// 预跑用合成输入：静音附近的 log-Mel 电平
+constexpr float kWarmupLogMel = 0.0f;
+
+// 上下文代号：进程内所有 TFLiteRunner 共用，多个推理槽之间代号不重复
+std::atomic<uint64_t> nextGeneration{0};
+
+uint32_t elapsedUs(Clock::time_point since) {
+  auto us = std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - since).count();
+  return static_cast<uint32_t>(std::min<int64_t>(us, UINT32_MAX));
+}
+
+bool isQuantized(const TensorInfo& t) { return t.type != TensorType::kFloat32; }
+
+// 由后端填写的张量描述派生 float 输出视图；量化输出预分配反量化缓冲 (热路径不再分配)
+bool bindViews(TFLiteContext* ctx) {
+  const TensorInfo& in = ctx->inputTensor;
+  const TensorInfo& out = ctx->outputTensor;
+  if (!in.data || in.size == 0 || !out.data || out.size == 0) return false;
+  if ((isQuantized(in) && !(in.quant.scale > 0.0f)) || (isQuantized(out) && !(out.quant.scale > 0.0f))) {
+    fprintf(stderr, "[SilenceGuard] Invalid quantization scale\n");
+    return false;
+  }
+  if (isQuantized(out)) {
+    ctx->dequantized.reset(new float[out.size]());
+    ctx->output = {ctx->dequantized.get(), out.size};
+  } else {
+    ctx->output = {static_cast<const float*>(out.data), out.size};
+  }
+  return true;
+}
+
+bool writeTensor(const TensorInfo& t, size_t offset, const float* src, size_t n) {
+  if (!t.data) return false;
+  if (offset >= t.size) return true;
+  n = std::min(n, t.size - offset);
+  switch (t.type) {
+    case TensorType::kFloat32:
+      std::memcpy(static_cast<float*>(t.data) + offset, src, n * sizeof(float));
+      break;
+    case TensorType::kInt8:
+      quantizeToInt8(src, static_cast<int8_t*>(t.data) + offset, n, 1.0f / t.quant.scale, t.quant.zeroPoint);
+      break;
+    case TensorType::kUInt8:
+      quantizeToUInt8(src, static_cast<uint8_t*>(t.data) + offset, n, 1.0f / t.quant.scale, t.quant.zeroPoint);
+      break;
+  }
+  return true;
+}
+
+// 后端推理 + 输出视图刷新 (量化输出在此反量化)
+bool invokeContext(TFLiteContext* ctx) {
+  if (!ctx->invoke()) return false;
+  const TensorInfo& out = ctx->outputTensor;
+  if (!out.data) return false;
+  switch (out.type) {
+    case TensorType::kFloat32:
+      ctx->output.data = static_cast<const float*>(out.data);
+      break;
+    case TensorType::kInt8:
+      dequantizeInt8(static_cast<const int8_t*>(out.data), ctx->dequantized.get(), ctx->output.size,
+                     out.quant.scale, out.quant.zeroPoint);
+      break;
+    case TensorType::kUInt8:
+      dequantizeUInt8(static_cast<const uint8_t*>(out.data), ctx->dequantized.get(), ctx->output.size,
+                      out.quant.scale, out.quant.zeroPoint);
+      break;
+  }
+  return true;
+}
+
+bool invokeTimed(TFLiteContext* ctx) {
+  if (!ctx->firstInvokePending) return invokeContext(ctx);
+  const Clock::time_point t0 = Clock::now();
+  const bool ok = invokeContext(ctx);
+  if (ok) {
+    // 0 保留给 "尚未推理"
+    ctx->firstInferenceUs.store(std::max<uint32_t>(1, elapsedUs(t0)), std::memory_order_relaxed);
+    ctx->firstInvokePending = false;
+  }
+  return ok;
+}
+
+}  // namespace
+
+// ---------------------------------------------------------
+// 构建与发布
+// ---------------------------------------------------------
+
+TFLiteContext* TFLiteRunner::build(const char* path, const TFLiteLoadOptions& options) {
+  const Clock::time_point t0 = Clock::now();
+  std::unique_ptr<TFLiteContext> ctx = createTFLiteContext(path, options);
+  if (!ctx || !bindViews(ctx.get())) return nullptr;
+  ctx->numThreads.store(options.numThreads, std::memory_order_relaxed);
+  ctx->loadUs.store(elapsedUs(t0), std::memory_order_relaxed);
+
+  // 预跑：首个 Invoke 的惰性初始化 (内存规划、XNNPACK 权重打包) 在发布前完成
+  if (options.warmupRuns > 0) {
+    const Clock::time_point w0 = Clock::now();
+    float row[kInputMelBins];
+    std::fill(row, row + kInputMelBins, kWarmupLogMel);
+    for (int i = 0; i < options.warmupRuns; ++i) {
+      for (size_t off = 0; off < ctx->inputTensor.size; off += kInputMelBins)
+        writeTensor(ctx->inputTensor, off, row, kInputMelBins);
+      if (!invokeTimed(ctx.get())) break;
+    }
+    ctx->warmupUs.store(elapsedUs(w0), std::memory_order_relaxed);
+    // 预跑推进过的流式状态不能带进真实音频
+    ctx->resetState();
+  }
+  return ctx.release();
+}
+
+void TFLiteRunner::publish(TFLiteContext* next) {
+  std::lock_guard<std::mutex> lock(publishMutex_);
+  if (next) next->generation = nextGeneration.fetch_add(1, std::memory_order_relaxed) + 1;
+  TFLiteContext* old = current_.exchange(next, std::memory_order_seq_cst);
+  if (!old) return;
+  // 宽限期：能读到旧指针的 Lease 都在交换之前确认了纪元，因而计入翻转前的组；
+  // 翻转后新的 acquire 计入另一组，这一组只减不增 (确认失败的读者会立即退出)，等待有界
+  const uint32_t prev = epoch_.fetch_add(1, std::memory_order_seq_cst) & 1u;
+  while (readers_[prev].load(std::memory_order_seq_cst) != 0) std::this_thread::sleep_for(kGracePoll);
+  delete old;
+}
+
+TFLiteRunner::~TFLiteRunner() {
+  {
+    std::lock_guard<std::mutex> lock(loaderMutex_);
+    stopping_ = true;
+  }
+  loaderCv_.notify_all();
+  if (loader_.joinable()) loader_.join();
+  publish(nullptr);
+}
+
+bool TFLiteRunner::loadModel(const char* path) { return loadModel(path, TFLiteLoadOptions{}); }
+
+bool TFLiteRunner::loadModel(const char* path, const TFLiteLoadOptions& options) {
+  // 之前提交的后台请求先落地，不会在本次发布之后覆盖它
+  waitForLoad();
+  // 失败时保留旧模型继续服务
+  TFLiteContext* next = path ? build(path, options) : nullptr;
+  if (!next) return false;
+  publish(next);
+  return true;
+}
+
+void TFLiteRunner::loadModelAsync(const char* path, const TFLiteLoadOptions& options,
+                                  LoadCallback onDone, void* user) {
+  std::lock_guard<std::mutex> lock(loaderMutex_);
+  // 未开始的请求直接被覆盖；进行中的构建由加载线程在发布前发现已被取代
+  pending_ = LoadRequest{path ? path : "", options, onDone, user};
+  hasPending_ = true;
+  loading_.store(true, std::memory_order_release);
+  if (!loader_.joinable()) loader_ = std::thread(&TFLiteRunner::loaderMain, this);
+  loaderCv_.notify_all();
+}
+
+void TFLiteRunner::loaderMain() {
+  std::unique_lock<std::mutex> lock(loaderMutex_);
+  for (;;) {
+    loaderCv_.wait(lock, [this] { return stopping_ || hasPending_; });
+    if (stopping_) break;
+    const LoadRequest req = std::move(pending_);
+    hasPending_ = false;
+    lock.unlock();
+    TFLiteContext* next = req.path.empty() ? nullptr : build(req.path.c_str(), req.options);
+    lock.lock();
+    if (hasPending_ || stopping_) {
+      // 构建期间来了更新的请求：本次结果作废
+      delete next;
+      continue;
+    }
+    lock.unlock();
+    if (next) publish(next);
+    if (req.onDone) req.onDone(next != nullptr, req.path.c_str(), req.user);
+    lock.lock();
+    if (!hasPending_) {
+      loading_.store(false, std::memory_order_release);
+      loaderCv_.notify_all();
+    }
+  }
+  loading_.store(false, std::memory_order_release);
+  loaderCv_.notify_all();
+}
+
+bool TFLiteRunner::waitForLoad() {
+  std::unique_lock<std::mutex> lock(loaderMutex_);
+  loaderCv_.wait(lock, [this] { return !loading_.load(std::memory_order_acquire); });
+  return isLoaded();
+}
+
+// ---------------------------------------------------------
+// 租约 (读侧)
+// ---------------------------------------------------------
+
+TFLiteRunner::Lease TFLiteRunner::acquire() const {
+  // 计入当前纪元的组后确认纪元未翻转：否则发布方可能已开始等待那一组而看不到本次计数，
+  // 退出后计入新组 (发布方串行，重试次数有界)
+  uint32_t e = epoch_.load(std::memory_order_seq_cst) & 1u;
+  for (;;) {
+    readers_[e].fetch_add(1, std::memory_order_seq_cst);
+    const uint32_t now = epoch_.load(std::memory_order_seq_cst) & 1u;
+    if (now == e) break;
+    readers_[e].fetch_sub(1, std::memory_order_release);
+    e = now;
+  }
+  TFLiteContext* ctx = current_.load(std::memory_order_seq_cst);
+  if (!ctx) readers_[e].fetch_sub(1, std::memory_order_release);
+  return Lease(this, ctx, e);
+}
+
+TFLiteRunner::Lease::~Lease() {
+  if (ctx_) runner_->readers_[epoch_].fetch_sub(1, std::memory_order_release);
+}
+
+FloatSpan TFLiteRunner::Lease::input() const {
+  // 每次从张量描述派生：流式上下文换绑状态缓冲后输入缓冲可能移动
+  if (!ctx_ || isQuantized(ctx_->inputTensor)) return FloatSpan{};
+  return {static_cast<float*>(ctx_->inputTensor.data), ctx_->inputTensor.size};
+}
+
+TensorInfo TFLiteRunner::Lease::inputInfo() const { return ctx_ ? ctx_->inputTensor : TensorInfo{}; }
+
+bool TFLiteRunner::Lease::writeInput(size_t offset, const float* src, size_t n) {
+  return ctx_ && src && writeTensor(ctx_->inputTensor, offset, src, n);
+}
+
+bool TFLiteRunner::Lease::invoke() { return ctx_ && invokeTimed(ctx_); }
+
+ConstFloatSpan TFLiteRunner::Lease::output() const { return ctx_ ? ctx_->output : ConstFloatSpan{}; }
+
+TFLiteLoadTimings TFLiteRunner::Lease::timings() const {
+  TFLiteLoadTimings t;
+  if (!ctx_) return t;
+  t.loadUs = ctx_->loadUs.load(std::memory_order_relaxed);
+  t.warmupUs = ctx_->warmupUs.load(std::memory_order_relaxed);
+  t.firstInferenceUs = ctx_->firstInferenceUs.load(std::memory_order_relaxed);
+  t.numThreads = ctx_->numThreads.load(std::memory_order_relaxed);
+  t.xnnpackApplied = ctx_->xnnpackApplied.load(std::memory_order_relaxed);
+  t.inputType = ctx_->inputTensor.type;
+  t.outputType = ctx_->outputTensor.type;
+  t.chunkFrames = ctx_->chunkFrames;
+  t.stateTensors = ctx_->stateTensors;
+  return t;
+}
+
+int TFLiteRunner::Lease::chunkFrames() const { return ctx_ ? ctx_->chunkFrames : 0; }
+
+void TFLiteRunner::Lease::resetState() {
+  if (ctx_) ctx_->resetState();
+}
+
+uint64_t TFLiteRunner::Lease::generation() const { return ctx_ ? ctx_->generation : 0; }
+
+size_t TFLiteRunner::Lease::stateBytes() const { return ctx_ ? ctx_->stateBytes() : 0; }
+
+bool TFLiteRunner::Lease::saveState(void* dst, size_t bytes) const {
+  if (!ctx_ || (bytes > 0 && !dst) || bytes != ctx_->stateBytes()) return false;
+  ctx_->saveState(static_cast<uint8_t*>(dst));
+  return true;
+}
+
+bool TFLiteRunner::Lease::loadState(const void* src, size_t bytes) {
+  if (!ctx_ || (bytes > 0 && !src) || bytes != ctx_->stateBytes()) return false;
+  ctx_->loadState(static_cast<const uint8_t*>(src));
+  return true;
+}
+
+TFLiteLoadTimings TFLiteRunner::loadTimings() const { return acquire().timings(); }
+
+bool TFLiteRunner::run(const float* melInput, size_t melLen, std::vector<float>* posteriors) {
+  if (!melInput || !posteriors) return false;
+  Lease lease = acquire();
+  // 超长输入截断到张量大小
+  if (!lease.writeInput(0, melInput, melLen) || !lease.invoke()) return false;
+
+  ConstFloatSpan out = lease.output();
+  posteriors->assign(out.data, out.data + out.size);
+  return true;
+}
+
+}  // namespace silenceguard
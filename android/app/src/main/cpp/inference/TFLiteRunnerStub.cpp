@@ -0,0 +1,210 @@
+// SilenceGuard Pro — 确定性推理桩 (SG_INFERENCE_BACKEND=stub)
+// 无需 Prefab / TensorFlowLite：host 回放、CI 与性能回归使用
+// 输出单一 "风险" 后验 = 最近 kStubFrames 帧平均 log-Mel 能量的线性映射 [0, 1]；
+// 只是能量代理，不做关键词识别；相同输入必得相同输出
+// 模型路径含 "int8" / "uint8" 时模拟全整型量化模型 (量化输入、量化输出)，供 float / int8 对比；
+// 含 "stream" 时模拟带显式状态输入输出的流式编码器；
+// 含 "phoneme" 时输出 [帧 × 音素单元] 后验 (默认声母 / 韵母表)，供关键词检索链路回放；
+// 含 "slowN" 时每次推理额外忙等 N ms / 线程数 (默认 20ms)，模拟重模型，供算力调节器演示
+
+#include "TFLiteContext.h"
+#include "KeywordGraph.h"
+#include <algorithm>
+#include <chrono>
+#include <cctype>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <vector>
+
+namespace silenceguard {
+
+namespace {
+
+constexpr int kStubFrames = 10;          // 最近 100ms
+constexpr float kStubQuietLogMel = 12.0f;   // ≈ -50 dBFS 底噪
+constexpr float kStubLoudLogMel = 18.0f;    // ≈ -20 dBFS 人声
+
+// 量化变体的参数：log-Mel 在 [-32, 32) 内 (静音约 -21，人声约 +21)；
+// 输出按 TFLite 全整型 softmax 惯例 scale 1/256、int8 零点 -128
+constexpr float kStubInputScale = 0.25f;
+constexpr float kStubOutputScale = 1.0f / 256.0f;
+
+inline float stubRisk(float meanLogMel) {
+  float p = (meanLogMel - kStubQuietLogMel) / (kStubLoudLogMel - kStubQuietLogMel);
+  return std::max(0.0f, std::min(1.0f, p));
+}
+
+// 模拟解释器持有的输入 / 输出张量 (每个上下文独立)
+struct StubContext : TFLiteContext {
+  float inputData[kInputSize] = {};
+  float outputData[1] = {};
+
+  StubContext() {
+    inputTensor = {TensorType::kFloat32, {}, inputData, kInputSize};
+    outputTensor = {TensorType::kFloat32, {}, outputData, 1};
+  }
+
+  bool invoke() override {
+    const float* tail = inputData + (kInputFrames - kStubFrames) * kInputMelBins;
+    float sum = 0.0f;
+    for (int i = 0; i < kStubFrames * kInputMelBins; ++i) sum += tail[i];
+    outputData[0] = stubRisk(sum / static_cast<float>(kStubFrames * kInputMelBins));
+    return true;
+  }
+};
+
+// 慢速变体 (模型路径含 "slowN")：输出同默认变体，每次推理忙等固定时长；线程数越多耗时越短
+struct SlowStubContext : StubContext {
+  std::chrono::nanoseconds spin;
+
+  explicit SlowStubContext(std::chrono::nanoseconds s) : spin(s) {}
+
+  bool invoke() override {
+    const auto until = std::chrono::steady_clock::now() + spin;
+    while (std::chrono::steady_clock::now() < until) {
+    }
+    return StubContext::invoke();
+  }
+};
+
+// 全整型变体 (模型路径含 "int8" / "uint8")：整数累加，输出再量化，模拟量化模型的数据通路
+template <typename Q>
+struct QuantizedStubContext : TFLiteContext {
+  static constexpr TensorType kType = sizeof(Q) == 1 && Q(-1) < Q(0) ? TensorType::kInt8 : TensorType::kUInt8;
+  static constexpr int32_t kInputZeroPoint = kType == TensorType::kInt8 ? 0 : 128;
+  static constexpr int32_t kOutputZeroPoint = kType == TensorType::kInt8 ? -128 : 0;
+
+  Q inputData[kInputSize] = {};
+  Q outputData[1] = {};
+
+  QuantizedStubContext() {
+    inputTensor = {kType, {kStubInputScale, kInputZeroPoint}, inputData, kInputSize};
+    outputTensor = {kType, {kStubOutputScale, kOutputZeroPoint}, outputData, 1};
+  }
+
+  bool invoke() override {
+    const Q* tail = inputData + (kInputFrames - kStubFrames) * kInputMelBins;
+    int32_t sum = 0;
+    for (int i = 0; i < kStubFrames * kInputMelBins; ++i) sum += tail[i];
+    const float meanQ = static_cast<float>(sum) / static_cast<float>(kStubFrames * kInputMelBins);
+    const float p = stubRisk((meanQ - kInputZeroPoint) * kStubInputScale);
+    const int32_t q = static_cast<int32_t>(std::lrint(p / kStubOutputScale)) + kOutputZeroPoint;
+    outputData[0] = static_cast<Q>(std::min<int32_t>(std::numeric_limits<Q>::max(), q));
+    return true;
+  }
+};
+
+// 流式变体 (模型路径含 "stream")：每次只送入 kStubChunkFrames 个新帧，
+// 状态 = 最近 kStubFrames 帧的逐帧均值；与窗口变体在步长 = 块长时给出相同后验
+constexpr int kStubChunkFrames = 16;  // 160ms，与默认推理步长一致
+
+struct StreamingStubContext : TFLiteContext {
+  float inputData[kStubChunkFrames * kInputMelBins] = {};
+  float outputData[1] = {};
+  float stateData[2][kStubFrames] = {};  // 乒乓状态缓冲
+  int parity = 0;                        // stateData[parity] 为当前输入状态
+
+  StreamingStubContext() {
+    inputTensor = {TensorType::kFloat32, {}, inputData, kStubChunkFrames * kInputMelBins};
+    outputTensor = {TensorType::kFloat32, {}, outputData, 1};
+    chunkFrames = kStubChunkFrames;
+    stateTensors = 1;
+  }
+
+  bool invoke() override {
+    const float* stateIn = stateData[parity];
+    float* stateOut = stateData[parity ^ 1];
+    // 新状态 = (旧状态 ++ 本块逐帧均值) 的最后 kStubFrames 项
+    float frameMean[kStubChunkFrames];
+    for (int f = 0; f < kStubChunkFrames; ++f) {
+      float sum = 0.0f;
+      for (int b = 0; b < kInputMelBins; ++b) sum += inputData[f * kInputMelBins + b];
+      frameMean[f] = sum / static_cast<float>(kInputMelBins);
+    }
+    for (int i = 0; i < kStubFrames; ++i) {
+      const int src = i + kStubChunkFrames;  // 在 (旧状态 ++ 新帧) 序列中的下标
+      stateOut[i] = src < kStubFrames ? stateIn[src] : frameMean[src - kStubFrames];
+    }
+    float sum = 0.0f;
+    for (int i = 0; i < kStubFrames; ++i) sum += stateOut[i];
+    outputData[0] = stubRisk(sum / static_cast<float>(kStubFrames));
+    parity ^= 1;  // 输出状态直接成为下一次的输入状态
+    return true;
+  }
+
+  void resetState() override {
+    std::fill(&stateData[0][0], &stateData[0][0] + 2 * kStubFrames, 0.0f);
+    parity = 0;
+  }
+
+  size_t stateBytes() const override { return sizeof(stateData[0]); }
+  void saveState(uint8_t* dst) const override { std::memcpy(dst, stateData[parity], sizeof(stateData[0])); }
+  void loadState(const uint8_t* src) override { std::memcpy(stateData[parity], src, sizeof(stateData[0])); }
+};
+
+// 音素后验变体 (模型路径含 "phoneme")：逐帧输出默认单元表上的分布；
+// 峰值频带低于 kStubVoicedLogMel 的帧为 blank，其余帧的单元由峰值 Mel 频带线性映射
+// (纯音序列即可拼出任意单元序列)
+constexpr float kStubPhonemePeak = 0.9f;
+constexpr float kStubVoicedLogMel = 20.0f;
+
+struct PhonemeStubContext : TFLiteContext {
+  float inputData[kInputSize] = {};
+  std::vector<float> outputData;
+  int units;
+
+  PhonemeStubContext() : units(PhonemeUnits().size()) {
+    outputData.assign(static_cast<size_t>(kInputFrames) * units, 0.0f);
+    inputTensor = {TensorType::kFloat32, {}, inputData, kInputSize};
+    outputTensor = {TensorType::kFloat32, {}, outputData.data(), outputData.size()};
+  }
+
+  bool invoke() override {
+    const float rest = (1.0f - kStubPhonemePeak) / static_cast<float>(units - 1);
+    for (int f = 0; f < kInputFrames; ++f) {
+      const float* row = inputData + f * kInputMelBins;
+      const int peakBin = static_cast<int>(std::max_element(row, row + kInputMelBins) - row);
+      const int unit = row[peakBin] >= kStubVoicedLogMel ? 1 + peakBin * (units - 1) / kInputMelBins : 0;
+      float* out = outputData.data() + static_cast<size_t>(f) * units;
+      std::fill(out, out + units, rest);
+      out[unit] = kStubPhonemePeak;
+    }
+    return true;
+  }
+};
+
+}  // namespace
+
+std::unique_ptr<TFLiteContext> createTFLiteContext(const char* path, const TFLiteLoadOptions& options) {
+  // 路径只用于选择变体 (float / int8 / uint8 / stream / phoneme / slow)，不读文件
+  const char* name = path ? path : "(null)";
+  if (const char* slow = std::strstr(name, "slow")) {
+    const long ms = std::isdigit(static_cast<unsigned char>(slow[4])) ? std::strtol(slow + 4, nullptr, 10) : 20;
+    const int threads = std::max(1, options.numThreads);
+    printf("[SilenceGuard] Stub inference backend, slow variant %ld ms / %d threads (%s)\n", ms, threads, name);
+    return std::make_unique<SlowStubContext>(std::chrono::milliseconds(ms) / threads);
+  }
+  if (std::strstr(name, "phoneme")) {
+    printf("[SilenceGuard] Stub inference backend, phoneme posterior variant (%s)\n", name);
+    return std::make_unique<PhonemeStubContext>();
+  }
+  if (std::strstr(name, "stream")) {
+    printf("[SilenceGuard] Stub inference backend, streaming variant (%s)\n", name);
+    return std::make_unique<StreamingStubContext>();
+  }
+  if (std::strstr(name, "uint8")) {
+    printf("[SilenceGuard] Stub inference backend, uint8 variant (%s)\n", name);
+    return std::make_unique<QuantizedStubContext<uint8_t>>();
+  }
+  if (std::strstr(name, "int8")) {
+    printf("[SilenceGuard] Stub inference backend, int8 variant (%s)\n", name);
+    return std::make_unique<QuantizedStubContext<int8_t>>();
+  }
+  printf("[SilenceGuard] Stub inference backend (model path ignored: %s)\n", name);
+  return std::make_unique<StubContext>();
+}
+
+}  // namespace silenceguard
@@ -1,6 +1,9 @@
 // C 接口供 Engine / 变体匹配调用 (NEXT_IMPROVEMENTS §3.2)
 
 #include "ConfMatrix.h"
+#include "EditDistance.h"
+#include "PhonemeDtw.h"
+#include <vector>
 
 extern "C" {
 
@@ -8,12 +11,42 @@ int ConfMatrix_load(const char* path) {
   return silenceguard::loadConfMatrix(path) ? 1 : 0;
 }
 
-int ConfMatrix_getPhonemeVariants(const char* target, const char** outVariants, int maxOut) {
-  return silenceguard::getPhonemeVariants(target, outVariants, maxOut);
+// JSON → 二进制 (mmap 形式)；成功返回 1
+int ConfMatrix_compile(const char* jsonPath, const char* binaryPath) {
+  return silenceguard::compileConfMatrix(jsonPath, binaryPath) ? 1 : 0;
+}
+
+// 变体名字拷入调用方的 nameBuf，outVariants[i] 指向其中；返回写入数量
+int ConfMatrix_getPhonemeVariants(const char* target, char* nameBuf, size_t bufBytes, const char** outVariants,
+                                  int maxOut) {
+  return silenceguard::getPhonemeVariants(target, nameBuf, bufBytes, outVariants, maxOut);
 }
 
 float ConfMatrix_calculatePhonemeSimilarity(const float* a, int lenA, const float* b, int lenB) {
   return silenceguard::calculatePhonemeSimilarity(a, lenA, b, lenB);
 }
 
+float ConfMatrix_calculateStringSimilarity(const char* s1, const char* s2) {
+  return silenceguard::calculateStringSimilarity(s1, s2);
+}
+
+// 一个拼音串对整个词表打分：maxDistance < 0 不截断；返回距离最小的候选下标或 -1 (similarities 可为 NULL)
+int ConfMatrix_scoreKeywords(const char* query, const char* const* candidates, int count, int maxDistance,
+                             int* distances, float* similarities) {
+  return silenceguard::editDistanceBatch(query, candidates, count, maxDistance, distances, similarities);
+}
+
+// 批量模板匹配：templates[k] 为 [lengths[k] × dim] 后验；band < 0 取默认斜带；返回最优模板下标或 -1
+int ConfMatrix_matchPhonemeTemplates(const float* window, int frames, int dim, const float* const* templates,
+                                     const int* lengths, int count, int band, float minSimilarity, float* scores) {
+  if (!templates || !lengths || !scores || count <= 0) return -1;
+  std::vector<silenceguard::PhonemeTemplate> views(static_cast<size_t>(count));
+  for (int k = 0; k < count; ++k) views[k] = {templates[k], lengths[k]};
+  silenceguard::DtwOptions options;
+  options.band = band;
+  options.minSimilarity = minSimilarity;
+  silenceguard::PhonemeTemplateMatcher matcher;
+  return matcher.match(window, frames, dim, views.data(), count, options, scores);
+}
+
 }  // extern "C"
@@ -1,7 +1,8 @@
 // C 接口供 Engine 调用 (Phase 2 识变)
 
 #include "TFLiteRunner.h"
-#include <vector>
+#include <algorithm>
+#include <cstring>
 
 static silenceguard::TFLiteRunner s_runner;
 
@@ -12,10 +13,14 @@ int TFLiteRunner_loadModel(const char* path) {
 }
 
 int TFLiteRunner_run(const float* melInput, size_t melLen, float* outPosteriors, size_t outLen) {
-  std::vector<float> posteriors;
-  if (!s_runner.run(melInput, melLen, &posteriors)) return 0;
-  size_t n = (posteriors.size() < outLen) ? posteriors.size() : outLen;
-  for (size_t i = 0; i < n; ++i) outPosteriors[i] = posteriors[i];
+  silenceguard::TFLiteRunner::Lease model = s_runner.acquire();
+  silenceguard::FloatSpan in = model.input();
+  if (!melInput || !in.data) return 0;
+  std::memcpy(in.data, melInput, std::min(melLen, in.size) * sizeof(float));
+  if (!model.invoke()) return 0;
+  silenceguard::ConstFloatSpan out = model.output();
+  size_t n = std::min(out.size, outLen);
+  std::memcpy(outPosteriors, out.data, n * sizeof(float));
   return static_cast<int>(n);
 }
 
@@ -1,4 +1,5 @@
 #include "AudioInjector.h"
+#include "PcmKernels.h"
 #include <cmath>
 #include <algorithm>
 #include <random>
@@ -10,10 +11,10 @@ namespace silenceguard {
 // =========================================================
 
 NoiseMasker::NoiseMasker(float sampleRate) 
-    : sampleRate_(sampleRate), dist_(-1.0f, 1.0f) {
+    : sampleRate_(sampleRate), noise_(0) {
   // 初始化随机种子
   std::random_device rd;
-  rng_.seed(rd());
+  noise_.seed((static_cast<uint64_t>(rd()) << 32) | rd());
   
   // 初始化默认参数
   // Attack=10ms: 快速捕捉辅音爆发
@@ -28,42 +29,41 @@ void NoiseMasker::setEnvelopeParams(float attackMs, float releaseMs) {
 
   // 计算一阶低通滤波器系数公式: coeff = 1 - exp( -1 / (time * fs) )
   // 此处使用高精度计算确保滤波器稳定性
-  attackCoeff_ = 1.0f - std::exp(-1000.0f / (attackMs * sampleRate_));
-  releaseCoeff_ = 1.0f - std::exp(-1000.0f / (releaseMs * sampleRate_));
+  attackCoeff_.store(1.0f - std::exp(-1000.0f / (attackMs * sampleRate_)), std::memory_order_relaxed);
+  releaseCoeff_.store(1.0f - std::exp(-1000.0f / (releaseMs * sampleRate_)), std::memory_order_relaxed);
 }
 
 void NoiseMasker::process(int16_t* buffer, size_t frames) {
-  const float kInt16Max = 32767.0f;
-  
-  for (size_t i = 0; i < frames; ++i) {
-    // 1. 归一化输入 [-1.0, 1.0]
-    float input = static_cast<float>(buffer[i]) / kInt16Max;
-    float inputAbs = std::abs(input);
+  float input[kBlockFrames];
+  float envelope[kBlockFrames];
+  float noise[kBlockFrames];
+  const float attackCoeff = attackCoeff_.load(std::memory_order_relaxed);
+  const float releaseCoeff = releaseCoeff_.load(std::memory_order_relaxed);
 
-    // 2. 包络跟随 (Envelope Follower)
-    // 模拟电路中的检波器行为
-    if (inputAbs > currentEnvelope_) {
-      // Attack Phase: 信号增强，快速充电
-      currentEnvelope_ += attackCoeff_ * (inputAbs - currentEnvelope_);
-    } else {
-      // Release Phase: 信号减弱，缓慢放电
-      currentEnvelope_ += releaseCoeff_ * (inputAbs - currentEnvelope_);
-    }
+  for (size_t pos = 0; pos < frames; pos += kBlockFrames) {
+    const size_t n = std::min(kBlockFrames, frames - pos);
+    int16_t* block = buffer + pos;
 
-    // 3. 生成白噪声 (White Noise) N(t)
-    float noise = dist_(rng_);
+    // 1. 归一化输入 [-1.0, 1.0] (向量化)
+    int16ToFloat(block, input, n);
 
-    // 4. 调制 (Modulation) N_mod(t) = N(t) * E(t)
-    // 用提取的包络去控制噪声的幅度
-    float output = noise * currentEnvelope_ * makeUpGain_;
+    // 2. 包络跟随 (Envelope Follower)
+    // 模拟电路中的检波器行为；一阶递归，逐样本串行
+    float env = currentEnvelope_;
+    for (size_t i = 0; i < n; ++i) {
+      float inputAbs = std::abs(input[i]);
+      // Attack Phase: 信号增强，快速充电 / Release Phase: 信号减弱，缓慢放电
+      float coeff = (inputAbs > env) ? attackCoeff : releaseCoeff;
+      env += coeff * (inputAbs - env);
+      envelope[i] = env;
+    }
+    currentEnvelope_ = env;
 
-    // 5. 软限幅 (Soft Clipping)
-    // 防止调制后的噪声峰值溢出，比硬截断更自然
-    if (output > 1.0f) output = 1.0f;
-    if (output < -1.0f) output = -1.0f;
+    // 3. 生成白噪声 (White Noise) N(t)，每步 8 个样本
+    noise_.fill(noise, n);
 
-    // 6. 写入输出
-    buffer[i] = static_cast<int16_t>(output * kInt16Max);
+    // 4-6. 调制 N_mod(t) = N(t) * E(t) * gain → 软限幅 → 写入输出 (向量化)
+    modulateToInt16(noise, envelope, makeUpGain_, block, n);
   }
 }
 
@@ -72,36 +72,100 @@ void NoiseMasker::process(int16_t* buffer, size_t frames) {
 // =========================================================
 
 namespace {
-constexpr float kPi = 3.14159265358979f;
-constexpr float kAmplitude = 0.4f;
+constexpr size_t kToneBlockFrames = 256;
+
+// 兼容接口共用的振荡器：跨 HAL 回调保持相位，消除每个 buffer 开头的相位跳变
+ToneGenerator& defaultTone() {
+  static ToneGenerator tone(static_cast<float>(kBeepFreqHz),
+                            static_cast<float>(kInjectorSampleRate), kBeepAmplitude);
+  return tone;
 }
 
-float generateSineSample(int frameIndex, float phaseRad) {
-  float t = static_cast<float>(frameIndex) / static_cast<float>(kSampleRate);
-  return kAmplitude * std::sin(2.f * kPi * kBeepFreqHz * t + phaseRad);
+// g_i = clamp(gainStart + i·gainStep, 0, 1) 为哔声权重，按块生成哔声并一次完成混音
+// 多声道：每块哔声只生成一次，各声道取出为连续样本混音后写回
+void mixTone(ToneGenerator& tone, int16_t* buffer, size_t frames, float gainStart, float gainStep, int channels) {
+  float beep[kToneBlockFrames];
+  int16_t lane[kToneBlockFrames];
+  const size_t ch = static_cast<size_t>(std::max(1, channels));
+  for (size_t pos = 0; pos < frames; pos += kToneBlockFrames) {
+    const size_t n = std::min(kToneBlockFrames, frames - pos);
+    const float start = gainStart + static_cast<float>(pos) * gainStep;
+    tone.fill(beep, n);
+    if (ch == 1) {
+      crossFadeToInt16(buffer + pos, beep, n, start, gainStep);
+      continue;
+    }
+    int16_t* block = buffer + pos * ch;
+    for (size_t c = 0; c < ch; ++c) {
+      for (size_t i = 0; i < n; ++i) lane[i] = block[i * ch + c];
+      crossFadeToInt16(lane, beep, n, start, gainStep);
+      for (size_t i = 0; i < n; ++i) block[i * ch + c] = lane[i];
+    }
+  }
+}
+}  // namespace
+
+void setToneSampleRate(int sampleRate) {
+  if (sampleRate > 0) defaultTone().setSampleRate(static_cast<float>(sampleRate));
 }
 
-void applyBeep(int16_t* buffer, size_t frames) {
-  const float scale = 32767.f;
-  for (size_t i = 0; i < frames; ++i) {
-    float s = generateSineSample(static_cast<int>(i), 0.f);
-    buffer[i] = static_cast<int16_t>(std::max(-32768.f, std::min(32767.f, s * scale)));
+void applyBeep(ToneGenerator& tone, int16_t* buffer, size_t frames, int channels) {
+  float beep[kToneBlockFrames];
+  int16_t pcm[kToneBlockFrames];
+  const size_t ch = static_cast<size_t>(std::max(1, channels));
+  for (size_t pos = 0; pos < frames; pos += kToneBlockFrames) {
+    const size_t n = std::min(kToneBlockFrames, frames - pos);
+    tone.fill(beep, n);
+    if (ch == 1) {
+      floatToInt16(beep, buffer + pos, n);
+      continue;
+    }
+    floatToInt16(beep, pcm, n);
+    int16_t* block = buffer + pos * ch;
+    for (size_t i = 0; i < n; ++i) std::fill(block + i * ch, block + (i + 1) * ch, pcm[i]);
   }
 }
 
-void applyCrossFade(int16_t* buffer, size_t frames, size_t crossFadeFrames) {
+void applyBeep(ToneGenerator& tone, float* buffer, size_t frames, int channels) {
+  float beep[kToneBlockFrames];
+  const size_t ch = static_cast<size_t>(std::max(1, channels));
+  for (size_t pos = 0; pos < frames; pos += kToneBlockFrames) {
+    const size_t n = std::min(kToneBlockFrames, frames - pos);
+    tone.fill(beep, n);
+    float* block = buffer + pos * ch;
+    for (size_t i = 0; i < n; ++i) std::fill(block + i * ch, block + (i + 1) * ch, beep[i]);
+  }
+}
+
+void applyCrossFade(ToneGenerator& tone, int16_t* buffer, size_t frames, size_t crossFadeFrames, int channels) {
   if (crossFadeFrames == 0 || frames < crossFadeFrames) {
-    applyBeep(buffer, frames);
+    applyBeep(tone, buffer, frames, channels);
     return;
   }
-  const float scale = 32767.f;
-  for (size_t i = 0; i < frames; ++i) {
-    float alpha = (i < crossFadeFrames) ? (static_cast<float>(i) / static_cast<float>(crossFadeFrames)) : 1.f;
-    float original = static_cast<float>(buffer[i]) / scale * (1.f - alpha);
-    float beep = generateSineSample(static_cast<int>(i), 0.f) * alpha;
-    float mixed = original + beep;
-    buffer[i] = static_cast<int16_t>(std::max(-32768.f, std::min(32767.f, mixed * scale)));
+  // 哔声权重 i / xf，越过淡化区后被钳到 1 即纯哔声
+  const float step = 1.f / static_cast<float>(crossFadeFrames);
+  mixTone(tone, buffer, frames, 0.f, step, channels);
+}
+
+void applyCrossFadeOut(ToneGenerator& tone, int16_t* buffer, size_t frames, size_t crossFadeFrames, int channels) {
+  if (crossFadeFrames == 0 || frames < crossFadeFrames) {
+    applyBeep(tone, buffer, frames, channels);
+    return;
   }
+  // 哔声权重 1 - (i - fadeStart + 1) / xf，淡化区之前被钳到 1
+  const float step = 1.f / static_cast<float>(crossFadeFrames);
+  const size_t fadeStart = frames - crossFadeFrames;
+  mixTone(tone, buffer, frames, static_cast<float>(crossFadeFrames + fadeStart - 1) * step, -step, channels);
+}
+
+void applyBeep(int16_t* buffer, size_t frames) { applyBeep(defaultTone(), buffer, frames); }
+
+void applyCrossFade(int16_t* buffer, size_t frames, size_t crossFadeFrames) {
+  applyCrossFade(defaultTone(), buffer, frames, crossFadeFrames);
+}
+
+void applyCrossFadeOut(int16_t* buffer, size_t frames, size_t crossFadeFrames) {
+  applyCrossFadeOut(defaultTone(), buffer, frames, crossFadeFrames);
 }
 
 }  // namespace silenceguard
@@ -1,15 +1,18 @@
 #pragma once
 
+#include "NoiseGenerator.h"
+#include "ToneGenerator.h"
+#include <atomic>
 #include <cstdint>
 #include <cstddef>
-#include <random>
 #include <vector>
 
 namespace silenceguard {
 
 // 采样率常量，与白皮书一致 (48kHz 或 16kHz，此处默认 16kHz 用于处理)
-constexpr int kSampleRate = 16000;
+constexpr int kInjectorSampleRate = 16000;
 constexpr int kBeepFreqHz = 1000;
+constexpr float kBeepAmplitude = 0.4f;
 
 /**
  * 核心升级：噪声掩蔽器 (Stateful)
@@ -17,35 +20,41 @@ constexpr int kBeepFreqHz = 1000;
  */
 class NoiseMasker {
  public:
-  explicit NoiseMasker(float sampleRate = static_cast<float>(kSampleRate));
+  explicit NoiseMasker(float sampleRate = static_cast<float>(kInjectorSampleRate));
 
   /**
    * 核心处理函数：原地(In-place)将输入 buffer 中的人声替换为掩蔽噪声
+   * 按块处理：向量化 int16→float / 噪声生成 / 调制输出，包络跟随逐样本且与旧实现逐位一致；无堆分配
    * @param buffer PCM音频数据
    * @param frames 帧数
    */
   void process(int16_t* buffer, size_t frames);
 
   /**
-   * 动态调整包络参数 (支持从 Web 端下发配置)
+   * 动态调整包络参数 (支持从 Web 端下发配置)；可在任意线程调用，下一块 process 生效
    * @param attackMs 起步时间 (默认 10ms): 越小反应越快
    * @param releaseMs 释放时间 (默认 50ms): 越大声音拖尾越长，越平滑
    */
   void setEnvelopeParams(float attackMs, float releaseMs);
 
+  /** 固定噪声种子 (构造时取随机种子)；离线比对 / 基准用，与 process 同一线程调用 */
+  void seed(uint64_t seed) { noise_.seed(seed); }
+
  private:
   float sampleRate_;
   
-  // 随机数生成器 (用于生成高质量白噪声)
-  std::mt19937 rng_;
-  std::uniform_real_distribution<float> dist_;
+  // 块大小：栈上暂存 input / envelope / noise
+  static constexpr size_t kBlockFrames = 256;
+
+  // 向量化白噪声源 (8 路 xoshiro128+)
+  NoiseGenerator noise_;
 
   // 包络跟随器状态 (记忆上一帧的能量)
   float currentEnvelope_ = 0.0f;
   
-  // 滤波器系数 (根据 attack/release 时间计算)
-  float attackCoeff_ = 0.0f;
-  float releaseCoeff_ = 0.0f;
+  // 滤波器系数 (根据 attack/release 时间计算)；配置线程写、音频线程每块读一次
+  std::atomic<float> attackCoeff_{0.0f};
+  std::atomic<float> releaseCoeff_{0.0f};
 
   // 妆容增益 (Make-up Gain)，补偿噪声听感上的能量损失
   float makeUpGain_ = 1.0f;
@@ -53,8 +62,24 @@ class NoiseMasker {
 
 // ---------------------------------------------------------
 // 兼容接口 (Legacy / Fallback)
+// 哔声由 ToneGenerator 递推生成、相位跨调用连续；淡化与混音一次完成 (向量化、饱和)
+// 不带振荡器参数的版本共用一个默认振荡器 (仅音频线程调用)
+// channels > 1 时 buffer 为交错多声道：每帧各声道写入同一哔声样本、淡化增益相同
 // ---------------------------------------------------------
+
+/** 默认振荡器改用 HAL 实际采样率 (保持当前相位)，哔声频率不随采样率漂移 */
+void setToneSampleRate(int sampleRate);
+
+void applyBeep(ToneGenerator& tone, int16_t* buffer, size_t frames, int channels = 1);
+void applyCrossFade(ToneGenerator& tone, int16_t* buffer, size_t frames, size_t crossFadeFrames, int channels = 1);
+void applyCrossFadeOut(ToneGenerator& tone, int16_t* buffer, size_t frames, size_t crossFadeFrames,
+                       int channels = 1);
+/** float32 采集流 (值域 [-1, 1]) 的哔声 */
+void applyBeep(ToneGenerator& tone, float* buffer, size_t frames, int channels = 1);
+
 void applyBeep(int16_t* buffer, size_t frames);
 void applyCrossFade(int16_t* buffer, size_t frames, size_t crossFadeFrames);
+/** 与 applyCrossFade 相反：前 frames - crossFadeFrames 为哔声，最后 crossFadeFrames 由哔声渐回原声 */
+void applyCrossFadeOut(int16_t* buffer, size_t frames, size_t crossFadeFrames);
 
 }  // namespace silenceguard
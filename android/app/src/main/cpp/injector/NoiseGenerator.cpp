@@ -0,0 +1,125 @@
+#include "NoiseGenerator.h"
+#include <cstring>
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define SG_NOISE_NEON 1
+#elif defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define SG_NOISE_SSE2 1
+#endif
+
+namespace silenceguard {
+
+namespace {
+
+// SplitMix64：把单个种子展开为各路互不相关的初始状态
+uint64_t splitMix64(uint64_t& x) {
+  uint64_t z = (x += 0x9E3779B97F4A7C15ull);
+  z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+  z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+  return z ^ (z >> 31);
+}
+
+// 高 23 位放入 [1, 2) 的尾数，再映射到 [-1, 1)
+inline float bitsToUnit(uint32_t r) {
+  uint32_t bits = (r >> 9) | 0x3F800000u;
+  float f;
+  std::memcpy(&f, &bits, sizeof(f));
+  return f * 2.0f - 3.0f;
+}
+
+}  // namespace
+
+NoiseGenerator::NoiseGenerator(uint64_t seed) { this->seed(seed); }
+
+void NoiseGenerator::seed(uint64_t seed) {
+  for (size_t lane = 0; lane < kLanes; ++lane) {
+    uint64_t a = splitMix64(seed), b = splitMix64(seed);
+    s_[0][lane] = static_cast<uint32_t>(a);
+    s_[1][lane] = static_cast<uint32_t>(a >> 32);
+    s_[2][lane] = static_cast<uint32_t>(b);
+    s_[3][lane] = static_cast<uint32_t>(b >> 32) | 1u;  // 状态不得全零
+  }
+}
+
+void NoiseGenerator::fill(float* out, size_t n) {
+  size_t i = 0;
+#if defined(SG_NOISE_SSE2)
+  __m128i s0[2], s1[2], s2[2], s3[2];
+  for (int h = 0; h < 2; ++h) {
+    s0[h] = _mm_load_si128(reinterpret_cast<const __m128i*>(&s_[0][4 * h]));
+    s1[h] = _mm_load_si128(reinterpret_cast<const __m128i*>(&s_[1][4 * h]));
+    s2[h] = _mm_load_si128(reinterpret_cast<const __m128i*>(&s_[2][4 * h]));
+    s3[h] = _mm_load_si128(reinterpret_cast<const __m128i*>(&s_[3][4 * h]));
+  }
+  const __m128i exp1 = _mm_set1_epi32(0x3F800000);
+  const __m128 two = _mm_set1_ps(2.0f), three = _mm_set1_ps(3.0f);
+  for (; i + kLanes <= n; i += kLanes) {
+    for (int h = 0; h < 2; ++h) {
+      __m128i r = _mm_add_epi32(s0[h], s3[h]);
+      __m128i t = _mm_slli_epi32(s1[h], 9);
+      s2[h] = _mm_xor_si128(s2[h], s0[h]);
+      s3[h] = _mm_xor_si128(s3[h], s1[h]);
+      s1[h] = _mm_xor_si128(s1[h], s2[h]);
+      s0[h] = _mm_xor_si128(s0[h], s3[h]);
+      s2[h] = _mm_xor_si128(s2[h], t);
+      s3[h] = _mm_or_si128(_mm_slli_epi32(s3[h], 11), _mm_srli_epi32(s3[h], 21));
+      __m128 f = _mm_castsi128_ps(_mm_or_si128(_mm_srli_epi32(r, 9), exp1));
+      _mm_storeu_ps(out + i + 4 * h, _mm_sub_ps(_mm_mul_ps(f, two), three));
+    }
+  }
+  for (int h = 0; h < 2; ++h) {
+    _mm_store_si128(reinterpret_cast<__m128i*>(&s_[0][4 * h]), s0[h]);
+    _mm_store_si128(reinterpret_cast<__m128i*>(&s_[1][4 * h]), s1[h]);
+    _mm_store_si128(reinterpret_cast<__m128i*>(&s_[2][4 * h]), s2[h]);
+    _mm_store_si128(reinterpret_cast<__m128i*>(&s_[3][4 * h]), s3[h]);
+  }
+#elif defined(SG_NOISE_NEON)
+  uint32x4_t s0[2], s1[2], s2[2], s3[2];
+  for (int h = 0; h < 2; ++h) {
+    s0[h] = vld1q_u32(&s_[0][4 * h]);
+    s1[h] = vld1q_u32(&s_[1][4 * h]);
+    s2[h] = vld1q_u32(&s_[2][4 * h]);
+    s3[h] = vld1q_u32(&s_[3][4 * h]);
+  }
+  const uint32x4_t exp1 = vdupq_n_u32(0x3F800000u);
+  const float32x4_t three = vdupq_n_f32(3.0f);
+  for (; i + kLanes <= n; i += kLanes) {
+    for (int h = 0; h < 2; ++h) {
+      uint32x4_t r = vaddq_u32(s0[h], s3[h]);
+      uint32x4_t t = vshlq_n_u32(s1[h], 9);
+      s2[h] = veorq_u32(s2[h], s0[h]);
+      s3[h] = veorq_u32(s3[h], s1[h]);
+      s1[h] = veorq_u32(s1[h], s2[h]);
+      s0[h] = veorq_u32(s0[h], s3[h]);
+      s2[h] = veorq_u32(s2[h], t);
+      s3[h] = vsriq_n_u32(vshlq_n_u32(s3[h], 11), s3[h], 21);
+      float32x4_t f = vreinterpretq_f32_u32(vorrq_u32(vshrq_n_u32(r, 9), exp1));
+      vst1q_f32(out + i + 4 * h, vsubq_f32(vaddq_f32(f, f), three));
+    }
+  }
+  for (int h = 0; h < 2; ++h) {
+    vst1q_u32(&s_[0][4 * h], s0[h]);
+    vst1q_u32(&s_[1][4 * h], s1[h]);
+    vst1q_u32(&s_[2][4 * h], s2[h]);
+    vst1q_u32(&s_[3][4 * h], s3[h]);
+  }
+#endif
+  // 标量路径 / 尾部：逐路推进，输出次序与向量路径一致
+  for (; i < n; i += kLanes) {
+    for (size_t lane = 0; lane < kLanes; ++lane) {
+      uint32_t r = s_[0][lane] + s_[3][lane];
+      uint32_t t = s_[1][lane] << 9;
+      s_[2][lane] ^= s_[0][lane];
+      s_[3][lane] ^= s_[1][lane];
+      s_[1][lane] ^= s_[2][lane];
+      s_[0][lane] ^= s_[3][lane];
+      s_[2][lane] ^= t;
+      s_[3][lane] = (s_[3][lane] << 11) | (s_[3][lane] >> 21);
+      if (i + lane < n) out[i + lane] = bitsToUnit(r);
+    }
+  }
+}
+
+}  // namespace silenceguard
@@ -0,0 +1,31 @@
+// SilenceGuard Pro — 向量化白噪声源
+// 8 路并行 xoshiro128+，每步产出 8 个 [-1, 1) 均匀分布 float；
+// 替代逐样本 std::mt19937 + uniform_real_distribution，无分支、无除法
+
+#ifndef SILENCEGUARD_NOISEGENERATOR_H
+#define SILENCEGUARD_NOISEGENERATOR_H
+
+#include <cstddef>
+#include <cstdint>
+
+namespace silenceguard {
+
+class NoiseGenerator {
+ public:
+  static constexpr size_t kLanes = 8;
+
+  explicit NoiseGenerator(uint64_t seed);
+
+  void seed(uint64_t seed);
+
+  /** 写入 n 个 [-1, 1) 白噪声样本 */
+  void fill(float* out, size_t n);
+
+ private:
+  // 状态按字 (s0..s3) × 路 (lane) 存放，便于 4/8 路向量化
+  alignas(16) uint32_t s_[4][kLanes];
+};
+
+}  // namespace silenceguard
+
+#endif  // SILENCEGUARD_NOISEGENERATOR_H
@@ -0,0 +1,153 @@
+#include "PcmKernels.h"
+#include <algorithm>
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define SG_PCM_NEON 1
+#if defined(__aarch64__)
+#define SG_PCM_NEON_DIV 1  // vdivq_f32 仅 AArch64 提供；ARMv7 的倒数近似不满足逐位一致
+#endif
+#elif defined(__AVX2__)
+#include <immintrin.h>
+#define SG_PCM_AVX2 1
+#elif defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define SG_PCM_SSE2 1
+#endif
+
+namespace silenceguard {
+
+namespace {
+
+inline int16_t toInt16(float v) {
+  v = std::max(-1.0f, std::min(1.0f, v));
+  return static_cast<int16_t>(v * kInt16Max);
+}
+
+}  // namespace
+
+void int16ToFloat(const int16_t* src, float* dst, size_t n) {
+  size_t i = 0;
+#if defined(SG_PCM_AVX2)
+  const __m256 k = _mm256_set1_ps(kInt16Max);
+  for (; i + 8 <= n; i += 8) {
+    __m256i x = _mm256_cvtepi16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i)));
+    _mm256_storeu_ps(dst + i, _mm256_div_ps(_mm256_cvtepi32_ps(x), k));
+  }
+#elif defined(SG_PCM_SSE2)
+  const __m128 k = _mm_set1_ps(kInt16Max);
+  for (; i + 8 <= n; i += 8) {
+    __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+    __m128i lo = _mm_srai_epi32(_mm_unpacklo_epi16(x, x), 16);
+    __m128i hi = _mm_srai_epi32(_mm_unpackhi_epi16(x, x), 16);
+    _mm_storeu_ps(dst + i, _mm_div_ps(_mm_cvtepi32_ps(lo), k));
+    _mm_storeu_ps(dst + i + 4, _mm_div_ps(_mm_cvtepi32_ps(hi), k));
+  }
+#elif defined(SG_PCM_NEON_DIV)
+  const float32x4_t k = vdupq_n_f32(kInt16Max);
+  for (; i + 8 <= n; i += 8) {
+    int16x8_t x = vld1q_s16(src + i);
+    vst1q_f32(dst + i, vdivq_f32(vcvtq_f32_s32(vmovl_s16(vget_low_s16(x))), k));
+    vst1q_f32(dst + i + 4, vdivq_f32(vcvtq_f32_s32(vmovl_s16(vget_high_s16(x))), k));
+  }
+#endif
+  for (; i < n; ++i) dst[i] = static_cast<float>(src[i]) / kInt16Max;
+}
+
+void floatToInt16(const float* src, int16_t* dst, size_t n) {
+  size_t i = 0;
+#if defined(SG_PCM_AVX2) || defined(SG_PCM_SSE2)
+  const __m128 lo = _mm_set1_ps(-1.0f), hi = _mm_set1_ps(1.0f), k = _mm_set1_ps(kInt16Max);
+  for (; i + 8 <= n; i += 8) {
+    __m128 a = _mm_mul_ps(_mm_min_ps(_mm_max_ps(_mm_loadu_ps(src + i), lo), hi), k);
+    __m128 b = _mm_mul_ps(_mm_min_ps(_mm_max_ps(_mm_loadu_ps(src + i + 4), lo), hi), k);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i),
+                     _mm_packs_epi32(_mm_cvttps_epi32(a), _mm_cvttps_epi32(b)));
+  }
+#elif defined(SG_PCM_NEON)
+  const float32x4_t lo = vdupq_n_f32(-1.0f), hi = vdupq_n_f32(1.0f), k = vdupq_n_f32(kInt16Max);
+  for (; i + 8 <= n; i += 8) {
+    float32x4_t a = vmulq_f32(vminq_f32(vmaxq_f32(vld1q_f32(src + i), lo), hi), k);
+    float32x4_t b = vmulq_f32(vminq_f32(vmaxq_f32(vld1q_f32(src + i + 4), lo), hi), k);
+    vst1q_s16(dst + i, vcombine_s16(vqmovn_s32(vcvtq_s32_f32(a)), vqmovn_s32(vcvtq_s32_f32(b))));
+  }
+#endif
+  for (; i < n; ++i) dst[i] = toInt16(src[i]);
+}
+
+void crossFadeToInt16(int16_t* buffer, const float* tone, size_t n, float gainStart, float gainStep) {
+  size_t i = 0;
+#if defined(SG_PCM_AVX2) || defined(SG_PCM_SSE2)
+  const __m128 lo = _mm_set1_ps(-1.0f), hi = _mm_set1_ps(1.0f), k = _mm_set1_ps(kInt16Max);
+  const __m128 zero = _mm_setzero_ps(), inv = _mm_set1_ps(1.0f / kInt16Max);
+  const __m128 step = _mm_set1_ps(gainStep), lane = _mm_set_ps(3.0f, 2.0f, 1.0f, 0.0f);
+  for (; i + 8 <= n; i += 8) {
+    __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(buffer + i));
+    __m128 xs[2] = {_mm_mul_ps(_mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(x, x), 16)), inv),
+                    _mm_mul_ps(_mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpackhi_epi16(x, x), 16)), inv)};
+    __m128i out[2];
+    for (int h = 0; h < 2; ++h) {
+      __m128 idx = _mm_add_ps(_mm_set1_ps(static_cast<float>(i + 4 * h)), lane);
+      __m128 g = _mm_add_ps(_mm_set1_ps(gainStart), _mm_mul_ps(idx, step));
+      g = _mm_min_ps(_mm_max_ps(g, zero), hi);
+      __m128 t = _mm_loadu_ps(tone + i + 4 * h);
+      __m128 m = _mm_add_ps(xs[h], _mm_mul_ps(g, _mm_sub_ps(t, xs[h])));
+      out[h] = _mm_cvttps_epi32(_mm_mul_ps(_mm_min_ps(_mm_max_ps(m, lo), hi), k));
+    }
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(buffer + i), _mm_packs_epi32(out[0], out[1]));
+  }
+#elif defined(SG_PCM_NEON)
+  const float32x4_t lo = vdupq_n_f32(-1.0f), hi = vdupq_n_f32(1.0f), zero = vdupq_n_f32(0.0f);
+  const float32x4_t k = vdupq_n_f32(kInt16Max);
+  const float laneInit[4] = {0.0f, 1.0f, 2.0f, 3.0f};
+  const float32x4_t lane = vld1q_f32(laneInit);
+  for (; i + 8 <= n; i += 8) {
+    int16x8_t x = vld1q_s16(buffer + i);
+    float32x4_t xs[2] = {vmulq_n_f32(vcvtq_f32_s32(vmovl_s16(vget_low_s16(x))), 1.0f / kInt16Max),
+                         vmulq_n_f32(vcvtq_f32_s32(vmovl_s16(vget_high_s16(x))), 1.0f / kInt16Max)};
+    int16x4_t out[2];
+    for (int h = 0; h < 2; ++h) {
+      float32x4_t idx = vaddq_f32(vdupq_n_f32(static_cast<float>(i + 4 * h)), lane);
+      float32x4_t g = vmlaq_n_f32(vdupq_n_f32(gainStart), idx, gainStep);
+      g = vminq_f32(vmaxq_f32(g, zero), hi);
+      float32x4_t t = vld1q_f32(tone + i + 4 * h);
+      float32x4_t m = vmlaq_f32(xs[h], g, vsubq_f32(t, xs[h]));
+      out[h] = vqmovn_s32(vcvtq_s32_f32(vmulq_f32(vminq_f32(vmaxq_f32(m, lo), hi), k)));
+    }
+    vst1q_s16(buffer + i, vcombine_s16(out[0], out[1]));
+  }
+#endif
+  for (; i < n; ++i) {
+    float g = std::max(0.0f, std::min(1.0f, gainStart + static_cast<float>(i) * gainStep));
+    float x = static_cast<float>(buffer[i]) * (1.0f / kInt16Max);
+    buffer[i] = toInt16(x + g * (tone[i] - x));
+  }
+}
+
+void modulateToInt16(const float* noise, const float* env, float gain, int16_t* dst, size_t n) {
+  size_t i = 0;
+#if defined(SG_PCM_AVX2) || defined(SG_PCM_SSE2)
+  const __m128 lo = _mm_set1_ps(-1.0f), hi = _mm_set1_ps(1.0f), k = _mm_set1_ps(kInt16Max);
+  const __m128 g = _mm_set1_ps(gain);
+  for (; i + 8 <= n; i += 8) {
+    __m128 a = _mm_mul_ps(_mm_mul_ps(_mm_loadu_ps(noise + i), _mm_loadu_ps(env + i)), g);
+    __m128 b = _mm_mul_ps(_mm_mul_ps(_mm_loadu_ps(noise + i + 4), _mm_loadu_ps(env + i + 4)), g);
+    a = _mm_mul_ps(_mm_min_ps(_mm_max_ps(a, lo), hi), k);
+    b = _mm_mul_ps(_mm_min_ps(_mm_max_ps(b, lo), hi), k);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i),
+                     _mm_packs_epi32(_mm_cvttps_epi32(a), _mm_cvttps_epi32(b)));
+  }
+#elif defined(SG_PCM_NEON)
+  const float32x4_t lo = vdupq_n_f32(-1.0f), hi = vdupq_n_f32(1.0f), k = vdupq_n_f32(kInt16Max);
+  for (; i + 8 <= n; i += 8) {
+    float32x4_t a = vmulq_n_f32(vmulq_f32(vld1q_f32(noise + i), vld1q_f32(env + i)), gain);
+    float32x4_t b = vmulq_n_f32(vmulq_f32(vld1q_f32(noise + i + 4), vld1q_f32(env + i + 4)), gain);
+    a = vmulq_f32(vminq_f32(vmaxq_f32(a, lo), hi), k);
+    b = vmulq_f32(vminq_f32(vmaxq_f32(b, lo), hi), k);
+    vst1q_s16(dst + i, vcombine_s16(vqmovn_s32(vcvtq_s32_f32(a)), vqmovn_s32(vcvtq_s32_f32(b))));
+  }
+#endif
+  for (; i < n; ++i) dst[i] = toInt16(noise[i] * env[i] * gain);
+}
+
+}  // namespace silenceguard
@@ -0,0 +1,35 @@
+// SilenceGuard Pro — PCM 向量内核 (NEON / SSE2 / AVX2，其余平台标量回退)
+// int16 ↔ float 转换、噪声调制输出；供 NoiseMasker 等音频线程热路径使用
+
+#ifndef SILENCEGUARD_PCMKERNELS_H
+#define SILENCEGUARD_PCMKERNELS_H
+
+#include <cstddef>
+#include <cstdint>
+
+namespace silenceguard {
+
+constexpr float kInt16Max = 32767.0f;
+
+/**
+ * dst[i] = src[i] / 32767
+ * 使用真除法 (非乘倒数)，结果与标量 static_cast<float>(x) / 32767.0f 逐位一致
+ */
+void int16ToFloat(const int16_t* src, float* dst, size_t n);
+
+/** dst[i] = (int16) trunc(clamp(src[i], -1, 1) * 32767) */
+void floatToInt16(const float* src, int16_t* dst, size_t n);
+
+/**
+ * 交叉淡化 + 混音一次完成，饱和写回 int16：
+ * g_i = clamp(gainStart + i·gainStep, 0, 1)
+ * buffer[i] = sat16((buffer[i] / 32767 · (1 - g_i) + tone[i] · g_i) · 32767)
+ */
+void crossFadeToInt16(int16_t* buffer, const float* tone, size_t n, float gainStart, float gainStep);
+
+/** dst[i] = (int16) trunc(clamp(noise[i] * env[i] * gain, -1, 1) * 32767) */
+void modulateToInt16(const float* noise, const float* env, float gain, int16_t* dst, size_t n);
+
+}  // namespace silenceguard
+
+#endif  // SILENCEGUARD_PCMKERNELS_H
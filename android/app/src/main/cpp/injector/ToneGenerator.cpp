@@ -0,0 +1,81 @@
+#include "ToneGenerator.h"
+#include <algorithm>
+#include <cmath>
+
+namespace silenceguard {
+
+namespace {
+constexpr double kTwoPi = 6.283185307179586;
+}
+
+ToneGenerator::ToneGenerator(float freqHz, float sampleRate, float amplitude)
+    : freqHz_(freqHz), sampleRate_(sampleRate), amplitude_(amplitude) {
+  retune(freqHz, sampleRate);
+  setPhase(0.0);
+}
+
+void ToneGenerator::setSampleRate(float sampleRate) { retune(freqHz_, sampleRate); }
+
+void ToneGenerator::setFrequency(float freqHz) { retune(freqHz, sampleRate_); }
+
+void ToneGenerator::reset() {
+  pending_ = 0;
+  setPhase(0.0);
+}
+
+void ToneGenerator::retune(float freqHz, float sampleRate) {
+  // 下一个待输出样本的相位：lane 0 已越过 pending_ 个缓存样本
+  double next = std::atan2(s_[0], c_[0]) - static_cast<double>(pending_) * omega_;
+  bool keepPhase = omega_ != 0.0;
+
+  freqHz_ = freqHz;
+  sampleRate_ = std::max(1.0f, sampleRate);
+  omega_ = kTwoPi * freqHz_ / sampleRate_;
+  stepCos_ = static_cast<float>(std::cos(kLanes * omega_));
+  stepSin_ = static_cast<float>(std::sin(kLanes * omega_));
+
+  if (keepPhase) {
+    pending_ = 0;
+    setPhase(next);
+  }
+}
+
+void ToneGenerator::setPhase(double phase) {
+  for (int k = 0; k < kLanes; ++k) {
+    c_[k] = static_cast<float>(std::cos(phase + k * omega_));
+    s_[k] = static_cast<float>(std::sin(phase + k * omega_));
+  }
+}
+
+void ToneGenerator::fill(float* out, size_t n) {
+  size_t i = 0;
+  for (; pending_ > 0 && i < n; --pending_) out[i++] = carry_[kLanes - pending_];
+
+  const float a = amplitude_, C = stepCos_, S = stepSin_;
+  auto step = [&](float* dst) {
+    for (int k = 0; k < kLanes; ++k) {
+      dst[k] = a * s_[k];
+      float c = c_[k] * C - s_[k] * S;
+      float s = s_[k] * C + c_[k] * S;
+      c_[k] = c;
+      s_[k] = s;
+    }
+  };
+
+  for (; i + kLanes <= n; i += kLanes) step(out + i);
+  if (i < n) {
+    step(carry_);
+    size_t r = n - i;
+    std::copy(carry_, carry_ + r, out + i);
+    pending_ = kLanes - r;
+  }
+
+  // 幅度校正 (一步牛顿迭代逼近 1/|z|)，抑制递推的舍入漂移
+  for (int k = 0; k < kLanes; ++k) {
+    float g = 1.5f - 0.5f * (c_[k] * c_[k] + s_[k] * s_[k]);
+    c_[k] *= g;
+    s_[k] *= g;
+  }
+}
+
+}  // namespace silenceguard
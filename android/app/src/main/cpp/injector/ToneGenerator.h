@@ -0,0 +1,48 @@
+// SilenceGuard Pro — 相位连续的正弦 (哔声) 振荡器
+// 正交递推：(cos φ, sin φ) 每样本旋转 ω，4 路相位错开的振荡器每步旋转 4ω，
+// 一步产出 4 个样本；跨调用保持相位 (HAL 每个 buffer 不再从 0 相位重启)，
+// 每次 fill 后做一次幅度校正防止递推漂移；无逐样本三角函数调用
+
+#ifndef SILENCEGUARD_TONEGENERATOR_H
+#define SILENCEGUARD_TONEGENERATOR_H
+
+#include <cstddef>
+
+namespace silenceguard {
+
+class ToneGenerator {
+ public:
+  ToneGenerator(float freqHz, float sampleRate, float amplitude);
+
+  /** 改变采样率 / 频率时保持当前相位 */
+  void setSampleRate(float sampleRate);
+  void setFrequency(float freqHz);
+  float sampleRate() const { return sampleRate_; }
+
+  /** 相位归零 */
+  void reset();
+
+  /** 写入 n 个 amplitude·sin(φ) 样本并推进相位 */
+  void fill(float* out, size_t n);
+
+ private:
+  static constexpr int kLanes = 4;
+
+  void retune(float freqHz, float sampleRate);
+  void setPhase(double phase);
+
+  float freqHz_;
+  float sampleRate_;
+  float amplitude_;
+  float c_[kLanes] = {1.0f, 1.0f, 1.0f, 1.0f};  // 各路 cos(φ + kω)
+  float s_[kLanes] = {};                         // 各路 sin(φ + kω)
+  float stepCos_ = 1.0f;     // cos(4ω)
+  float stepSin_ = 0.0f;     // sin(4ω)
+  double omega_ = 0.0;
+  size_t pending_ = 0;       // 上一步 4 个样本中尚未输出的个数 (c_/s_ 已越过它们)
+  float carry_[kLanes] = {};
+};
+
+}  // namespace silenceguard
+
+#endif  // SILENCEGUARD_TONEGENERATOR_H
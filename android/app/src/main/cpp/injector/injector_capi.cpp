@@ -12,14 +12,22 @@ void AudioInjector_applyCrossFade(int16_t* buffer, size_t frames, size_t crossFa
   silenceguard::applyCrossFade(buffer, frames, crossFadeFrames);
 }
 
+void AudioInjector_applyCrossFadeOut(int16_t* buffer, size_t frames, size_t crossFadeFrames) {
+  silenceguard::applyCrossFadeOut(buffer, frames, crossFadeFrames);
+}
+
+void AudioInjector_setToneSampleRate(int sampleRate) {
+  silenceguard::setToneSampleRate(sampleRate);
+}
+
 /** Phase 3 时间机器：对 ring buffer 回溯区间先交叉淡出再哔声 (§4.1) */
 void AudioInjector_processWithRingBuffer(int16_t* buffer, size_t frames, size_t crossFadeFrames) {
   if (crossFadeFrames > 0 && crossFadeFrames <= frames)
     silenceguard::applyCrossFade(buffer, crossFadeFrames, crossFadeFrames);
-  if (frames > crossFadeFrames)
-    silenceguard::applyBeep(buffer + crossFadeFrames, frames - crossFadeFrames);
-  else if (frames > 0)
+  if (crossFadeFrames == 0 || crossFadeFrames > frames)
     silenceguard::applyBeep(buffer, frames);
+  else if (frames > crossFadeFrames)
+    silenceguard::applyBeep(buffer + crossFadeFrames, frames - crossFadeFrames);
 }
 
 }  // extern "C"
@@ -0,0 +1,103 @@
+#include "ReplayAudio.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+
+namespace silenceguard {
+
+namespace {
+
+uint32_t le32(const char* p) {
+  const unsigned char* u = reinterpret_cast<const unsigned char*>(p);
+  return u[0] | (u[1] << 8) | (u[2] << 16) | (static_cast<uint32_t>(u[3]) << 24);
+}
+
+uint16_t le16(const char* p) {
+  const unsigned char* u = reinterpret_cast<const unsigned char*>(p);
+  return static_cast<uint16_t>(u[0] | (u[1] << 8));
+}
+
+// 16-bit PCM WAV；多声道取平均下混为 mono
+bool parseWav(const std::vector<char>& b, ReplayAudio* out) {
+  if (b.size() < 12 || std::memcmp(b.data(), "RIFF", 4) != 0 || std::memcmp(b.data() + 8, "WAVE", 4) != 0)
+    return false;
+  int channels = 0, bits = 0;
+  size_t pos = 12;
+  while (pos + 8 <= b.size()) {
+    const char* id = b.data() + pos;
+    size_t size = le32(id + 4);
+    const char* body = id + 8;
+    size_t avail = std::min(size, b.size() - pos - 8);
+    if (std::memcmp(id, "fmt ", 4) == 0 && avail >= 16) {
+      if (le16(body) != 1) {
+        fprintf(stderr, "audio: only PCM WAV is supported\n");
+        return false;
+      }
+      channels = le16(body + 2);
+      out->sampleRate = static_cast<int>(le32(body + 4));
+      bits = le16(body + 14);
+    } else if (std::memcmp(id, "data", 4) == 0) {
+      if (channels <= 0 || bits != 16) {
+        fprintf(stderr, "audio: only 16-bit PCM WAV is supported\n");
+        return false;
+      }
+      size_t frames = avail / (2 * channels);
+      out->pcm.resize(frames);
+      for (size_t i = 0; i < frames; ++i) {
+        int32_t acc = 0;
+        for (int c = 0; c < channels; ++c) acc += static_cast<int16_t>(le16(body + 2 * (i * channels + c)));
+        out->pcm[i] = static_cast<int16_t>(acc / channels);
+      }
+      return true;
+    }
+    pos += 8 + size + (size & 1);
+  }
+  return false;
+}
+
+}  // namespace
+
+bool readFile(const std::string& path, std::vector<char>* bytes) {
+  std::ifstream f(path, std::ios::binary);
+  if (!f) return false;
+  bytes->assign(std::istreambuf_iterator<char>(f), std::istreambuf_iterator<char>());
+  return true;
+}
+
+bool loadReplayAudio(const std::string& path, int rawRate, ReplayAudio* out) {
+  std::vector<char> bytes;
+  if (!readFile(path, &bytes)) {
+    fprintf(stderr, "audio: cannot read %s\n", path.c_str());
+    return false;
+  }
+  if (bytes.size() >= 4 && std::memcmp(bytes.data(), "RIFF", 4) == 0) return parseWav(bytes, out);
+  // 裸 PCM：s16le mono
+  out->sampleRate = rawRate;
+  out->pcm.resize(bytes.size() / 2);
+  for (size_t i = 0; i < out->pcm.size(); ++i) out->pcm[i] = static_cast<int16_t>(le16(bytes.data() + 2 * i));
+  return true;
+}
+
+bool writeWav(const std::string& path, const std::vector<int16_t>& pcm, int sampleRate) {
+  std::ofstream f(path, std::ios::binary);
+  if (!f) return false;
+  auto put32 = [&](uint32_t v) { char c[4] = {char(v), char(v >> 8), char(v >> 16), char(v >> 24)}; f.write(c, 4); };
+  auto put16 = [&](uint16_t v) { char c[2] = {char(v), char(v >> 8)}; f.write(c, 2); };
+  const uint32_t dataBytes = static_cast<uint32_t>(pcm.size() * 2);
+  f.write("RIFF", 4); put32(36 + dataBytes); f.write("WAVE", 4);
+  f.write("fmt ", 4); put32(16); put16(1); put16(1);
+  put32(static_cast<uint32_t>(sampleRate)); put32(static_cast<uint32_t>(sampleRate * 2)); put16(2); put16(16);
+  f.write("data", 4); put32(dataBytes);
+  for (int16_t s : pcm) put16(static_cast<uint16_t>(s));
+  return static_cast<bool>(f);
+}
+
+double percentile(const std::vector<int64_t>& sorted, double q) {
+  if (sorted.empty()) return 0.0;
+  size_t idx = static_cast<size_t>(q * static_cast<double>(sorted.size() - 1) + 0.5);
+  return static_cast<double>(sorted[std::min(idx, sorted.size() - 1)]);
+}
+
+}  // namespace silenceguard
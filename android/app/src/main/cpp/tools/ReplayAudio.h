@@ -0,0 +1,30 @@
+// SilenceGuard Pro — host 工具共用的音频读写 (sg_replay / sg_bench_quant)
+// 16-bit PCM WAV (多声道下混为 mono) 或裸 s16le mono PCM
+
+#ifndef SILENCEGUARD_REPLAYAUDIO_H
+#define SILENCEGUARD_REPLAYAUDIO_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace silenceguard {
+
+struct ReplayAudio {
+  std::vector<int16_t> pcm;  // mono
+  int sampleRate = 0;
+};
+
+bool readFile(const std::string& path, std::vector<char>* bytes);
+
+/** WAV 按文件头解析；其余视为裸 PCM，采样率取 rawRate。失败时向 stderr 说明原因 */
+bool loadReplayAudio(const std::string& path, int rawRate, ReplayAudio* out);
+
+bool writeWav(const std::string& path, const std::vector<int16_t>& pcm, int sampleRate);
+
+/** 已排序样本的分位数 (最近秩) */
+double percentile(const std::vector<int64_t>& sorted, double q);
+
+}  // namespace silenceguard
+
+#endif  // SILENCEGUARD_REPLAYAUDIO_H
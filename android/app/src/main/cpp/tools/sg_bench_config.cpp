@@ -0,0 +1,203 @@
+// SilenceGuard Pro — 配置推送基准 sg_bench_config (host)
+// HAL 线程按实时节奏逐周期调用 silenceguard_in_read_proxy，同时另一线程反复推送万级关键词的 UPDATE_CONFIG
+// (两份不同词表交替，每次都重编关键词图)；对比推送期间与空闲期间 HAL 调用的延迟分布，
+// 验证解析 / 编译都在推送线程完成、音频线程不因配置推送停顿
+//
+// 用法: sg_bench_config [选项]
+//   --keywords N    每份词表的关键词数 (默认 10000)
+//   --seconds S     每个阶段的实时音频时长 (默认 3)
+//   --period N      HAL 周期样本数 (默认 320 = 20ms)
+//   --model PATH    模型 (默认 stub-phoneme：输出音素后验，关键词解码实际运行)
+//   --seed N        随机种子 (默认 1)
+
+#include "core/EngineStats.h"
+#include "tools/ReplayAudio.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+extern "C" {
+void* ProtectionEngine_getInstance(void);
+void ProtectionEngine_loadModel(void* engine, const char* path);
+void ProtectionEngine_updateConfig(void* engine, const char* json);
+void ProtectionEngine_setAsyncAnalysis(void* engine, int enabled);
+int ProtectionEngine_getStats(void* engine, SgEngineStats* out);
+void ProtectionEngine_resetStats(void* engine);
+int ProtectionEngine_waitForModel(void* engine);
+ssize_t silenceguard_in_read_proxy(void* engine, void* buffer, size_t bytes);
+}
+
+namespace {
+
+using silenceguard::percentile;
+
+constexpr int kEngineSampleRate = 16000;
+
+struct Options {
+  int keywords = 10000;
+  double seconds = 3.0;
+  size_t period = 320;
+  std::string model = "stub-phoneme";
+  unsigned seed = 1;
+};
+
+void usage() {
+  fprintf(stderr, "usage: sg_bench_config [--keywords N] [--seconds S] [--period N] [--model PATH] [--seed N]\n");
+}
+
+bool parseArgs(int argc, char** argv, Options* opt) {
+  for (int i = 1; i < argc; ++i) {
+    std::string a = argv[i];
+    if (i + 1 >= argc) return false;
+    const char* v = argv[++i];
+    if (a == "--keywords") {
+      opt->keywords = std::max(1, static_cast<int>(std::strtol(v, nullptr, 10)));
+    } else if (a == "--seconds") {
+      opt->seconds = std::max(0.1, std::strtod(v, nullptr));
+    } else if (a == "--period") {
+      opt->period = static_cast<size_t>(std::max(16L, std::strtol(v, nullptr, 10)));
+    } else if (a == "--model") {
+      opt->model = v;
+    } else if (a == "--seed") {
+      opt->seed = static_cast<unsigned>(std::strtoul(v, nullptr, 10));
+    } else {
+      return false;
+    }
+  }
+  return true;
+}
+
+const char* const kInitials[] = {"zh", "ch", "sh", "b", "p", "m", "f", "d", "t", "n", "l", "g",
+                                 "k",  "h",  "j",  "q", "x", "r", "z", "c", "s", "y", "w"};
+const char* const kFinals[] = {"a", "o", "e", "i", "u", "ai", "ei", "ao", "ou", "an", "en", "ang", "eng", "ong"};
+
+// 随机拼音词表：2–4 个音节，每词阈值不同
+std::string makeConfig(int keywords, std::mt19937* rng) {
+  std::uniform_int_distribution<int> ini(0, static_cast<int>(sizeof(kInitials) / sizeof(kInitials[0])) - 1);
+  std::uniform_int_distribution<int> fin(0, static_cast<int>(sizeof(kFinals) / sizeof(kFinals[0])) - 1);
+  std::uniform_int_distribution<int> length(2, 4);
+  std::uniform_int_distribution<int> threshold(70, 95);
+  std::string json = "{\"global_sensitivity\":0.85,\"masking\":{\"attack\":10,\"release\":50},\"keywords\":[";
+  for (int k = 0; k < keywords; ++k) {
+    json += k ? ",{\"pinyin\":[" : "{\"pinyin\":[";
+    const int n = length(*rng);
+    for (int s = 0; s < n; ++s) {
+      json += s ? ",\"" : "\"";
+      json += kInitials[ini(*rng)];
+      json += kFinals[fin(*rng)];
+      json += "\"";
+    }
+    json += "],\"threshold\":0." + std::to_string(threshold(*rng)) + "}";
+  }
+  json += "]}";
+  return json;
+}
+
+struct Phase {
+  std::vector<int64_t> callNs;  // 每次 HAL 调用
+  int64_t lockWaitMaxNs = 0;    // 等待引擎 mutex 的最大值 (分析线程；同步模式下即 HAL 线程)
+};
+
+// 实时节奏送入 seconds 秒音频 (低幅噪声上叠 300–3000 Hz 扫频)，记录每次 HAL 调用耗时
+Phase runAudio(void* engine, const Options& opt, std::mt19937* rng) {
+  Phase phase;
+  ProtectionEngine_resetStats(engine);
+  std::vector<int16_t> buffer(opt.period);
+  std::normal_distribution<float> noise(0.0f, 300.0f);
+  const size_t total = static_cast<size_t>(opt.seconds * kEngineSampleRate);
+  const auto start = std::chrono::steady_clock::now();
+  double phi = 0.0;
+  for (size_t fed = 0; fed < total; fed += opt.period) {
+    for (size_t i = 0; i < opt.period; ++i) {
+      const double t = static_cast<double>(fed + i) / kEngineSampleRate;
+      phi += 2.0 * M_PI * (300.0 + 2700.0 * std::fmod(t, 1.0)) / kEngineSampleRate;
+      buffer[i] = static_cast<int16_t>(std::max(-32768.0f, std::min(32767.0f, 6000.0f * static_cast<float>(std::sin(phi)) + noise(*rng))));
+    }
+    std::this_thread::sleep_until(start + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                                              std::chrono::duration<double>(static_cast<double>(fed) / kEngineSampleRate)));
+    const auto t0 = std::chrono::steady_clock::now();
+    silenceguard_in_read_proxy(engine, buffer.data(), buffer.size() * sizeof(int16_t));
+    phase.callNs.push_back(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - t0).count());
+  }
+  SgEngineStats stats;
+  ProtectionEngine_getStats(engine, &stats);
+  phase.lockWaitMaxNs = static_cast<int64_t>(stats.stages[SG_STAGE_LOCK_WAIT].max_ns);
+  return phase;
+}
+
+void report(const char* name, const Phase& phase) {
+  std::vector<int64_t> ns = phase.callNs;
+  std::sort(ns.begin(), ns.end());
+  printf("  %-20s calls %5zu  p50 %8.1f us  p99 %8.1f us  max %8.1f us  engine lock wait max %8.1f us\n", name,
+         ns.size(), percentile(ns, 0.50) / 1e3, percentile(ns, 0.99) / 1e3, ns.back() / 1e3,
+         phase.lockWaitMaxNs / 1e3);
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  Options opt;
+  if (!parseArgs(argc, argv, &opt)) {
+    usage();
+    return 2;
+  }
+  std::mt19937 rng(opt.seed);
+  const std::string configs[2] = {makeConfig(opt.keywords, &rng), makeConfig(opt.keywords, &rng)};
+
+  void* engine = ProtectionEngine_getInstance();
+  ProtectionEngine_loadModel(engine, opt.model.c_str());
+  if (!ProtectionEngine_waitForModel(engine)) {
+    fprintf(stderr, "sg_bench_config: cannot load %s\n", opt.model.c_str());
+    return 1;
+  }
+  // 单核机器上推送线程与 HAL 线程争抢 CPU，调用延迟的尾部反映的是抢占而非阻塞；以锁等待为准
+  printf("payload   : %d keywords, %.1f KB per push, HAL period %zu samples, %u hardware threads\n", opt.keywords,
+         configs[0].size() / 1024.0, opt.period, std::thread::hardware_concurrency());
+
+  for (int async = 1; async >= 0; --async) {
+    ProtectionEngine_setAsyncAnalysis(engine, async);
+    ProtectionEngine_updateConfig(engine, configs[1].c_str());
+    printf("%s analysis:\n", async ? "async" : "sync (HAL thread analyses)");
+    const Phase idle = runAudio(engine, opt, &rng);
+
+    // 推送线程：两份词表交替，连续推送直到音频阶段结束
+    std::atomic<bool> stop{false};
+    std::vector<int64_t> pushNs;
+    SgEngineStats before;
+    ProtectionEngine_getStats(engine, &before);
+    std::thread pusher([&] {
+      for (int i = 0; !stop.load(std::memory_order_relaxed); ++i) {
+        const auto t0 = std::chrono::steady_clock::now();
+        ProtectionEngine_updateConfig(engine, configs[i & 1].c_str());
+        pushNs.push_back(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - t0).count());
+      }
+    });
+    const Phase busy = runAudio(engine, opt, &rng);
+    stop.store(true);
+    pusher.join();
+    SgEngineStats after;
+    ProtectionEngine_getStats(engine, &after);
+
+    report("idle", idle);
+    report("during pushes", busy);
+    std::sort(pushNs.begin(), pushNs.end());
+    printf("  %-20s count %5zu  p50 %8.1f ms  max %8.1f ms  (last parse %.1f ms, compile %.1f ms, %u graph nodes)\n",
+           "config push", pushNs.size(), percentile(pushNs, 0.50) / 1e6, pushNs.back() / 1e6,
+           after.config_parse_us / 1e3, after.config_compile_us / 1e3, after.kws_graph_nodes);
+    printf("  %-20s %llu snapshots published, %llu rejected\n", "",
+           static_cast<unsigned long long>(after.config_publishes - before.config_publishes),
+           static_cast<unsigned long long>(after.config_rejected));
+  }
+  ProtectionEngine_setAsyncAnalysis(engine, 0);
+  return 0;
+}
@@ -0,0 +1,226 @@
+// SilenceGuard Pro — 音素后验图 DTW 模板匹配基准 sg_bench_dtw (host)
+// 合成后验图：模板为随机音素单元序列 (每单元持续数帧，间以 blank)，查询片段为其中一个模板的
+// 时间伸缩版本并叠加噪声；比较完整 DTW 与 LB_Keogh + 早停的批量匹配耗时，并校验两者最优结果一致
+//
+// 用法: sg_bench_dtw [选项]
+//   --templates N     模板数 (默认 500)
+//   --frames N        模板与查询片段的最大帧数 (默认 50，与推理窗口一致)
+//   --dim N           音素单元数 (默认 59，默认声母 / 韵母表)
+//   --band R          Sakoe-Chiba 半径 (默认较长序列的 10%)
+//   --min-sim X       相似度阈值 (默认 0：只取最优)
+//   --stride-ms N     对照的推理步长 (默认 160)
+//   --iters N         每种配置的查询窗口数 (默认 50)
+//   --seed N          随机种子 (默认 1)
+
+#include "core/InferenceScheduler.h"
+#include "PhonemeDtw.h"
+#include "tools/ReplayAudio.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+using namespace silenceguard;
+
+struct Options {
+  int templates = 500;
+  int frames = 50;
+  int dim = 59;
+  int band = -1;
+  float minSimilarity = 0.0f;
+  int strideMs = kDefaultInferenceStrideMs;
+  int iters = 50;
+  unsigned seed = 1;
+};
+
+void usage() {
+  fprintf(stderr,
+          "usage: sg_bench_dtw [--templates N] [--frames N] [--dim N] [--band R] [--min-sim X]\n"
+          "                    [--stride-ms N] [--iters N] [--seed N]\n");
+}
+
+bool parseArgs(int argc, char** argv, Options* opt) {
+  for (int i = 1; i < argc; ++i) {
+    std::string a = argv[i];
+    if (i + 1 >= argc) return false;
+    const char* v = argv[++i];
+    if (a == "--templates") {
+      opt->templates = std::max(1, static_cast<int>(std::strtol(v, nullptr, 10)));
+    } else if (a == "--frames") {
+      opt->frames = std::max(2, static_cast<int>(std::strtol(v, nullptr, 10)));
+    } else if (a == "--dim") {
+      opt->dim = std::max(2, static_cast<int>(std::strtol(v, nullptr, 10)));
+    } else if (a == "--band") {
+      opt->band = static_cast<int>(std::strtol(v, nullptr, 10));
+    } else if (a == "--min-sim") {
+      opt->minSimilarity = static_cast<float>(std::strtod(v, nullptr));
+    } else if (a == "--stride-ms") {
+      opt->strideMs = std::max(1, static_cast<int>(std::strtol(v, nullptr, 10)));
+    } else if (a == "--iters") {
+      opt->iters = std::max(1, static_cast<int>(std::strtol(v, nullptr, 10)));
+    } else if (a == "--seed") {
+      opt->seed = static_cast<unsigned>(std::strtoul(v, nullptr, 10));
+    } else {
+      return false;
+    }
+  }
+  return true;
+}
+
+// 单元序列 → 后验图：每单元持续 hold 帧，单元之间一帧 blank (单元 0)；峰值 peak，其余均分
+void renderPosteriors(const std::vector<int>& units, const std::vector<int>& holds, int dim, float peak,
+                      std::mt19937* rng, std::vector<float>* out) {
+  std::uniform_real_distribution<float> noise(0.0f, 1.0f);
+  out->clear();
+  auto frame = [&](int unit) {
+    const size_t at = out->size();
+    out->resize(at + static_cast<size_t>(dim));
+    float* row = out->data() + at;
+    float sum = 0.0f;
+    for (int u = 0; u < dim; ++u) sum += row[u] = noise(*rng);
+    const float scale = (1.0f - peak) / sum;
+    for (int u = 0; u < dim; ++u) row[u] *= scale;
+    row[unit] += peak;
+  };
+  for (size_t k = 0; k < units.size(); ++k) {
+    for (int h = 0; h < holds[k]; ++h) frame(units[k]);
+    frame(0);
+  }
+}
+
+struct Template {
+  std::vector<int> units;
+  std::vector<int> holds;
+  std::vector<float> posteriors;
+  int frames = 0;
+};
+
+struct Run {
+  std::vector<int64_t> ns;
+  DtwStats totals;
+  int agree = 0;
+};
+
+void report(const char* name, const Run& run, int templates, int strideMs) {
+  std::vector<int64_t> ns = run.ns;
+  std::sort(ns.begin(), ns.end());
+  double mean = 0.0;
+  for (int64_t v : ns) mean += static_cast<double>(v);
+  mean /= static_cast<double>(ns.size());
+  const int windows = static_cast<int>(ns.size());
+  printf("  %-22s mean %9.1f us  p50 %9.1f us  p99 %9.1f us  (%5.2f%% of %d ms stride)\n", name, mean / 1e3,
+         percentile(ns, 0.50) / 1e3, percentile(ns, 0.99) / 1e3, 100.0 * mean / (strideMs * 1e6), strideMs);
+  const double total = static_cast<double>(templates) * windows;
+  printf("  %-22s lb-pruned %5.1f%%  abandoned %5.1f%%  completed %5.1f%%  best agrees %d/%d\n", "",
+         100.0 * run.totals.prunedByBound / total, 100.0 * run.totals.abandoned / total,
+         100.0 * run.totals.completed / total, run.agree, windows);
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  Options opt;
+  if (!parseArgs(argc, argv, &opt)) {
+    usage();
+    return 2;
+  }
+  std::mt19937 rng(opt.seed);
+  std::uniform_int_distribution<int> unitDist(1, opt.dim - 1);
+  std::uniform_int_distribution<int> lengthDist(2, 6);  // 音节数 ×2 (声母 + 韵母) 的量级
+  std::uniform_int_distribution<int> holdDist(2, 6);
+
+  // 模板：长度限制在查询窗口内
+  std::vector<Template> templates(static_cast<size_t>(opt.templates));
+  std::vector<PhonemeTemplate> views;
+  for (Template& t : templates) {
+    do {
+      const int len = lengthDist(rng);
+      t.units.resize(static_cast<size_t>(len));
+      t.holds.resize(static_cast<size_t>(len));
+      for (int k = 0; k < len; ++k) {
+        t.units[k] = unitDist(rng);
+        t.holds[k] = holdDist(rng);
+      }
+      renderPosteriors(t.units, t.holds, opt.dim, 0.8f, &rng, &t.posteriors);
+      t.frames = static_cast<int>(t.posteriors.size() / static_cast<size_t>(opt.dim));
+    } while (t.frames > opt.frames);
+    views.push_back({t.posteriors.data(), t.frames});
+  }
+
+  // 查询片段 (如 KWS 命中区间)：目标模板逐单元持续时长 ±1 帧、峰值更低
+  struct Query {
+    std::vector<float> posteriors;
+    int frames;
+    int target;
+  };
+  std::vector<Query> queries(static_cast<size_t>(opt.iters));
+  std::uniform_int_distribution<int> pick(0, opt.templates - 1);
+  std::uniform_int_distribution<int> jitter(-1, 1);
+  for (Query& q : queries) {
+    q.target = pick(rng);
+    const Template& t = templates[static_cast<size_t>(q.target)];
+    std::vector<int> holds = t.holds;
+    for (int& h : holds) h = std::max(1, h + jitter(rng));
+    renderPosteriors(t.units, holds, opt.dim, 0.6f, &rng, &q.posteriors);
+    q.frames = static_cast<int>(q.posteriors.size() / static_cast<size_t>(opt.dim));
+  }
+
+  std::vector<float> scores(static_cast<size_t>(opt.templates));
+  PhonemeTemplateMatcher matcher;
+  std::vector<int> reference(queries.size(), -1);
+  auto run = [&](DtwOptions options, bool isReference) {
+    Run r;
+    for (size_t i = 0; i < queries.size(); ++i) {
+      DtwStats st;
+      const auto t0 = std::chrono::steady_clock::now();
+      const int best = matcher.match(queries[i].posteriors.data(), queries[i].frames, opt.dim, views.data(),
+                                     opt.templates, options, scores.data(), &st);
+      r.ns.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - t0)
+                         .count());
+      r.totals.prunedByBound += st.prunedByBound;
+      r.totals.abandoned += st.abandoned;
+      r.totals.completed += st.completed;
+      // 基准不早停：算完全部模板后再按阈值判定
+      const int judged = isReference && best >= 0 && scores[best] < opt.minSimilarity ? -1 : best;
+      if (isReference) reference[i] = judged;
+      if (judged == reference[i]) ++r.agree;
+    }
+    return r;
+  };
+
+  DtwOptions full;
+  full.band = opt.band;
+  full.lowerBound = false;
+  full.pruneByBest = false;
+  DtwOptions pruned = full;
+  pruned.minSimilarity = opt.minSimilarity;
+  pruned.lowerBound = true;
+  pruned.pruneByBest = true;
+
+  int hitTarget = 0;
+  const Run base = run(full, true);
+  for (size_t i = 0; i < queries.size(); ++i) hitTarget += reference[i] == queries[i].target ? 1 : 0;
+  const Run fast = run(pruned, false);
+
+  int minFrames = opt.frames, maxFrames = 0;
+  for (const Template& t : templates) {
+    minFrames = std::min(minFrames, t.frames);
+    maxFrames = std::max(maxFrames, t.frames);
+  }
+  printf("templates : %d (%d-%d frames), segments <= %d frames x %d units, band %d, min similarity %.2f\n",
+         opt.templates, minFrames, maxFrames, opt.frames, opt.dim, opt.band, opt.minSimilarity);
+  printf("accuracy  : full DTW best = planted template in %d/%zu windows\n", hitTarget, queries.size());
+  report("full DTW", base, opt.templates, opt.strideMs);
+  report("LB_Keogh + abandon", fast, opt.templates, opt.strideMs);
+  double baseMean = 0.0, fastMean = 0.0;
+  for (int64_t v : base.ns) baseMean += static_cast<double>(v);
+  for (int64_t v : fast.ns) fastMean += static_cast<double>(v);
+  printf("speedup   : %.2fx\n", fastMean > 0.0 ? baseMean / fastMean : 0.0);
+  return fast.agree == static_cast<int>(queries.size()) ? 0 : 1;
+}
@@ -0,0 +1,163 @@
+// SilenceGuard Pro — 拼音编辑距离基准 sg_bench_edit (host)
+// 合成词表：随机音节拼成的拼音串；查询为某个词条做 0–2 次随机编辑 (替换 / 插入 / 删除)
+// 比较原逐对 DP (每次分配二维表)、位并行逐对、批量 + 截断三种打分的耗时，并校验距离与最优词条一致
+//
+// 用法: sg_bench_edit [选项]
+//   --keywords N      词表大小 (默认 10000)
+//   --max-dist K      批量打分的截断距离 (默认 2；< 0 不截断)
+//   --iters N         查询数 (默认 200)
+//   --seed N          随机种子 (默认 1)
+
+#include "inference/EditDistance.h"
+#include "tools/ReplayAudio.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+using namespace silenceguard;
+
+struct Options {
+  int keywords = 10000;
+  int maxDistance = 2;
+  int iters = 200;
+  unsigned seed = 1;
+};
+
+const char* const kSyllables[] = {"ni",  "hao", "wo",   "shi", "zhong", "guo",  "ren", "min", "yin", "hang",
+                                  "ka",  "hao", "mi",   "ma",  "zhang", "hu",   "xin", "xi",  "bao", "xian",
+                                  "dai", "kuan", "jie", "qian", "zhuan", "zhang", "yan", "zheng", "ma", "dian"};
+
+void usage() { fprintf(stderr, "usage: sg_bench_edit [--keywords N] [--max-dist K] [--iters N] [--seed N]\n"); }
+
+bool parseArgs(int argc, char** argv, Options* opt) {
+  for (int i = 1; i < argc; ++i) {
+    std::string a = argv[i];
+    if (i + 1 >= argc) return false;
+    const char* v = argv[++i];
+    if (a == "--keywords") {
+      opt->keywords = std::max(1, static_cast<int>(std::strtol(v, nullptr, 10)));
+    } else if (a == "--max-dist") {
+      opt->maxDistance = static_cast<int>(std::strtol(v, nullptr, 10));
+    } else if (a == "--iters") {
+      opt->iters = std::max(1, static_cast<int>(std::strtol(v, nullptr, 10)));
+    } else if (a == "--seed") {
+      opt->seed = static_cast<unsigned>(std::strtoul(v, nullptr, 10));
+    } else {
+      return false;
+    }
+  }
+  return true;
+}
+
+// 改动前 ConfMatrix.cpp 的实现：每次比较分配完整 (m+1)×(n+1) 表
+int dpDistance(const std::string& s1, const std::string& s2) {
+  const size_t m = s1.length();
+  const size_t n = s2.length();
+  if (m == 0) return static_cast<int>(n);
+  if (n == 0) return static_cast<int>(m);
+  std::vector<std::vector<int>> dp(m + 1, std::vector<int>(n + 1));
+  for (size_t i = 0; i <= m; ++i) dp[i][0] = static_cast<int>(i);
+  for (size_t j = 0; j <= n; ++j) dp[0][j] = static_cast<int>(j);
+  for (size_t i = 1; i <= m; ++i) {
+    for (size_t j = 1; j <= n; ++j) {
+      const int cost = s1[i - 1] == s2[j - 1] ? 0 : 1;
+      dp[i][j] = std::min({dp[i - 1][j] + 1, dp[i][j - 1] + 1, dp[i - 1][j - 1] + cost});
+    }
+  }
+  return dp[m][n];
+}
+
+void report(const char* name, std::vector<int64_t> ns, int keywords) {
+  std::sort(ns.begin(), ns.end());
+  double mean = 0.0;
+  for (int64_t v : ns) mean += static_cast<double>(v);
+  mean /= static_cast<double>(ns.size());
+  printf("  %-24s mean %9.1f us  p50 %9.1f us  p99 %9.1f us  (%6.1f ns / pair)\n", name, mean / 1e3,
+         percentile(ns, 0.50) / 1e3, percentile(ns, 0.99) / 1e3, mean / keywords);
+}
+
+int64_t nowNs() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  Options opt;
+  if (!parseArgs(argc, argv, &opt)) {
+    usage();
+    return 2;
+  }
+  std::mt19937 rng(opt.seed);
+  const int syllableCount = static_cast<int>(sizeof(kSyllables) / sizeof(kSyllables[0]));
+  std::uniform_int_distribution<int> syl(0, syllableCount - 1);
+  std::uniform_int_distribution<int> length(2, 4);
+  std::uniform_int_distribution<int> letter('a', 'z');
+
+  std::vector<std::string> words(static_cast<size_t>(opt.keywords));
+  for (std::string& w : words) {
+    const int n = length(rng);
+    for (int k = 0; k < n; ++k) w += kSyllables[syl(rng)];
+  }
+  std::vector<const char*> views;
+  for (const std::string& w : words) views.push_back(w.c_str());
+
+  std::uniform_int_distribution<int> pick(0, opt.keywords - 1);
+  std::uniform_int_distribution<int> edits(0, 2);
+  std::vector<std::string> queries(static_cast<size_t>(opt.iters));
+  for (std::string& q : queries) {
+    q = words[static_cast<size_t>(pick(rng))];
+    for (int e = edits(rng); e > 0; --e) {
+      const size_t at = std::uniform_int_distribution<size_t>(0, q.size() - 1)(rng);
+      switch (e % 3) {
+        case 0: q[at] = static_cast<char>(letter(rng)); break;
+        case 1: q.insert(q.begin() + static_cast<std::ptrdiff_t>(at), static_cast<char>(letter(rng))); break;
+        default: if (q.size() > 1) q.erase(at, 1); break;
+      }
+    }
+  }
+
+  const size_t count = words.size();
+  std::vector<int32_t> dp(count), bits(count), batch(count);
+  std::vector<int64_t> dpNs, bitsNs, batchNs;
+  int mismatches = 0, bestAgrees = 0;
+  for (const std::string& q : queries) {
+    int64_t t0 = nowNs();
+    for (size_t k = 0; k < count; ++k) dp[k] = dpDistance(q, words[k]);
+    dpNs.push_back(nowNs() - t0);
+
+    t0 = nowNs();
+    for (size_t k = 0; k < count; ++k) bits[k] = editDistance(q.c_str(), q.size(), words[k].c_str(), words[k].size());
+    bitsNs.push_back(nowNs() - t0);
+
+    t0 = nowNs();
+    const int best = editDistanceBatch(q.c_str(), views.data(), opt.keywords, opt.maxDistance, batch.data());
+    batchNs.push_back(nowNs() - t0);
+
+    for (size_t k = 0; k < count; ++k) mismatches += dp[k] != bits[k] ? 1 : 0;
+    // 截断内的最优：与 DP 的最小距离 (并列取靠前) 一致
+    const auto minIt = std::min_element(dp.begin(), dp.end());
+    const int expected = opt.maxDistance < 0 || *minIt <= opt.maxDistance ? static_cast<int>(minIt - dp.begin()) : -1;
+    bestAgrees += best == expected ? 1 : 0;
+  }
+
+  printf("dictionary: %d pinyin keywords, %d queries (0-2 edits), cutoff %d\n", opt.keywords, opt.iters,
+         opt.maxDistance);
+  report("DP (per pair)", dpNs, opt.keywords);
+  report("bit-parallel (per pair)", bitsNs, opt.keywords);
+  report("batch + cutoff", batchNs, opt.keywords);
+  double dpMean = 0.0, batchMean = 0.0;
+  for (int64_t v : dpNs) dpMean += static_cast<double>(v);
+  for (int64_t v : batchNs) batchMean += static_cast<double>(v);
+  printf("speedup   : %.1fx (batch vs DP)\n", batchMean > 0.0 ? dpMean / batchMean : 0.0);
+  printf("check     : %d distance mismatches, best agrees %d/%d\n", mismatches, bestAgrees, opt.iters);
+  return mismatches == 0 && bestAgrees == opt.iters ? 0 : 1;
+}
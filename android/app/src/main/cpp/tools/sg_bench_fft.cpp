@@ -0,0 +1,156 @@
+// SilenceGuard Pro — 实数 FFT 基准 sg_bench_fft (host)
+// 对 8 – max-size 的每个 2 的幂：随机输入上 RealFft::forward 与双精度直接 DFT 比较最大误差
+// (相对于参考谱的峰值幅度)，并对比原 simpleDft (逐项 cos / sin 的 O(N²) 单精度 DFT) 的幅度谱耗时
+// 全部尺寸误差在阈值内时退出码为 0
+//
+// 用法: sg_bench_fft [选项]
+//   --max-size N      最大变换长度 (默认 4096)
+//   --min-ms N        每个尺寸每种实现的最短计时 (默认 200)
+//   --tolerance X     相对误差阈值 (默认 1e-5)
+//   --seed N          随机种子 (默认 1)
+
+#include "feature_extraction/MelSpectrogram.h"
+#include "feature_extraction/RealFft.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+using namespace silenceguard;
+
+constexpr double kPi = 3.14159265358979323846;
+constexpr int kMinSize = 8;
+
+struct Options {
+  int maxSize = 4096;
+  int minMs = 200;
+  double tolerance = 1e-5;
+  unsigned seed = 1;
+};
+
+void usage() { fprintf(stderr, "usage: sg_bench_fft [--max-size N] [--min-ms N] [--tolerance X] [--seed N]\n"); }
+
+bool parseArgs(int argc, char** argv, Options* opt) {
+  for (int i = 1; i < argc; ++i) {
+    std::string a = argv[i];
+    if (i + 1 >= argc) return false;
+    const char* v = argv[++i];
+    if (a == "--max-size") {
+      opt->maxSize = std::max(kMinSize, static_cast<int>(std::strtol(v, nullptr, 10)));
+    } else if (a == "--min-ms") {
+      opt->minMs = std::max(1, static_cast<int>(std::strtol(v, nullptr, 10)));
+    } else if (a == "--tolerance") {
+      opt->tolerance = std::strtod(v, nullptr);
+    } else if (a == "--seed") {
+      opt->seed = static_cast<unsigned>(std::strtoul(v, nullptr, 10));
+    } else {
+      return false;
+    }
+  }
+  return true;
+}
+
+// 改动前 MelSpectrogram.cpp 的实现 (长度参数化)：每一项现算 cos / sin
+void simpleDft(const std::vector<float>& pcm, int N, std::vector<float>& magSpec) {
+  const float pi = static_cast<float>(kPi);
+  magSpec.resize(N / 2 + 1);
+  for (int k = 0; k <= N / 2; ++k) {
+    float re = 0.0f;
+    float im = 0.0f;
+    float angleTerm = -2.0f * pi * k / N;
+    for (int n = 0; n < N; ++n) {
+      float input = (n < static_cast<int>(pcm.size())) ? pcm[n] : 0.0f;
+      re += input * std::cos(angleTerm * n);
+      im += input * std::sin(angleTerm * n);
+    }
+    magSpec[k] = std::sqrt(re * re + im * im);
+  }
+}
+
+// 双精度参考：相位按 (k·n mod N) 取整数下标，避免大 N 时角度累积误差
+void referenceDft(const std::vector<float>& x, int N, std::vector<double>* re, std::vector<double>* im) {
+  std::vector<double> c(N), s(N);
+  for (int i = 0; i < N; ++i) {
+    c[i] = std::cos(-2.0 * kPi * i / N);
+    s[i] = std::sin(-2.0 * kPi * i / N);
+  }
+  re->assign(N / 2 + 1, 0.0);
+  im->assign(N / 2 + 1, 0.0);
+  for (int k = 0; k <= N / 2; ++k) {
+    double sr = 0.0, si = 0.0;
+    for (int n = 0; n < N; ++n) {
+      const int idx = static_cast<int>((static_cast<int64_t>(k) * n) % N);
+      sr += x[n] * c[idx];
+      si += x[n] * s[idx];
+    }
+    (*re)[k] = sr;
+    (*im)[k] = si;
+  }
+}
+
+// 重复调用 fn 至少 minMs，返回每次平均耗时 (ns)
+template <typename Fn>
+double timePerCall(int minMs, Fn fn) {
+  using Clock = std::chrono::steady_clock;
+  const auto budget = std::chrono::milliseconds(minMs);
+  const auto t0 = Clock::now();
+  int64_t calls = 0;
+  do {
+    fn();
+    ++calls;
+  } while (Clock::now() - t0 < budget);
+  return std::chrono::duration<double, std::nano>(Clock::now() - t0).count() / static_cast<double>(calls);
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  Options opt;
+  if (!parseArgs(argc, argv, &opt)) {
+    usage();
+    return 2;
+  }
+  std::mt19937 rng(opt.seed);
+  std::uniform_real_distribution<float> sample(-1.0f, 1.0f);
+
+  printf("%6s  %12s %12s  %12s %12s %9s\n", "size", "fft err", "dft err", "fft ns", "dft ns", "speedup");
+  bool pass = true;
+  for (int N = kMinSize; N <= opt.maxSize; N *= 2) {
+    std::vector<float> x(N);
+    for (float& v : x) v = sample(rng);
+    std::vector<double> refRe, refIm;
+    referenceDft(x, N, &refRe, &refIm);
+
+    RealFft fft(N);
+    const int bins = fft.numBins();
+    std::vector<float> re(bins), im(bins), mag(bins), dftMag;
+    fft.forward(x.data(), re.data(), im.data());
+    simpleDft(x, N, dftMag);
+
+    // 误差以参考谱峰值幅度归一：复数输出逐 bin 比较；simpleDft 只有幅度，按幅度比较
+    double peak = 0.0, fftErr = 0.0, dftErr = 0.0;
+    for (int k = 0; k < bins; ++k) peak = std::max(peak, std::hypot(refRe[k], refIm[k]));
+    for (int k = 0; k < bins; ++k) {
+      fftErr = std::max(fftErr, std::hypot(re[k] - refRe[k], im[k] - refIm[k]));
+      dftErr = std::max(dftErr, std::fabs(dftMag[k] - std::hypot(refRe[k], refIm[k])));
+    }
+    fftErr /= peak;
+    dftErr /= peak;
+
+    const double fftNs = timePerCall(opt.minMs, [&] { fft.magnitudeSpectrum(x.data(), mag.data()); });
+    const double dftNs = timePerCall(opt.minMs, [&] { simpleDft(x, N, dftMag); });
+    const bool ok = fftErr <= opt.tolerance;
+    pass = pass && ok;
+    printf("%6d  %12.3e %12.3e  %12.1f %12.1f %8.1fx%s%s\n", N, fftErr, dftErr, fftNs, dftNs, dftNs / fftNs,
+           N == kFftSize ? "  (Mel frame)" : "", ok ? "" : "  FAIL");
+  }
+  printf("check : %s (max relative error <= %.1e at every size)\n", pass ? "PASS" : "FAIL", opt.tolerance);
+  return pass ? 0 : 1;
+}
@@ -0,0 +1,230 @@
+// SilenceGuard Pro — 噪声掩蔽器基准 sg_bench_masker (host)
+// 48kHz 立体声 (交错 int16) 合成语音上，按不同 HAL buffer 大小比较三种实现：
+// - 向量化块流水线 NoiseMasker::process (SIMD 转换 / 噪声 / 调制)
+// - 标量逐样本循环，噪声取自同一 NoiseGenerator (按同样的 256 样本块取数)：输出须逐位一致
+// - 改动前的实现 (std::mt19937 + uniform_real_distribution 逐样本)：只作耗时基线
+// 输出逐位一致时退出码为 0
+//
+// 用法: sg_bench_masker [选项]
+//   --seconds S     合成音频时长 (默认 2)
+//   --rate HZ       采样率 (默认 48000)
+//   --channels N    声道数 (默认 2)
+//   --attack MS     包络起步时间 (默认 10)
+//   --release MS    包络释放时间 (默认 50)
+//   --seed N        噪声种子 (默认 1)
+
+#include "injector/AudioInjector.h"
+#include "injector/NoiseGenerator.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+using namespace silenceguard;
+
+constexpr size_t kBlockFrames = 256;  // 与 NoiseMasker 的块大小一致：噪声按同样的块取数
+constexpr float kPi = 3.14159265358979f;
+
+struct Options {
+  double seconds = 2.0;
+  int rate = 48000;
+  int channels = 2;
+  float attackMs = 10.0f;
+  float releaseMs = 50.0f;
+  uint64_t seed = 1;
+};
+
+void usage() {
+  fprintf(stderr,
+          "usage: sg_bench_masker [--seconds S] [--rate HZ] [--channels N] [--attack MS] [--release MS] "
+          "[--seed N]\n");
+}
+
+bool parseArgs(int argc, char** argv, Options* opt) {
+  for (int i = 1; i < argc; ++i) {
+    std::string a = argv[i];
+    if (i + 1 >= argc) return false;
+    const char* v = argv[++i];
+    if (a == "--seconds") {
+      opt->seconds = std::max(0.01, std::strtod(v, nullptr));
+    } else if (a == "--rate") {
+      opt->rate = std::max(8000, static_cast<int>(std::strtol(v, nullptr, 10)));
+    } else if (a == "--channels") {
+      opt->channels = std::max(1, static_cast<int>(std::strtol(v, nullptr, 10)));
+    } else if (a == "--attack") {
+      opt->attackMs = std::strtof(v, nullptr);
+    } else if (a == "--release") {
+      opt->releaseMs = std::strtof(v, nullptr);
+    } else if (a == "--seed") {
+      opt->seed = std::strtoull(v, nullptr, 10);
+    } else {
+      return false;
+    }
+  }
+  return true;
+}
+
+// 与 NoiseMasker::setEnvelopeParams 相同的系数
+void envelopeCoeffs(float rate, float attackMs, float releaseMs, float* attack, float* release) {
+  attackMs = std::max(1.0f, attackMs);
+  releaseMs = std::max(1.0f, releaseMs);
+  *attack = 1.0f - std::exp(-1000.0f / (attackMs * rate));
+  *release = 1.0f - std::exp(-1000.0f / (releaseMs * rate));
+}
+
+// 标量参考：改动前的逐样本循环，噪声按 NoiseMasker 的块长从同一噪声源取数
+class ScalarMasker {
+ public:
+  ScalarMasker(float rate, float attackMs, float releaseMs, uint64_t seed) : noise_(seed) {
+    envelopeCoeffs(rate, attackMs, releaseMs, &attack_, &release_);
+  }
+
+  void process(int16_t* buffer, size_t frames) {
+    float noise[kBlockFrames];
+    for (size_t pos = 0; pos < frames; pos += kBlockFrames) {
+      const size_t n = std::min(kBlockFrames, frames - pos);
+      noise_.fill(noise, n);
+      for (size_t i = 0; i < n; ++i) buffer[pos + i] = step(buffer[pos + i], noise[i]);
+    }
+  }
+
+ private:
+  int16_t step(int16_t sample, float noise) {
+    const float kInt16Max = 32767.0f;
+    float input = static_cast<float>(sample) / kInt16Max;
+    float inputAbs = std::abs(input);
+    if (inputAbs > env_) {
+      env_ += attack_ * (inputAbs - env_);
+    } else {
+      env_ += release_ * (inputAbs - env_);
+    }
+    float output = noise * env_ * 1.0f;
+    if (output > 1.0f) output = 1.0f;
+    if (output < -1.0f) output = -1.0f;
+    return static_cast<int16_t>(output * kInt16Max);
+  }
+
+  NoiseGenerator noise_;
+  float attack_ = 0.0f;
+  float release_ = 0.0f;
+  float env_ = 0.0f;
+};
+
+// 改动前的实现：std::mt19937 + uniform_real_distribution 逐样本 (耗时基线)
+class LegacyMasker {
+ public:
+  LegacyMasker(float rate, float attackMs, float releaseMs, uint64_t seed)
+      : rng_(static_cast<std::mt19937::result_type>(seed)), dist_(-1.0f, 1.0f) {
+    envelopeCoeffs(rate, attackMs, releaseMs, &attack_, &release_);
+  }
+
+  void process(int16_t* buffer, size_t frames) {
+    const float kInt16Max = 32767.0f;
+    for (size_t i = 0; i < frames; ++i) {
+      float input = static_cast<float>(buffer[i]) / kInt16Max;
+      float inputAbs = std::abs(input);
+      if (inputAbs > env_) {
+        env_ += attack_ * (inputAbs - env_);
+      } else {
+        env_ += release_ * (inputAbs - env_);
+      }
+      float output = dist_(rng_) * env_ * 1.0f;
+      if (output > 1.0f) output = 1.0f;
+      if (output < -1.0f) output = -1.0f;
+      buffer[i] = static_cast<int16_t>(output * kInt16Max);
+    }
+  }
+
+ private:
+  std::mt19937 rng_;
+  std::uniform_real_distribution<float> dist_;
+  float attack_ = 0.0f;
+  float release_ = 0.0f;
+  float env_ = 0.0f;
+};
+
+// 合成 "语音"：音节包络 (4Hz) 调制的基频谐波 + 少量噪声，声道间略有相位差
+std::vector<int16_t> synthSpeech(const Options& opt) {
+  const size_t frames = static_cast<size_t>(opt.seconds * opt.rate);
+  std::vector<int16_t> pcm(frames * static_cast<size_t>(opt.channels));
+  std::mt19937 rng(12345);
+  std::uniform_real_distribution<float> hiss(-0.02f, 0.02f);
+  for (size_t i = 0; i < frames; ++i) {
+    const float t = static_cast<float>(i) / static_cast<float>(opt.rate);
+    const float syllable = std::max(0.0f, std::sin(2.0f * kPi * 4.0f * t));
+    for (int c = 0; c < opt.channels; ++c) {
+      const float ph = 2.0f * kPi * 140.0f * t + 0.3f * static_cast<float>(c);
+      const float v = syllable * (0.5f * std::sin(ph) + 0.25f * std::sin(2.0f * ph) + 0.12f * std::sin(3.0f * ph)) +
+                      hiss(rng);
+      pcm[i * static_cast<size_t>(opt.channels) + static_cast<size_t>(c)] =
+          static_cast<int16_t>(std::max(-1.0f, std::min(1.0f, v)) * 32767.0f);
+    }
+  }
+  return pcm;
+}
+
+// 按 HAL buffer 大小逐块处理整段音频，返回每样本耗时 (ns)；out 为处理结果
+template <typename Masker>
+double run(Masker& masker, const std::vector<int16_t>& input, size_t period, std::vector<int16_t>* out) {
+  *out = input;
+  const auto t0 = std::chrono::steady_clock::now();
+  for (size_t pos = 0; pos < out->size(); pos += period) {
+    masker.process(out->data() + pos, std::min(period, out->size() - pos));
+  }
+  const double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - t0).count();
+  return ns / static_cast<double>(out->size());
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  Options opt;
+  if (!parseArgs(argc, argv, &opt)) {
+    usage();
+    return 2;
+  }
+  const std::vector<int16_t> input = synthSpeech(opt);
+  const float rate = static_cast<float>(opt.rate);
+  printf("input : %.1f s synthetic speech, %d Hz x %d ch (%zu samples), attack %.0f ms, release %.0f ms\n",
+         opt.seconds, opt.rate, opt.channels, input.size(), opt.attackMs, opt.releaseMs);
+  printf("%8s  %12s %12s %12s %9s  %s\n", "period", "vector ns", "scalar ns", "legacy ns", "speedup", "output");
+
+  bool identical = true;
+  // HAL buffer：2 / 5 / 10 / 20 ms (立体声交错样本数)
+  for (int ms : {2, 5, 10, 20}) {
+    const size_t period = static_cast<size_t>(opt.rate / 1000 * ms * opt.channels);
+    std::vector<int16_t> vec, ref, legacyOut;
+
+    NoiseMasker masker(rate);
+    masker.setEnvelopeParams(opt.attackMs, opt.releaseMs);
+    masker.seed(opt.seed);
+    const double vecNs = run(masker, input, period, &vec);
+
+    ScalarMasker scalar(rate, opt.attackMs, opt.releaseMs, opt.seed);
+    const double scalarNs = run(scalar, input, period, &ref);
+
+    LegacyMasker legacy(rate, opt.attackMs, opt.releaseMs, opt.seed);
+    const double legacyNs = run(legacy, input, period, &legacyOut);
+
+    size_t diff = 0;
+    for (size_t i = 0; i < vec.size(); ++i) diff += vec[i] != ref[i] ? 1 : 0;
+    identical = identical && diff == 0;
+    char verdict[48];
+    if (diff == 0) {
+      snprintf(verdict, sizeof(verdict), "identical");
+    } else {
+      snprintf(verdict, sizeof(verdict), "%zu samples differ", diff);
+    }
+    printf("%5zu (%2d ms)  %6.2f %12.2f %12.2f %8.1fx  %s\n", period, ms, vecNs, scalarNs, legacyNs,
+           legacyNs / vecNs, verdict);
+  }
+  printf("check : %s (vector pipeline vs scalar loop on the same noise source)\n", identical ? "PASS" : "FAIL");
+  return identical ? 0 : 1;
+}
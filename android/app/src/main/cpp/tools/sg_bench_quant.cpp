@@ -0,0 +1,236 @@
+// SilenceGuard Pro — 量化模型对比基准 sg_bench_quant (host)
+// 同一段回放音频、同一组 Mel 窗口 (与 Engine 相同的流式提取与步长调度)，
+// 分别送入 float 与 int8 / uint8 模型：比较推理阶段延迟 (写入特征 + 量化 + Invoke + 反量化)
+// 与拦截决策一致性。两个模型各用独立的 TFLiteRunner 实例，交替先后顺序以抵消缓存偏差
+//
+// 用法: sg_bench_quant [选项] <input.wav | input.pcm>
+//   --float PATH      float32 模型 (stub 后端默认 "stub-float")
+//   --quant PATH      全整型量化模型 (stub 后端默认 "stub-int8"，含 "uint8" 则为 uint8 变体)
+//   --stride-ms N     推理步长 (默认 160，与 Engine 默认一致)
+//   --threshold X     决策阈值：后验之和 > X 视为拦截 (默认 0.85，与 global_sensitivity 默认一致)
+//   --threads N       TFLite 线程数 (默认 TFLite 自定)
+//   --xnnpack 0|1     XNNPACK delegate (默认 1)
+//   --warmup N        加载时预跑次数 (默认 1)
+//   --rate HZ         裸 PCM 的采样率 (默认 16000)
+//   --repeat N        输入循环 N 次 (拉长测量)
+
+#include "core/InferenceScheduler.h"
+#include "StreamingMelExtractor.h"
+#include "TFLiteRunner.h"
+#include "tools/ReplayAudio.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+namespace {
+
+using namespace silenceguard;
+
+// 与 HAL 常见周期一致：20ms @ 16kHz
+constexpr size_t kPeriodFrames = 320;
+
+struct Options {
+  std::string input;
+#if defined(SG_INFERENCE_STUB)
+  std::string floatModel = "stub-float";
+  std::string quantModel = "stub-int8";
+#else
+  std::string floatModel;
+  std::string quantModel;
+#endif
+  int strideMs = kDefaultInferenceStrideMs;
+  float threshold = 0.85f;
+  int rawRate = kSampleRate;
+  int repeat = 1;
+  TFLiteLoadOptions load;
+};
+
+void usage() {
+  fprintf(stderr,
+          "usage: sg_bench_quant [--float PATH] [--quant PATH] [--stride-ms N] [--threshold X]\n"
+          "                      [--threads N] [--xnnpack 0|1] [--warmup N] [--rate HZ] [--repeat N]\n"
+          "                      <input.wav|input.pcm>\n");
+}
+
+bool parseArgs(int argc, char** argv, Options* opt) {
+  opt->load.warmupRuns = 1;
+  for (int i = 1; i < argc; ++i) {
+    std::string a = argv[i];
+    auto next = [&](const char** v) {
+      if (i + 1 >= argc) return false;
+      *v = argv[++i];
+      return true;
+    };
+    const char* v = nullptr;
+    if (a == "--float" && next(&v)) {
+      opt->floatModel = v;
+    } else if (a == "--quant" && next(&v)) {
+      opt->quantModel = v;
+    } else if (a == "--stride-ms" && next(&v)) {
+      opt->strideMs = static_cast<int>(std::strtol(v, nullptr, 10));
+    } else if (a == "--threshold" && next(&v)) {
+      opt->threshold = std::strtof(v, nullptr);
+    } else if (a == "--threads" && next(&v)) {
+      opt->load.numThreads = static_cast<int>(std::strtol(v, nullptr, 10));
+    } else if (a == "--xnnpack" && next(&v)) {
+      opt->load.useXnnpack = std::strtol(v, nullptr, 10) != 0;
+    } else if (a == "--warmup" && next(&v)) {
+      opt->load.warmupRuns = std::max(0, static_cast<int>(std::strtol(v, nullptr, 10)));
+    } else if (a == "--rate" && next(&v)) {
+      opt->rawRate = static_cast<int>(std::strtol(v, nullptr, 10));
+    } else if (a == "--repeat" && next(&v)) {
+      opt->repeat = std::max(1, static_cast<int>(std::strtol(v, nullptr, 10)));
+    } else if (!a.empty() && a[0] != '-' && opt->input.empty()) {
+      opt->input = a;
+    } else {
+      return false;
+    }
+  }
+  return !opt->input.empty() && !opt->floatModel.empty() && !opt->quantModel.empty();
+}
+
+const char* typeName(TensorType type) {
+  switch (type) {
+    case TensorType::kInt8: return "int8";
+    case TensorType::kUInt8: return "uint8";
+    default: return "float32";
+  }
+}
+
+// 单个被测模型：独立 runner + 每窗口耗时与风险分
+struct Candidate {
+  const char* label;
+  std::string path;
+  TFLiteRunner runner;
+  std::vector<int64_t> latencyNs;
+  std::vector<float> risk;
+};
+
+// 与 Engine::analyzeLocked 的推理阶段相同：滚动矩阵直接写入张量 → invoke → 后验求和
+bool inferWindow(Candidate* c, const StreamingMelExtractor& mel) {
+  using Clock = std::chrono::steady_clock;
+  const Clock::time_point t0 = Clock::now();
+  TFLiteRunner::Lease model = c->runner.acquire();
+  const int tensorFrames = static_cast<int>(std::min<size_t>(kMaxFrames, model.inputInfo().size / kMelBins));
+  MelRows first, second;
+  if (mel.latestRows(tensorFrames, &first, &second) == 0) return false;
+  model.writeInput(0, first.data, static_cast<size_t>(first.frames) * kMelBins);
+  if (second.frames > 0) {
+    model.writeInput(static_cast<size_t>(first.frames) * kMelBins, second.data,
+                     static_cast<size_t>(second.frames) * kMelBins);
+  }
+  if (!model.invoke()) return false;
+  ConstFloatSpan posteriors = model.output();
+  float risk = 0.0f;
+  for (size_t i = 0; i < posteriors.size; ++i) risk += posteriors.data[i];
+  c->latencyNs.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - t0).count());
+  c->risk.push_back(risk);
+  return true;
+}
+
+double mean(const std::vector<int64_t>& v) {
+  if (v.empty()) return 0.0;
+  double sum = 0.0;
+  for (int64_t x : v) sum += static_cast<double>(x);
+  return sum / static_cast<double>(v.size());
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  Options opt;
+  if (!parseArgs(argc, argv, &opt)) {
+    usage();
+    return 2;
+  }
+
+  ReplayAudio audio;
+  if (!loadReplayAudio(opt.input, opt.rawRate, &audio) || audio.pcm.empty()) {
+    fprintf(stderr, "sg_bench_quant: no audio in %s\n", opt.input.c_str());
+    return 1;
+  }
+  if (audio.sampleRate != kSampleRate) {
+    fprintf(stderr, "sg_bench_quant: warning: input is %d Hz, analysis path assumes %d Hz\n",
+            audio.sampleRate, kSampleRate);
+  }
+
+  Candidate candidates[2] = {{"float", opt.floatModel, {}, {}, {}}, {"quant", opt.quantModel, {}, {}, {}}};
+  for (Candidate& c : candidates) {
+    if (!c.runner.loadModel(c.path.c_str(), opt.load)) {
+      fprintf(stderr, "sg_bench_quant: cannot load %s model %s\n", c.label, c.path.c_str());
+      return 1;
+    }
+    if (c.runner.loadTimings().chunkFrames > 0) {
+      fprintf(stderr, "sg_bench_quant: %s is a streaming model; compare streaming models with sg_replay\n",
+              c.path.c_str());
+      return 2;
+    }
+  }
+
+  StreamingMelExtractor mel;
+  InferenceScheduler scheduler(opt.strideMs);
+  std::vector<int16_t> period(kPeriodFrames);
+  const size_t total = audio.pcm.size() * static_cast<size_t>(opt.repeat);
+  size_t windows = 0;
+  for (size_t fed = 0; fed < total; fed += kPeriodFrames) {
+    const size_t n = std::min(kPeriodFrames, total - fed);
+    for (size_t i = 0; i < n; ++i) period[i] = audio.pcm[(fed + i) % audio.pcm.size()];
+    if (mel.push(period.data(), n) == 0 || !scheduler.shouldRun(mel.totalFrames())) continue;
+
+    // 交替先后：避免总让同一个模型吃到热缓存
+    const int order = static_cast<int>(windows & 1);
+    bool ok = inferWindow(&candidates[order], mel) && inferWindow(&candidates[order ^ 1], mel);
+    if (!ok) {
+      fprintf(stderr, "sg_bench_quant: inference failed at window %zu\n", windows);
+      return 1;
+    }
+    ++windows;
+  }
+  if (windows == 0) {
+    fprintf(stderr, "sg_bench_quant: input too short for a single window\n");
+    return 1;
+  }
+
+  printf("input     : %s (%d Hz, %.2f s x %d), stride %d ms, %zu windows\n", opt.input.c_str(),
+         audio.sampleRate, static_cast<double>(audio.pcm.size()) / kSampleRate, opt.repeat,
+         scheduler.strideMs(), windows);
+  printf("\nmodel   tensors              p50 us    p90 us    p99 us   mean us   load us  path\n");
+  for (Candidate& c : candidates) {
+    TFLiteLoadTimings t = c.runner.loadTimings();
+    std::vector<int64_t> sorted = c.latencyNs;
+    std::sort(sorted.begin(), sorted.end());
+    char tensors[32];
+    snprintf(tensors, sizeof(tensors), "%s -> %s", typeName(t.inputType), typeName(t.outputType));
+    printf("  %-5s %-18s %9.2f %9.2f %9.2f %9.2f %9u  %s\n", c.label, tensors, percentile(sorted, 0.50) / 1e3,
+           percentile(sorted, 0.90) / 1e3, percentile(sorted, 0.99) / 1e3, mean(c.latencyNs) / 1e3,
+           static_cast<unsigned>(t.loadUs), c.path.c_str());
+  }
+  const double floatMean = mean(candidates[0].latencyNs), quantMean = mean(candidates[1].latencyNs);
+  printf("  speedup (mean) %.2fx\n", quantMean > 0.0 ? floatMean / quantMean : 0.0);
+
+  // 决策一致性：同一窗口上两个模型是否同时超过 / 同时未超过阈值
+  size_t agree = 0, floatOnly = 0, quantOnly = 0, positives = 0;
+  double sumDiff = 0.0, maxDiff = 0.0;
+  for (size_t i = 0; i < windows; ++i) {
+    const float a = candidates[0].risk[i], b = candidates[1].risk[i];
+    const bool da = a > opt.threshold, db = b > opt.threshold;
+    if (da == db) ++agree;
+    if (da && !db) ++floatOnly;
+    if (db && !da) ++quantOnly;
+    if (da) ++positives;
+    const double d = std::fabs(static_cast<double>(a) - static_cast<double>(b));
+    sumDiff += d;
+    maxDiff = std::max(maxDiff, d);
+  }
+  printf("\ndecisions : threshold %.3f, float %zu intercepts, agreement %zu/%zu (%.2f%%), "
+         "float-only %zu, quant-only %zu\n",
+         opt.threshold, positives, agree, windows, 100.0 * static_cast<double>(agree) / static_cast<double>(windows),
+         floatOnly, quantOnly);
+  printf("risk |d|  : mean %.5f, max %.5f\n", sumDiff / static_cast<double>(windows), maxDiff);
+  return 0;
+}
@@ -0,0 +1,225 @@
+// SilenceGuard Pro — 环形缓冲 SPSC 压测 / 吞吐 sg_bench_ring (host)
+// 压测：生产者线程按随机块长写入位置序列 (样本 = 位置 mod 32768)，消费者线程以随机块长读出并随机停顿，
+// 反复被套圈；逐样本校验：一次 read 内必须是连续位置，相邻两次 read 之间的缺口必须恰好等于
+// overruns 的增量 —— 任何撕裂 (拷贝期间被覆盖的样本) 都会破坏其中之一
+// 吞吐：消费者跟得上时的跨线程传输速率 (生产者按 available() 流控，不丢样本)，
+// 以及 DelayLine 式的同线程 write + read 每样本耗时
+// 校验全部通过时退出码为 0
+//
+// 用法: sg_bench_ring [选项]
+//   --seconds S     压测时长 (默认 2)
+//   --capacity N    压测环容量 (默认 1024，小容量更容易被套圈)
+//   --chunk N       随机块长上限 (默认 480)
+//   --samples N     吞吐测试的样本数 (默认 64M)
+//   --seed N        随机种子 (默认 1)
+
+#include "core/RingBuffer.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using namespace silenceguard;
+
+constexpr uint32_t kValueMask = 0x7fff;  // 样本值 = 位置 mod 32768
+
+struct Options {
+  double seconds = 2.0;
+  size_t capacity = 1024;
+  size_t chunk = 480;
+  uint64_t samples = 64ull << 20;
+  unsigned seed = 1;
+};
+
+void usage() {
+  fprintf(stderr, "usage: sg_bench_ring [--seconds S] [--capacity N] [--chunk N] [--samples N] [--seed N]\n");
+}
+
+bool parseArgs(int argc, char** argv, Options* opt) {
+  for (int i = 1; i < argc; ++i) {
+    std::string a = argv[i];
+    if (i + 1 >= argc) return false;
+    const char* v = argv[++i];
+    if (a == "--seconds") {
+      opt->seconds = std::max(0.01, std::strtod(v, nullptr));
+    } else if (a == "--capacity") {
+      opt->capacity = static_cast<size_t>(std::max(2L, std::strtol(v, nullptr, 10)));
+    } else if (a == "--chunk") {
+      opt->chunk = static_cast<size_t>(std::max(1L, std::strtol(v, nullptr, 10)));
+    } else if (a == "--samples") {
+      opt->samples = std::max<uint64_t>(1, std::strtoull(v, nullptr, 10));
+    } else if (a == "--seed") {
+      opt->seed = static_cast<unsigned>(std::strtoul(v, nullptr, 10));
+    } else {
+      return false;
+    }
+  }
+  return true;
+}
+
+double secondsSince(std::chrono::steady_clock::time_point t0) {
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+}
+
+void fillSequence(int16_t* dst, uint64_t pos, size_t n) {
+  for (size_t i = 0; i < n; ++i) dst[i] = static_cast<int16_t>((pos + i) & kValueMask);
+}
+
+struct StressResult {
+  uint64_t written = 0;
+  uint64_t read = 0;
+  uint64_t reads = 0;
+  uint64_t overruns = 0;
+  uint64_t torn = 0;  // 不连续的样本 (块内) 或与 overruns 不符的缺口 (块间)
+};
+
+StressResult stress(const Options& opt) {
+  RingBuffer ring(opt.capacity);
+  StressResult res;
+  std::atomic<bool> stop{false};
+
+  std::thread producer([&] {
+    std::mt19937 rng(opt.seed);
+    std::uniform_int_distribution<size_t> len(1, opt.chunk);
+    std::vector<int16_t> buf(opt.chunk);
+    uint64_t pos = 0;
+    while (!stop.load(std::memory_order_relaxed)) {
+      const size_t n = len(rng);
+      fillSequence(buf.data(), pos, n);
+      ring.write(buf.data(), n);
+      pos += n;
+    }
+    res.written = pos;
+  });
+
+  std::mt19937 rng(opt.seed * 7919u + 1);
+  std::uniform_int_distribution<size_t> len(1, opt.chunk);
+  std::uniform_int_distribution<int> pause(0, 15);
+  std::vector<int16_t> buf(opt.chunk);
+  bool started = false;
+  uint32_t last = 0;
+  uint64_t overruns = 0;
+  const auto t0 = std::chrono::steady_clock::now();
+  while (secondsSince(t0) < opt.seconds) {
+    const size_t got = ring.read(buf.data(), len(rng));
+    const uint64_t nowOverruns = ring.overruns();
+    if (got > 0) {
+      const uint32_t first = static_cast<uint16_t>(buf[0]);
+      // 块间缺口 (mod 32768) = 本次 read 跳过 / 丢弃的样本数
+      if (started && ((first - last - 1) & kValueMask) != ((nowOverruns - overruns) & kValueMask)) ++res.torn;
+      for (size_t i = 1; i < got; ++i) {
+        if (static_cast<uint32_t>(static_cast<uint16_t>(buf[i])) != ((static_cast<uint16_t>(buf[i - 1]) + 1u) & kValueMask))
+          ++res.torn;
+      }
+      last = static_cast<uint16_t>(buf[got - 1]);
+      started = true;
+      res.read += got;
+      ++res.reads;
+      overruns = nowOverruns;
+    }
+    // 随机停顿让生产者套圈；0 时立即再读，和写入交错在同一圈内
+    const int p = pause(rng);
+    if (p >= 14) {
+      std::this_thread::sleep_for(std::chrono::microseconds(50));
+    } else {
+      for (int k = 0; k < p * 64; ++k) std::atomic_signal_fence(std::memory_order_seq_cst);
+    }
+  }
+  stop.store(true, std::memory_order_relaxed);
+  producer.join();
+  res.overruns = ring.overruns();
+  return res;
+}
+
+// 跨线程传输：生产者只在有空位时写入 (不丢样本)，消费者尽快读出
+double spscThroughput(uint64_t total, size_t chunk, bool* intact) {
+  RingBuffer ring(kRingCapacityFrames);
+  std::thread producer([&] {
+    std::vector<int16_t> buf(chunk);
+    for (uint64_t pos = 0; pos < total;) {
+      const size_t n = static_cast<size_t>(std::min<uint64_t>(chunk, total - pos));
+      if (ring.capacity() - ring.available() < n) {
+        std::this_thread::yield();
+        continue;
+      }
+      fillSequence(buf.data(), pos, n);
+      ring.write(buf.data(), n);
+      pos += n;
+    }
+  });
+  std::vector<int16_t> buf(chunk);
+  uint64_t pos = 0;
+  bool ok = true;
+  const auto t0 = std::chrono::steady_clock::now();
+  while (pos < total) {
+    const size_t got = ring.read(buf.data(), chunk);
+    if (got == 0) {
+      std::this_thread::yield();
+      continue;
+    }
+    for (size_t i = 0; i < got; ++i) ok = ok && static_cast<uint16_t>(buf[i]) == ((pos + i) & kValueMask);
+    pos += got;
+  }
+  const double s = secondsSince(t0);
+  producer.join();
+  *intact = ok && ring.overruns() == 0;
+  return static_cast<double>(total) / s;
+}
+
+// DelayLine 式：同一线程每块先 write 再 read (环内保持固定延迟)
+double sameThreadNsPerSample(uint64_t total, size_t chunk) {
+  RingBuffer ring(kRingCapacityFrames);
+  std::vector<int16_t> zeros(kRingCapacityFrames / 2, 0);
+  ring.write(zeros.data(), zeros.size());
+  std::vector<int16_t> buf(chunk);
+  fillSequence(buf.data(), 0, chunk);
+  const uint64_t rounds = std::max<uint64_t>(1, total / chunk);
+  const auto t0 = std::chrono::steady_clock::now();
+  for (uint64_t k = 0; k < rounds; ++k) {
+    ring.write(buf.data(), chunk);
+    ring.read(buf.data(), chunk);
+  }
+  return secondsSince(t0) * 1e9 / static_cast<double>(rounds * chunk);
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  Options opt;
+  if (!parseArgs(argc, argv, &opt)) {
+    usage();
+    return 2;
+  }
+
+  const StressResult s = stress(opt);
+  printf("stress    : capacity %zu, chunks 1-%zu, %.1f s\n", RingBuffer(opt.capacity).capacity(), opt.chunk,
+         opt.seconds);
+  printf("            %llu written, %llu read in %llu reads, %llu overrun (%.1f%%), %llu torn\n",
+         static_cast<unsigned long long>(s.written), static_cast<unsigned long long>(s.read),
+         static_cast<unsigned long long>(s.reads), static_cast<unsigned long long>(s.overruns),
+         s.written ? 100.0 * static_cast<double>(s.overruns) / static_cast<double>(s.written) : 0.0,
+         static_cast<unsigned long long>(s.torn));
+
+  bool intact = true;
+  printf("throughput:\n");
+  for (size_t chunk : {64, 320, 960}) {
+    bool ok = false;
+    const double rate = spscThroughput(opt.samples, chunk, &ok);
+    const double ns = sameThreadNsPerSample(opt.samples, chunk);
+    printf("  chunk %4zu  SPSC %8.1f Msamples/s %s  same-thread write+read %5.2f ns/sample\n", chunk, rate / 1e6,
+           ok ? "(intact)" : "(CORRUPT)", ns);
+    intact = intact && ok;
+  }
+
+  const bool pass = s.torn == 0 && s.overruns > 0 && intact;
+  printf("check     : %s\n", pass ? "PASS" : s.overruns == 0 ? "FAIL (consumer never lapped)" : "FAIL");
+  return pass ? 0 : 1;
+}
@@ -0,0 +1,90 @@
+// SilenceGuard Pro — 混淆矩阵编译器 sg_confc (host)
+// conf_matrix.json → conf_matrix.bin (可 mmap 的 CompiledConfMatrix 映像)，并对比两种形式的加载与查询耗时
+//
+// 用法: sg_confc <conf_matrix.json> <conf_matrix.bin> [--bench N]
+//   --bench N   额外计时：JSON 解析 / mmap 加载各 N 次，以及全部 key 的 id 查询 + 变体读取
+
+#include "inference/ConfMatrix.h"
+#include "tools/ReplayAudio.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+using namespace silenceguard;
+
+int64_t nowNs() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+void report(const char* name, std::vector<int64_t> ns) {
+  std::sort(ns.begin(), ns.end());
+  printf("  %-18s p50 %9.1f us  p99 %9.1f us\n", name, percentile(ns, 0.50) / 1e3, percentile(ns, 0.99) / 1e3);
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  if (argc != 3 && !(argc == 5 && std::string(argv[3]) == "--bench")) {
+    fprintf(stderr, "usage: sg_confc <conf_matrix.json> <conf_matrix.bin> [--bench N]\n");
+    return 2;
+  }
+  const char* jsonPath = argv[1];
+  const char* binPath = argv[2];
+  std::ifstream file(jsonPath);
+  std::stringstream buffer;
+  buffer << file.rdbuf();
+  const std::string json = buffer.str();
+  const std::shared_ptr<const CompiledConfMatrix> parsed = CompiledConfMatrix::fromJson(json);
+  if (!parsed) {
+    fprintf(stderr, "sg_confc: cannot parse %s\n", jsonPath);
+    return 1;
+  }
+  if (!parsed->writeFile(binPath)) {
+    fprintf(stderr, "sg_confc: cannot write %s\n", binPath);
+    return 1;
+  }
+  const std::shared_ptr<const CompiledConfMatrix> mapped = CompiledConfMatrix::mapFile(binPath);
+  if (!mapped || mapped->size() != parsed->size() || mapped->variantTotal() != parsed->variantTotal()) {
+    fprintf(stderr, "sg_confc: %s does not map back\n", binPath);
+    return 1;
+  }
+  printf("%s: %d phonemes, %d variants (%zu bytes JSON)\n", binPath, mapped->size(), mapped->variantTotal(),
+         json.size());
+  if (argc != 5) return 0;
+
+  const int iters = std::max(1, static_cast<int>(std::strtol(argv[4], nullptr, 10)));
+  std::vector<int64_t> parseNs, mapNs, lookupNs;
+  for (int i = 0; i < iters; ++i) {
+    int64_t t0 = nowNs();
+    const bool okJson = CompiledConfMatrix::fromJson(json) != nullptr;
+    parseNs.push_back(nowNs() - t0);
+    t0 = nowNs();
+    const bool okMap = CompiledConfMatrix::mapFile(binPath) != nullptr;
+    mapNs.push_back(nowNs() - t0);
+    if (!okJson || !okMap) return 1;
+  }
+  int32_t ids[64];
+  int64_t checksum = 0;
+  for (int i = 0; i < iters; ++i) {
+    const int64_t t0 = nowNs();
+    for (int id = 0; id < mapped->size(); ++id) {
+      const int n = mapped->variants(mapped->idOf(mapped->name(id)), ids, 64);
+      for (int k = 0; k < n; ++k) checksum += ids[k];
+    }
+    lookupNs.push_back(nowNs() - t0);
+  }
+  report("parse JSON", parseNs);
+  report("mmap binary", mapNs);
+  report("lookup all keys", lookupNs);
+  printf("  (checksum %lld)\n", static_cast<long long>(checksum));
+  return 0;
+}
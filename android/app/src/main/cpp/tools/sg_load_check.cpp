@@ -0,0 +1,187 @@
+// SilenceGuard Pro — 模型热加载校验 sg_load_check (host)
+// 先以预跑选项后台加载一个慢模型，在加载线程仍在构建 / 预跑时发起第二次加载请求，
+// 依次覆盖三条入口：loadModel、updateConfig (tflite 选项变化) 与 setWorkerCount (新增推理槽)；
+// 期间另一线程持续送入音频，使推理租约与宽限期交错。第二次请求须在 --max-call-ms 内返回
+// (只登记请求，不等待进行中的加载)；每次调用与其后的 waitForModel 都有看门狗，超时即判为死锁
+// 并以退出码 1 结束 (不再 join 卡住的线程)；全部按时返回且模型可用时退出码为 0
+//
+// 用法: sg_load_check [选项]
+//   --slow PATH       第一次加载的慢模型 (默认 stub-slow200：stub 后端每次推理忙等 200ms)
+//   --model PATH      第二次加载的模型 (默认 stub)
+//   --warmup N        慢模型的预跑次数，决定加载窗口长度 (默认 5)
+//   --workers N       推理槽数 (默认 2；setWorkerCount 一项先缩到 1 再恢复，重新加载仍在加载的槽)
+//   --max-call-ms N   第二次请求的返回时限 (默认 100)
+//   --timeout-ms N    看门狗 (默认 10000)
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <future>
+#include <string>
+#include <thread>
+#include <vector>
+
+extern "C" {
+void* ProtectionEngine_getInstance(void);
+void ProtectionEngine_loadModel(void* engine, const char* path);
+void ProtectionEngine_loadModelWithOptions(void* engine, const char* path, int numThreads,
+                                           int useXnnpack, int warmupRuns);
+void ProtectionEngine_updateConfig(void* engine, const char* json);
+void ProtectionEngine_setAsyncAnalysis(void* engine, int enabled);
+void ProtectionEngine_setWorkerCount(void* engine, int workers);
+int ProtectionEngine_waitForModel(void* engine);
+void ProtectionEngine_pushToBuffer(void* engine, const void* buffer, size_t bytes);
+}
+
+namespace {
+
+constexpr size_t kPeriodFrames = 320;  // 20ms @ 16kHz
+constexpr auto kLoadStartDelay = std::chrono::milliseconds(50);
+
+struct Options {
+  std::string slow = "stub-slow200";
+  std::string model = "stub";
+  int warmup = 5;
+  int workers = 2;
+  int maxCallMs = 100;
+  int timeoutMs = 10000;
+};
+
+void usage() {
+  fprintf(stderr,
+          "usage: sg_load_check [--slow PATH] [--model PATH] [--warmup N] [--workers N] [--max-call-ms N] "
+          "[--timeout-ms N]\n");
+}
+
+bool parseArgs(int argc, char** argv, Options* opt) {
+  for (int i = 1; i < argc; ++i) {
+    std::string a = argv[i];
+    auto next = [&](const char** v) {
+      if (i + 1 >= argc) return false;
+      *v = argv[++i];
+      return true;
+    };
+    const char* v = nullptr;
+    if (a == "--slow" && next(&v)) {
+      opt->slow = v;
+    } else if (a == "--model" && next(&v)) {
+      opt->model = v;
+    } else if (a == "--warmup" && next(&v)) {
+      opt->warmup = std::max(1, static_cast<int>(std::strtol(v, nullptr, 10)));
+    } else if (a == "--workers" && next(&v)) {
+      opt->workers = std::max(1, static_cast<int>(std::strtol(v, nullptr, 10)));
+    } else if (a == "--max-call-ms" && next(&v)) {
+      opt->maxCallMs = std::max(1, static_cast<int>(std::strtol(v, nullptr, 10)));
+    } else if (a == "--timeout-ms" && next(&v)) {
+      opt->timeoutMs = std::max(1, static_cast<int>(std::strtol(v, nullptr, 10)));
+    } else {
+      return false;
+    }
+  }
+  return true;
+}
+
+// 在独立线程执行 fn；超时视为死锁，直接结束进程 (卡住的线程无法 join)
+template <typename Fn>
+double runWithin(const char* what, int timeoutMs, Fn fn) {
+  const auto t0 = std::chrono::steady_clock::now();
+  std::packaged_task<void()> task(fn);
+  std::future<void> done = task.get_future();
+  std::thread worker(std::move(task));
+  if (done.wait_for(std::chrono::milliseconds(timeoutMs)) != std::future_status::ready) {
+    fprintf(stderr, "FAIL: %s did not return within %d ms (deadlock)\n", what, timeoutMs);
+    fflush(stderr);
+    std::_Exit(1);
+  }
+  worker.join();
+  return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+}
+
+// 持续送入合成音频 (同步分析)：推理在送入线程上持有租约，与加载线程的发布交错
+class Feeder {
+ public:
+  explicit Feeder(void* engine) : engine_(engine), thread_([this] { run(); }) {}
+  ~Feeder() {
+    stop_.store(true, std::memory_order_relaxed);
+    thread_.join();
+  }
+
+ private:
+  void run() {
+    std::vector<int16_t> buf(kPeriodFrames);
+    uint32_t seed = 12345;
+    while (!stop_.load(std::memory_order_relaxed)) {
+      for (int16_t& s : buf) {
+        seed = seed * 1664525u + 1013904223u;
+        s = static_cast<int16_t>(static_cast<int32_t>(seed >> 16) - 32768) / 8;
+      }
+      ProtectionEngine_pushToBuffer(engine_, buf.data(), buf.size() * sizeof(int16_t));
+      std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+  }
+
+  void* engine_;
+  std::atomic<bool> stop_{false};
+  std::thread thread_;
+};
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  Options opt;
+  if (!parseArgs(argc, argv, &opt)) {
+    usage();
+    return 2;
+  }
+
+  void* engine = ProtectionEngine_getInstance();
+  ProtectionEngine_setAsyncAnalysis(engine, 0);
+  ProtectionEngine_setWorkerCount(engine, opt.workers);
+  ProtectionEngine_updateConfig(engine, "{\"governor\":false}");
+  ProtectionEngine_loadModel(engine, opt.model.c_str());
+  if (!ProtectionEngine_waitForModel(engine)) {
+    fprintf(stderr, "sg_load_check: model %s failed to load\n", opt.model.c_str());
+    return 1;
+  }
+
+  struct Case {
+    const char* name;
+    std::string config;  // 非空时以 updateConfig 发起第二次加载
+    bool regrow;         // 以 setWorkerCount 缩减再恢复推理槽发起
+  };
+  const Case cases[] = {
+      {"loadModel", "", false},
+      {"updateConfig", "{\"governor\":false,\"tflite_threads\":2}", false},
+      {"setWorkerCount", "", true},
+  };
+
+  Feeder feeder(engine);
+  bool ok = true;
+  for (const Case& c : cases) {
+    // 第一次加载：慢模型 + 预跑，加载线程在预跑期间回调前一直占用
+    ProtectionEngine_loadModelWithOptions(engine, opt.slow.c_str(), 1, 1, opt.warmup);
+    std::this_thread::sleep_for(kLoadStartDelay);
+    const double callMs = runWithin(c.name, opt.timeoutMs, [&] {
+      if (c.regrow) {
+        ProtectionEngine_setWorkerCount(engine, 1);
+        ProtectionEngine_setWorkerCount(engine, std::max(2, opt.workers));
+      } else if (!c.config.empty()) {
+        ProtectionEngine_updateConfig(engine, c.config.c_str());
+      } else {
+        ProtectionEngine_loadModel(engine, opt.model.c_str());
+      }
+    });
+    int loaded = 0;
+    const double waitMs = runWithin("waitForModel", opt.timeoutMs,
+                                    [&] { loaded = ProtectionEngine_waitForModel(engine); });
+    const bool prompt = callMs <= opt.maxCallMs;
+    printf("%-15s second request %7.1f ms%s, settled after %7.1f ms, model %s\n", c.name, callMs,
+           prompt ? "" : " (BLOCKED)", waitMs, loaded ? "ready" : "MISSING");
+    ok = ok && loaded && prompt;
+  }
+  printf("%s\n", ok ? "PASS" : "FAIL");
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,342 @@
+// SilenceGuard Pro — 离线回放工具 sg_replay (host)
+// 把 WAV / 裸 PCM 按 HAL 周期逐块送入 silenceguard_in_read_proxy，走完整 native 链路
+// (core → feature_extraction → inference → injector)，报告拦截时间线、实时率 (RTF)
+// 与逐次调用延迟分位数；无需手机与直播流
+//
+// 用法: sg_replay [选项] <input.wav | input.pcm>
+//   --period N      HAL 周期帧数 (默认 320 = 20ms @ 16kHz)
+//   --model PATH    模型路径 (tflite 后端必填；stub 后端忽略)
+//   --config JSON   UPDATE_CONFIG 负载；以 @ 开头则从文件读取
+//   --conf PATH     conf_matrix.json (关键词图的混淆变体；默认取模型同目录)
+//   --async         使用异步分析线程 (默认同步：结果可逐位复现)
+//   --pace X        回放速度为实时的 X 倍；0 = 尽可能快 (默认 0)
+//   --rate HZ       裸 PCM 的采样率 (默认 16000)
+//   --repeat N      输入循环 N 次 (拉长测量)
+//   --out PATH      写出处理后的 16-bit mono WAV
+//   --threads N     TFLite 线程数 (默认 TFLite 自定)
+//   --xnnpack 0|1   XNNPACK delegate (默认 1)
+//   --warmup N      加载时预跑次数 (默认 0)
+
+#include "core/EngineStats.h"
+#include "tools/ReplayAudio.h"
+#include <sys/types.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include <vector>
+
+extern "C" {
+void* ProtectionEngine_getInstance(void);
+void ProtectionEngine_loadModelWithOptions(void* engine, const char* path, int numThreads, int useXnnpack,
+                                           int warmupRuns);
+void ProtectionEngine_updateConfig(void* engine, const char* json);
+void ProtectionEngine_setAsyncAnalysis(void* engine, int enabled);
+void ProtectionEngine_getAnalysisCounters(void* engine, uint64_t* enqueued, uint64_t* dropped, uint64_t* late);
+void ProtectionEngine_getSchedulerCounters(void* engine, uint64_t* windows, uint64_t* skipped);
+void ProtectionEngine_getInterceptCounters(void* engine, uint64_t* decisions, uint64_t* lastPosition);
+int ProtectionEngine_getStats(void* engine, SgEngineStats* out);
+int ProtectionEngine_waitForModel(void* engine);
+int ConfMatrix_load(const char* path);
+ssize_t silenceguard_in_read_proxy(void* engine, void* buffer, size_t bytes);
+}
+
+namespace {
+
+using silenceguard::ReplayAudio;
+using silenceguard::percentile;
+using silenceguard::readFile;
+using silenceguard::writeWav;
+
+// Engine 的分析链路固定 16kHz mono
+constexpr int kEngineSampleRate = 16000;
+// 与 Engine 中单次决策的掩蔽时长一致 (200ms)，用于合并时间线
+constexpr uint64_t kMaskFrames = 3200;
+
+struct Options {
+  std::string input;
+  std::string model;
+  std::string config;
+  std::string conf;
+  std::string out;
+  size_t period = 320;
+  int rawRate = kEngineSampleRate;
+  int repeat = 1;
+  int threads = -1;
+  int xnnpack = 1;
+  int warmup = 0;
+  double pace = 0.0;
+  bool async = false;
+};
+
+void usage() {
+  fprintf(stderr,
+          "usage: sg_replay [--period N] [--model PATH] [--config JSON|@file] [--conf PATH] [--async]\n"
+          "                 [--pace X] [--rate HZ] [--repeat N] [--out PATH]\n"
+          "                 [--threads N] [--xnnpack 0|1] [--warmup N] <input.wav|input.pcm>\n");
+}
+
+bool parseArgs(int argc, char** argv, Options* opt) {
+  for (int i = 1; i < argc; ++i) {
+    std::string a = argv[i];
+    auto next = [&](const char** v) {
+      if (i + 1 >= argc) return false;
+      *v = argv[++i];
+      return true;
+    };
+    const char* v = nullptr;
+    if (a == "--async") {
+      opt->async = true;
+    } else if (a == "--period" && next(&v)) {
+      opt->period = static_cast<size_t>(std::max(1L, std::strtol(v, nullptr, 10)));
+    } else if (a == "--model" && next(&v)) {
+      opt->model = v;
+    } else if (a == "--config" && next(&v)) {
+      opt->config = v;
+    } else if (a == "--conf" && next(&v)) {
+      opt->conf = v;
+    } else if (a == "--pace" && next(&v)) {
+      opt->pace = std::max(0.0, std::strtod(v, nullptr));
+    } else if (a == "--rate" && next(&v)) {
+      opt->rawRate = static_cast<int>(std::strtol(v, nullptr, 10));
+    } else if (a == "--repeat" && next(&v)) {
+      opt->repeat = std::max(1, static_cast<int>(std::strtol(v, nullptr, 10)));
+    } else if (a == "--threads" && next(&v)) {
+      opt->threads = static_cast<int>(std::strtol(v, nullptr, 10));
+    } else if (a == "--xnnpack" && next(&v)) {
+      opt->xnnpack = std::strtol(v, nullptr, 10) != 0 ? 1 : 0;
+    } else if (a == "--warmup" && next(&v)) {
+      opt->warmup = std::max(0, static_cast<int>(std::strtol(v, nullptr, 10)));
+    } else if (a == "--out" && next(&v)) {
+      opt->out = v;
+    } else if (!a.empty() && a[0] != '-' && opt->input.empty()) {
+      opt->input = a;
+    } else {
+      return false;
+    }
+  }
+  return !opt->input.empty();
+}
+
+double seconds(uint64_t frames) { return static_cast<double>(frames) / kEngineSampleRate; }
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  Options opt;
+  if (!parseArgs(argc, argv, &opt)) {
+    usage();
+    return 2;
+  }
+
+  ReplayAudio audio;
+  if (!silenceguard::loadReplayAudio(opt.input, opt.rawRate, &audio) || audio.pcm.empty()) {
+    fprintf(stderr, "sg_replay: no audio in %s\n", opt.input.c_str());
+    return 1;
+  }
+  if (audio.sampleRate != kEngineSampleRate) {
+    fprintf(stderr, "sg_replay: warning: input is %d Hz, analysis path assumes %d Hz\n",
+            audio.sampleRate, kEngineSampleRate);
+  }
+
+#if defined(SG_INFERENCE_STUB)
+  const char* backend = "stub";
+#else
+  const char* backend = "tflite";
+  if (opt.model.empty()) {
+    fprintf(stderr, "sg_replay: --model is required with the tflite backend\n");
+    return 2;
+  }
+#endif
+
+  void* engine = ProtectionEngine_getInstance();
+  ProtectionEngine_setAsyncAnalysis(engine, opt.async ? 1 : 0);
+  ProtectionEngine_loadModelWithOptions(engine, opt.model.empty() ? "stub" : opt.model.c_str(), opt.threads,
+                                        opt.xnnpack, opt.warmup);
+  if (!opt.conf.empty() && !ConfMatrix_load(opt.conf.c_str())) {
+    fprintf(stderr, "sg_replay: cannot load confusion matrix %s\n", opt.conf.c_str());
+    return 1;
+  }
+  if (!opt.config.empty()) {
+    std::string json = opt.config;
+    if (json[0] == '@') {
+      std::vector<char> bytes;
+      if (!readFile(json.substr(1), &bytes)) {
+        fprintf(stderr, "sg_replay: cannot read config %s\n", json.c_str() + 1);
+        return 1;
+      }
+      json.assign(bytes.begin(), bytes.end());
+    }
+    ProtectionEngine_updateConfig(engine, json.c_str());
+  }
+  // 模型在后台加载 (配置变化也会触发重载)，回放前等待就绪
+  if (!ProtectionEngine_waitForModel(engine)) {
+    fprintf(stderr, "sg_replay: model failed to load\n");
+    return 1;
+  }
+
+  const size_t total = audio.pcm.size() * static_cast<size_t>(opt.repeat);
+  std::vector<int16_t> output;
+  if (!opt.out.empty()) output.reserve(total);
+  std::vector<int16_t> period(opt.period);
+  std::vector<int64_t> latencyNs;
+  latencyNs.reserve(total / opt.period + 1);
+
+  // 时间线：每次调用后读取决策计数；同步模式下逐次精确，异步模式下按轮询合并
+  struct Event { uint64_t position; uint64_t count; };
+  std::vector<Event> events;
+  uint64_t seenDecisions = 0;
+
+  using Clock = std::chrono::steady_clock;
+  const Clock::time_point start = Clock::now();
+  uint64_t fed = 0;
+  while (fed < total) {
+    const size_t n = std::min<size_t>(opt.period, total - fed);
+    for (size_t i = 0; i < n; ++i) period[i] = audio.pcm[(fed + i) % audio.pcm.size()];
+
+    if (opt.pace > 0.0) {
+      std::this_thread::sleep_until(start + std::chrono::duration_cast<Clock::duration>(
+          std::chrono::duration<double>(seconds(fed) / opt.pace)));
+    }
+
+    const Clock::time_point t0 = Clock::now();
+    silenceguard_in_read_proxy(engine, period.data(), n * sizeof(int16_t));
+    latencyNs.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - t0).count());
+
+    fed += n;
+    if (!opt.out.empty()) output.insert(output.end(), period.begin(), period.begin() + n);
+
+    uint64_t decisions = 0, lastPos = 0;
+    ProtectionEngine_getInterceptCounters(engine, &decisions, &lastPos);
+    if (decisions != seenDecisions) {
+      events.push_back({lastPos, decisions - seenDecisions});
+      seenDecisions = decisions;
+    }
+  }
+  const double wall = std::chrono::duration<double>(Clock::now() - start).count();
+
+  // 异步模式：关闭分析线程前会排空队列，剩余决策计入时间线
+  if (opt.async) {
+    ProtectionEngine_setAsyncAnalysis(engine, 0);
+    uint64_t decisions = 0, lastPos = 0;
+    ProtectionEngine_getInterceptCounters(engine, &decisions, &lastPos);
+    if (decisions != seenDecisions) events.push_back({lastPos, decisions - seenDecisions});
+  }
+
+  printf("input     : %s (%d Hz, %.2f s x %d)\n", opt.input.c_str(), audio.sampleRate,
+         seconds(audio.pcm.size()), opt.repeat);
+  printf("backend   : %s, %s analysis, period %zu frames (%.1f ms)\n", backend,
+         opt.async ? "async" : "sync", opt.period, 1000.0 * seconds(opt.period));
+
+  printf("\nintercept timeline (window end, merged by %.0f ms mask):\n", 1000.0 * seconds(kMaskFrames));
+  uint64_t segStart = 0, segEnd = 0, segDecisions = 0, segments = 0;
+  auto flush = [&] {
+    if (segDecisions == 0) return;
+    printf("  %9.3f s - %9.3f s  (%llu decisions)\n", seconds(segStart), seconds(segEnd),
+           static_cast<unsigned long long>(segDecisions));
+    ++segments;
+  };
+  for (const Event& e : events) {
+    if (segDecisions > 0 && e.position <= segEnd) {
+      segEnd = std::max(segEnd, e.position + kMaskFrames);
+      segDecisions += e.count;
+      continue;
+    }
+    flush();
+    segStart = e.position;
+    segEnd = e.position + kMaskFrames;
+    segDecisions = e.count;
+  }
+  flush();
+  if (segments == 0) printf("  (none)\n");
+
+  const double audioSec = seconds(total);
+  printf("\nrealtime  : %.3f s audio in %.3f s wall, RTF %.4f (%.1fx realtime)\n", audioSec, wall,
+         wall / audioSec, wall > 0.0 ? audioSec / wall : 0.0);
+
+  std::sort(latencyNs.begin(), latencyNs.end());
+  printf("latency   : %zu calls, p50 %.1f us, p90 %.1f us, p99 %.1f us, p99.9 %.1f us, max %.1f us\n",
+         latencyNs.size(), percentile(latencyNs, 0.50) / 1e3, percentile(latencyNs, 0.90) / 1e3,
+         percentile(latencyNs, 0.99) / 1e3, percentile(latencyNs, 0.999) / 1e3,
+         static_cast<double>(latencyNs.back()) / 1e3);
+
+  uint64_t enqueued = 0, dropped = 0, late = 0, windows = 0, skipped = 0;
+  ProtectionEngine_getAnalysisCounters(engine, &enqueued, &dropped, &late);
+  ProtectionEngine_getSchedulerCounters(engine, &windows, &skipped);
+  printf("analysis  : %llu windows (%llu skipped), queue %llu enqueued / %llu dropped / %llu late\n",
+         static_cast<unsigned long long>(windows), static_cast<unsigned long long>(skipped),
+         static_cast<unsigned long long>(enqueued), static_cast<unsigned long long>(dropped),
+         static_cast<unsigned long long>(late));
+
+  SgEngineStats stats;
+  if (ProtectionEngine_getStats(engine, &stats)) {
+    static const char* const kStageNames[SG_STAGE_COUNT] = {
+        "push", "queue_wait", "lock_wait", "mel", "inference", "decision", "lookahead"};
+    printf("\nstage          count      p50 us    p90 us    p99 us    max us   mean us\n");
+    for (int i = 0; i < SG_STAGE_COUNT; ++i) {
+      const SgStageStats& st = stats.stages[i];
+      if (st.count == 0) continue;
+      printf("  %-10s %9llu %9.1f %9.1f %9.1f %9.1f %9.1f\n", kStageNames[i],
+             static_cast<unsigned long long>(st.count), st.p50_ns / 1e3, st.p90_ns / 1e3, st.p99_ns / 1e3,
+             st.max_ns / 1e3, static_cast<double>(st.sum_ns) / static_cast<double>(st.count) / 1e3);
+    }
+    printf("  model load %u us, warmup %u us, first inference %u us, threads %d, xnnpack %s\n",
+           static_cast<unsigned>(stats.model_load_us), static_cast<unsigned>(stats.model_warmup_us),
+           static_cast<unsigned>(stats.model_first_inference_us), static_cast<int>(stats.model_threads),
+           stats.model_xnnpack ? "on" : "off");
+    static const char* const kTypeNames[] = {"float32", "int8", "uint8"};
+    printf("  model tensors %s -> %s", kTypeNames[stats.model_input_type % 3],
+           kTypeNames[stats.model_output_type % 3]);
+    if (stats.model_chunk_frames > 0) {
+      printf(", streaming %d frames/chunk, %d state tensors, %llu chunks, %llu state resets",
+             static_cast<int>(stats.model_chunk_frames), static_cast<int>(stats.model_state_tensors),
+             static_cast<unsigned long long>(stats.stream_chunks),
+             static_cast<unsigned long long>(stats.stream_resets));
+    }
+    printf("\n");
+    if (stats.kws_keywords > 0) {
+      printf("  kws %u keywords, %u graph nodes, %llu frames, peak %u tokens, %llu hits",
+             static_cast<unsigned>(stats.kws_keywords), static_cast<unsigned>(stats.kws_graph_nodes),
+             static_cast<unsigned long long>(stats.kws_frames), static_cast<unsigned>(stats.kws_peak_tokens),
+             static_cast<unsigned long long>(stats.kws_hits));
+      if (stats.kws_hits > 0) {
+        printf(" (last: keyword %d, score %.3f, %.3f s - %.3f s)", static_cast<int>(stats.kws_last_keyword),
+               static_cast<double>(stats.kws_last_score), seconds(stats.kws_last_start),
+               seconds(stats.kws_last_end));
+      }
+      printf("\n");
+    }
+    printf("  intercepts %llu (masks %llu, immediate %llu, late masks %llu, dropped masks %llu), "
+           "inference failures %llu\n",
+           static_cast<unsigned long long>(stats.intercept_decisions),
+           static_cast<unsigned long long>(stats.masks_scheduled),
+           static_cast<unsigned long long>(stats.immediate_intercepts),
+           static_cast<unsigned long long>(stats.late_masks),
+           static_cast<unsigned long long>(stats.dropped_masks),
+           static_cast<unsigned long long>(stats.inference_failures));
+    if (stats.vad_hops > 0) {
+      printf("  vad skipped %.1f%% of samples (Mel / inference not run), %.1f%% speech hops, %llu openings\n",
+             100.0 * static_cast<double>(stats.vad_skipped_samples) / static_cast<double>(stats.vad_samples),
+             100.0 * static_cast<double>(stats.vad_speech_hops) / static_cast<double>(stats.vad_hops),
+             static_cast<unsigned long long>(stats.vad_openings));
+    }
+    if (stats.gov_levels > 1) {
+      printf("  governor level %u/%u (stride %d ms, threads %d%s), last rtf %.3f, lag %u ms, "
+             "%llu transitions, %llu overloads\n",
+             static_cast<unsigned>(stats.gov_level), static_cast<unsigned>(stats.gov_levels),
+             static_cast<int>(stats.gov_stride_ms), static_cast<int>(stats.gov_threads),
+             stats.gov_fallback ? ", fallback model" : "", static_cast<double>(stats.gov_rtf),
+             static_cast<unsigned>(stats.gov_lag_ms), static_cast<unsigned long long>(stats.gov_transitions),
+             static_cast<unsigned long long>(stats.gov_overloads));
+    }
+  }
+
+  if (!opt.out.empty() && !writeWav(opt.out, output, audio.sampleRate)) {
+    fprintf(stderr, "sg_replay: cannot write %s\n", opt.out.c_str());
+    return 1;
+  }
+  return 0;
+}
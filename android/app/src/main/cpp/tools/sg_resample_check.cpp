@@ -0,0 +1,373 @@
+// SilenceGuard Pro — 采集前端校验 sg_resample_check (host)
+// 1. 多相重采样器 48k / 44.1k → 16k：频率响应 (通带 1k / 4k / 6.5k 偏差 ≤ 0.1 dB，阻带 9k / 12k / 20k ≤ -70 dB)、
+//    相对理想带限重采样的最大误差，以及吞吐 (ns / 输入帧与实时倍数)
+// 2. 端到端：16k 回放音频先用同一重采样器升到原生格式 (48k 立体声 int16、44.1k 立体声 float32)，
+//    与 16k mono 基准会话各自同步走完整 native 链路 (会话 in_read 代理)：拦截决策数与关键词命中须与基准一致，
+//    原生 buffer 上被改写 (掩蔽 / 哔声) 的 10ms 帧折算回 16k 时间轴后须与基准重合 (IoU ≥ 0.9)
+// 全部通过时退出码为 0；不给输入时只做第 1 部分
+//
+// 用法: sg_resample_check [选项] [input.wav | input.pcm]
+//   --model PATH    模型路径 (stub 后端：含 phoneme 时输出音素后验)
+//   --config JSON   UPDATE_CONFIG 负载；以 @ 开头则从文件读取 (算力调节器固定关闭)
+//   --conf PATH     conf_matrix.json / conf_matrix.bin
+//   --period-ms N   HAL 周期 (默认 20ms，各格式按自己的采样率折算帧数)
+//   --rate HZ       裸 PCM 的采样率 (默认 16000)
+
+#include "core/EngineStats.h"
+#include "feature_extraction/PolyphaseResampler.h"
+#include "tools/ReplayAudio.h"
+#include <sys/types.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+extern "C" {
+void* ProtectionEngine_getInstance(void);
+void ProtectionEngine_loadModel(void* engine, const char* path);
+void ProtectionEngine_updateConfig(void* engine, const char* json);
+void ProtectionEngine_setAsyncAnalysis(void* engine, int enabled);
+int ProtectionEngine_waitForModel(void* engine);
+void* ProtectionEngine_openSessionWithFormat(void* engine, int sampleRate, int channels, int format);
+void ProtectionEngine_closeSession(void* engine, void* session);
+int ProtectionEngine_getSessionStats(void* engine, void* session, SgEngineStats* out);
+int ConfMatrix_load(const char* path);
+ssize_t silenceguard_session_read_proxy(void* session, void* buffer, size_t bytes);
+}
+
+namespace {
+
+using silenceguard::PolyphaseResampler;
+using silenceguard::ReplayAudio;
+
+constexpr int kEngineSampleRate = 16000;
+constexpr int kFormatInt16 = 0;
+constexpr int kFormatFloat32 = 1;
+constexpr size_t kFrameSamples = 160;       // 掩蔽比较的帧长 (10ms @ 16kHz)
+constexpr float kModifiedThreshold = 64.0f;  // 与延迟后的输入相差超过此值 (int16 刻度) 记为被改写
+constexpr double kPi = 3.14159265358979323846;
+
+struct Options {
+  std::string input;
+  std::string model = "stub";
+  std::string config = "{}";
+  std::string conf;
+  int periodMs = 20;
+  int rawRate = kEngineSampleRate;
+};
+
+void usage() {
+  fprintf(stderr,
+          "usage: sg_resample_check [--model PATH] [--config JSON|@file] [--conf PATH] [--period-ms N]\n"
+          "                         [--rate HZ] [input.wav|input.pcm]\n");
+}
+
+bool parseArgs(int argc, char** argv, Options* opt) {
+  for (int i = 1; i < argc; ++i) {
+    std::string a = argv[i];
+    auto next = [&](const char** v) {
+      if (i + 1 >= argc) return false;
+      *v = argv[++i];
+      return true;
+    };
+    const char* v = nullptr;
+    if (a == "--model" && next(&v)) {
+      opt->model = v;
+    } else if (a == "--config" && next(&v)) {
+      opt->config = v;
+    } else if (a == "--conf" && next(&v)) {
+      opt->conf = v;
+    } else if (a == "--period-ms" && next(&v)) {
+      opt->periodMs = std::max(1, static_cast<int>(std::strtol(v, nullptr, 10)));
+    } else if (a == "--rate" && next(&v)) {
+      opt->rawRate = static_cast<int>(std::strtol(v, nullptr, 10));
+    } else if (!a.empty() && a[0] != '-' && opt->input.empty()) {
+      opt->input = a;
+    } else {
+      return false;
+    }
+  }
+  return true;
+}
+
+// 在配置对象末尾追加 "governor":false：比较的是前端，不让工作点随负载变化
+bool withoutGovernor(const std::string& config, std::string* out) {
+  const size_t close = config.find_last_of('}');
+  if (close == std::string::npos) return false;
+  const size_t open = config.find('{');
+  const bool empty = config.find_first_not_of(" \t\r\n", open + 1) == close;
+  *out = config.substr(0, close) + (empty ? "" : ",") + "\"governor\":false}";
+  return true;
+}
+
+// 按 HAL 周期大小分块送入 (流式状态跨块保存)
+size_t resample(PolyphaseResampler& r, const std::vector<float>& in, size_t period, std::vector<float>* out) {
+  out->assign(r.maxOutput(in.size()) + in.size() / period + 1, 0.0f);
+  size_t produced = 0;
+  for (size_t pos = 0; pos < in.size(); pos += period) {
+    produced += r.process(in.data() + pos, std::min(period, in.size() - pos), out->data() + produced);
+  }
+  out->resize(produced);
+  return produced;
+}
+
+std::vector<float> tone(double freq, int rate, size_t frames, double amplitude) {
+  std::vector<float> x(frames);
+  for (size_t i = 0; i < frames; ++i) x[i] = static_cast<float>(amplitude * std::sin(2.0 * kPi * freq * i / rate));
+  return x;
+}
+
+// 输出后半段 (越过滤波器暖机) 的增益 (dB)
+double gainDb(const std::vector<float>& y, double amplitude) {
+  double power = 0.0;
+  const size_t from = y.size() / 2;
+  for (size_t i = from; i < y.size(); ++i) power += static_cast<double>(y[i]) * y[i];
+  power /= static_cast<double>(y.size() - from);
+  return 10.0 * std::log10(std::max(1e-30, power / (0.5 * amplitude * amplitude)));
+}
+
+// 第 1 部分：一个输入采样率 → 16k
+bool checkResampler(int rate) {
+  PolyphaseResampler r(rate, kEngineSampleRate);
+  if (!r.valid()) {
+    printf("%6d Hz : unsupported\n", rate);
+    return false;
+  }
+  const size_t period = static_cast<size_t>(rate) / 50;
+  bool ok = true;
+  std::vector<float> y;
+  printf("%6d Hz : %d taps, group delay %.1f input frames (%.2f ms)\n", rate, r.taps(), r.delay(),
+         r.delay() * 1000.0 / rate);
+
+  // 频率响应
+  const double passband[] = {1000.0, 4000.0, 6500.0};
+  const double stopband[] = {9000.0, 12000.0, 20000.0};
+  std::string line;
+  char buf[64];
+  for (double f : passband) {
+    r.reset();
+    resample(r, tone(f, rate, static_cast<size_t>(rate), 0.5), period, &y);
+    const double g = gainDb(y, 0.5);
+    ok = ok && std::fabs(g) <= 0.1;
+    snprintf(buf, sizeof(buf), "  %.1fk %+.3f dB", f / 1000.0, g);
+    line += buf;
+  }
+  printf("  passband :%s\n", line.c_str());
+  line.clear();
+  for (double f : stopband) {
+    if (f >= rate / 2.0) continue;
+    r.reset();
+    resample(r, tone(f, rate, static_cast<size_t>(rate), 0.5), period, &y);
+    const double g = gainDb(y, 0.5);
+    ok = ok && g <= -70.0;
+    snprintf(buf, sizeof(buf), "  %.1fk %.1f dB", f / 1000.0, g);
+    line += buf;
+  }
+  printf("  stopband :%s\n", line.c_str());
+
+  // 与理想带限重采样比较：通带三音叠加，输出 k 对应输入时刻 k·rate/16000 - delay
+  const size_t frames = static_cast<size_t>(rate);
+  std::vector<float> x(frames, 0.0f);
+  for (double f : passband) {
+    const std::vector<float> t = tone(f, rate, frames, 0.3);
+    for (size_t i = 0; i < frames; ++i) x[i] += t[i];
+  }
+  r.reset();
+  resample(r, x, period, &y);
+  double maxErr = 0.0;
+  for (size_t k = static_cast<size_t>(r.taps()); k < y.size(); ++k) {
+    const double t = static_cast<double>(k) * rate / kEngineSampleRate - r.delay();
+    double ideal = 0.0;
+    for (double f : passband) ideal += 0.3 * std::sin(2.0 * kPi * f * t / rate);
+    maxErr = std::max(maxErr, std::fabs(y[k] - ideal));
+  }
+  const double errDb = 20.0 * std::log10(std::max(1e-12, maxErr));
+  ok = ok && errDb <= -60.0;
+  printf("  accuracy : max error vs ideal %.1f dBFS\n", errDb);
+
+  // 吞吐：10s 噪声，取 3 次中最快
+  std::vector<float> noise(static_cast<size_t>(rate) * 10);
+  uint32_t seed = 1;
+  for (float& v : noise) {
+    seed = seed * 1664525u + 1013904223u;
+    v = static_cast<float>(static_cast<int32_t>(seed) >> 8) / 8388608.0f * 0.5f;
+  }
+  double best = 1e30;
+  for (int rep = 0; rep < 3; ++rep) {
+    r.reset();
+    const auto t0 = std::chrono::steady_clock::now();
+    resample(r, noise, period, &y);
+    best = std::min(best, std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - t0).count());
+  }
+  const double nsPerFrame = best / static_cast<double>(noise.size());
+  printf("  speed    : %.2f ns / input frame, %.0fx real time\n", nsPerFrame, 1e9 / (nsPerFrame * rate));
+  printf("  result   : %s\n", ok ? "ok" : "FAIL");
+  return ok;
+}
+
+struct Format {
+  int rate;
+  int channels;
+  int format;
+};
+
+struct StreamResult {
+  SgEngineStats stats;
+  std::vector<bool> modified;  // 16k 时间轴上每 10ms 帧是否被改写
+};
+
+int16_t toInt16(float v) { return static_cast<int16_t>(std::lrint(std::max(-1.0f, std::min(1.0f, v)) * 32767.0f)); }
+
+// 第 2 部分：一路会话按原生格式逐周期送入，输出与延迟后的输入比较得到被改写的帧
+// contentShift 为原生内容相对 16k 原始音频的延迟 (16k 样本，即升采样的群延迟)
+bool runStream(void* engine, const Format& fmt, const std::vector<float>& mono, double contentShift, int periodMs,
+               int lookaheadMs, size_t totalFrames16k, StreamResult* out) {
+  void* session = ProtectionEngine_openSessionWithFormat(engine, fmt.rate, fmt.channels, fmt.format);
+  if (!session) return false;
+  const size_t ch = static_cast<size_t>(fmt.channels);
+  const size_t period = static_cast<size_t>(fmt.rate) * periodMs / 1000;
+  const size_t delay = static_cast<size_t>(fmt.rate) * lookaheadMs / 1000;
+  const size_t frames = mono.size();
+  std::vector<int16_t> pcm16(period * ch);
+  std::vector<float> pcmF(period * ch);
+  out->modified.assign(totalFrames16k / kFrameSamples + 1, false);
+
+  for (size_t fed = 0; fed < frames; fed += period) {
+    const size_t n = std::min(period, frames - fed);
+    // 各声道写入同一信号，只比较第 0 声道
+    for (size_t i = 0; i < n; ++i) {
+      for (size_t c = 0; c < ch; ++c) {
+        if (fmt.format == kFormatFloat32) {
+          pcmF[i * ch + c] = mono[fed + i];
+        } else {
+          pcm16[i * ch + c] = toInt16(mono[fed + i]);
+        }
+      }
+    }
+    void* buf = fmt.format == kFormatFloat32 ? static_cast<void*>(pcmF.data()) : static_cast<void*>(pcm16.data());
+    const size_t bytes = n * ch * (fmt.format == kFormatFloat32 ? sizeof(float) : sizeof(int16_t));
+    silenceguard_session_read_proxy(session, buf, bytes);
+
+    for (size_t i = 0; i < n; ++i) {
+      const size_t at = fed + i;
+      const float got = fmt.format == kFormatFloat32 ? pcmF[i * ch] * 32767.0f : static_cast<float>(pcm16[i * ch]);
+      const float want = at >= delay ? static_cast<float>(toInt16(mono[at - delay])) : 0.0f;
+      if (std::fabs(got - want) <= kModifiedThreshold || at < delay) continue;
+      const double t = static_cast<double>(at - delay) * kEngineSampleRate / fmt.rate - contentShift;
+      if (t < 0.0) continue;
+      const size_t frame = static_cast<size_t>(t) / kFrameSamples;
+      if (frame < out->modified.size()) out->modified[frame] = true;
+    }
+  }
+  ProtectionEngine_getSessionStats(engine, session, &out->stats);
+  ProtectionEngine_closeSession(engine, session);
+  return true;
+}
+
+// 从配置中读出 lookahead_ms (仅用于比较时对齐延迟)：未给出时为 0
+int lookaheadOf(const std::string& config) {
+  const size_t key = config.find("\"lookahead_ms\"");
+  if (key == std::string::npos) return 0;
+  const size_t colon = config.find(':', key);
+  return colon == std::string::npos ? 0 : std::max(0, std::min(300, std::atoi(config.c_str() + colon + 1)));
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  Options opt;
+  if (!parseArgs(argc, argv, &opt)) {
+    usage();
+    return 2;
+  }
+
+  bool ok = true;
+  for (int rate : {48000, 44100}) ok = checkResampler(rate) && ok;
+  if (opt.input.empty()) return ok ? 0 : 1;
+
+  ReplayAudio audio;
+  if (!silenceguard::loadReplayAudio(opt.input, opt.rawRate, &audio) || audio.pcm.empty()) {
+    fprintf(stderr, "sg_resample_check: no audio in %s\n", opt.input.c_str());
+    return 1;
+  }
+  if (audio.sampleRate != kEngineSampleRate) {
+    fprintf(stderr, "sg_resample_check: input must be 16000 Hz (got %d)\n", audio.sampleRate);
+    return 1;
+  }
+  if (opt.config[0] == '@') {
+    std::vector<char> bytes;
+    if (!silenceguard::readFile(opt.config.substr(1), &bytes)) {
+      fprintf(stderr, "sg_resample_check: cannot read config %s\n", opt.config.c_str() + 1);
+      return 1;
+    }
+    opt.config.assign(bytes.begin(), bytes.end());
+  }
+  std::string config;
+  if (!withoutGovernor(opt.config, &config)) {
+    fprintf(stderr, "sg_resample_check: --config must be a JSON object\n");
+    return 2;
+  }
+  const int lookaheadMs = lookaheadOf(config);
+
+  void* engine = ProtectionEngine_getInstance();
+  ProtectionEngine_setAsyncAnalysis(engine, 0);
+  ProtectionEngine_updateConfig(engine, config.c_str());
+  ProtectionEngine_loadModel(engine, opt.model.c_str());
+  if (!opt.conf.empty() && !ConfMatrix_load(opt.conf.c_str())) {
+    fprintf(stderr, "sg_resample_check: cannot load confusion matrix %s\n", opt.conf.c_str());
+    return 1;
+  }
+  if (!ProtectionEngine_waitForModel(engine)) {
+    fprintf(stderr, "sg_resample_check: model failed to load\n");
+    return 1;
+  }
+
+  std::vector<float> mono(audio.pcm.size());
+  for (size_t i = 0; i < mono.size(); ++i) mono[i] = static_cast<float>(audio.pcm[i]) / 32767.0f;
+  const size_t total = mono.size();
+  printf("input     : %s (%.2f s), period %d ms, lookahead %d ms\n", opt.input.c_str(),
+         static_cast<double>(total) / kEngineSampleRate, opt.periodMs, lookaheadMs);
+
+  StreamResult ref;
+  if (!runStream(engine, {kEngineSampleRate, 1, kFormatInt16}, mono, 0.0, opt.periodMs, lookaheadMs, total, &ref)) {
+    fprintf(stderr, "sg_resample_check: cannot open the 16 kHz session\n");
+    return 1;
+  }
+  size_t refModified = 0;
+  for (bool m : ref.modified) refModified += m ? 1 : 0;
+  printf("reference : 16000 Hz x1 int16, %llu decisions, %llu kws hits, %zu modified 10ms frames\n",
+         static_cast<unsigned long long>(ref.stats.intercept_decisions),
+         static_cast<unsigned long long>(ref.stats.kws_hits), refModified);
+
+  const Format formats[] = {{48000, 2, kFormatInt16}, {44100, 2, kFormatFloat32}};
+  for (const Format& fmt : formats) {
+    PolyphaseResampler up(kEngineSampleRate, fmt.rate);
+    std::vector<float> native;
+    resample(up, mono, static_cast<size_t>(kEngineSampleRate) * opt.periodMs / 1000, &native);
+    StreamResult got;
+    if (!runStream(engine, fmt, native, up.delay(), opt.periodMs, lookaheadMs, total, &got)) {
+      fprintf(stderr, "sg_resample_check: cannot open a %d Hz session\n", fmt.rate);
+      return 1;
+    }
+    size_t both = 0, either = 0;
+    for (size_t i = 0; i < ref.modified.size(); ++i) {
+      both += ref.modified[i] && got.modified[i] ? 1 : 0;
+      either += ref.modified[i] || got.modified[i] ? 1 : 0;
+    }
+    const double iou = either > 0 ? static_cast<double>(both) / either : 1.0;
+    const bool same = got.stats.intercept_decisions == ref.stats.intercept_decisions &&
+                      got.stats.kws_hits == ref.stats.kws_hits && iou >= 0.9;
+    printf("%-9s : %d Hz x%d %s, %d taps, %llu decisions, %llu kws hits, masked-frame IoU %.3f  %s\n",
+           fmt.format == kFormatFloat32 ? "float" : "int16", fmt.rate, fmt.channels,
+           fmt.format == kFormatFloat32 ? "float32" : "int16", got.stats.resampler_taps,
+           static_cast<unsigned long long>(got.stats.intercept_decisions),
+           static_cast<unsigned long long>(got.stats.kws_hits), iou, same ? "ok" : "MISMATCH");
+    ok = ok && same;
+  }
+  printf("result    : %s\n", ok ? "native-rate sessions match the 16 kHz reference" : "FAIL");
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,285 @@
+// SilenceGuard Pro — 多会话隔离校验 sg_session_check (host)
+// 每个会话送入同一段音频的不同循环移位：先逐路单独走一遍完整 native 链路 (同步分析) 作为基准，
+// 再打开 N 个会话由 N 个线程同时送入：各会话的拦截决策须与各自基准一致 —— 同步模式逐个比较决策位置，
+// 异步模式 (工作线程池) 排空后比较决策数、关键词命中数与最后一次决策位置；全部一致时退出码为 0
+// 会话数多于工作线程时推理槽被轮流使用，流式模型的状态保存 / 恢复在此得到覆盖
+//
+// 用法: sg_session_check [选项] <input.wav | input.pcm>
+//   --model PATH    模型路径 (stub 后端：含 phoneme / stream 时为音素后验 / 流式变体)
+//   --config JSON   UPDATE_CONFIG 负载；以 @ 开头则从文件读取 (算力调节器固定关闭)
+//   --conf PATH     conf_matrix.json / conf_matrix.bin
+//   --sessions N    并发会话数 (默认 3)
+//   --workers N     工作线程 / 推理槽数 (默认 2)
+//   --async         会话走异步分析 (工作线程池)，按 HAL 周期的节奏送入；默认同步，在各送入线程上分析
+//   --speed X       异步模式的送入速度 (实时的倍数，默认 1；过快时队列溢出丢块，计为不一致)
+//   --period N      HAL 周期帧数 (默认 320 = 20ms @ 16kHz)
+//   --rate HZ       裸 PCM 的采样率 (默认 16000)
+
+#include "core/EngineStats.h"
+#include "tools/ReplayAudio.h"
+#include <sys/types.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include <vector>
+
+extern "C" {
+void* ProtectionEngine_getInstance(void);
+void ProtectionEngine_loadModel(void* engine, const char* path);
+void ProtectionEngine_updateConfig(void* engine, const char* json);
+void ProtectionEngine_setAsyncAnalysis(void* engine, int enabled);
+void ProtectionEngine_setWorkerCount(void* engine, int workers);
+int ProtectionEngine_waitForModel(void* engine);
+void* ProtectionEngine_openSession(void* engine, int sampleRate, int channels);
+void ProtectionEngine_closeSession(void* engine, void* session);
+void ProtectionEngine_getSessionInterceptCounters(void* session, uint64_t* decisions, uint64_t* lastPosition);
+int ProtectionEngine_getSessionStats(void* engine, void* session, SgEngineStats* out);
+int ConfMatrix_load(const char* path);
+ssize_t silenceguard_session_read_proxy(void* session, void* buffer, size_t bytes);
+}
+
+namespace {
+
+using silenceguard::ReplayAudio;
+
+constexpr int kEngineSampleRate = 16000;
+constexpr size_t kShiftFrames = 11200;  // 相邻会话输入的循环移位 (0.7s)
+
+struct Options {
+  std::string input;
+  std::string model = "stub";
+  std::string config = "{}";
+  std::string conf;
+  int sessions = 3;
+  int workers = 2;
+  bool async = false;
+  double speed = 1.0;
+  size_t period = 320;
+  int rawRate = kEngineSampleRate;
+};
+
+void usage() {
+  fprintf(stderr,
+          "usage: sg_session_check [--model PATH] [--config JSON|@file] [--conf PATH] [--sessions N]\n"
+          "                        [--workers N] [--async] [--speed X] [--period N] [--rate HZ]\n"
+          "                        <input.wav|input.pcm>\n");
+}
+
+bool parseArgs(int argc, char** argv, Options* opt) {
+  for (int i = 1; i < argc; ++i) {
+    std::string a = argv[i];
+    auto next = [&](const char** v) {
+      if (i + 1 >= argc) return false;
+      *v = argv[++i];
+      return true;
+    };
+    const char* v = nullptr;
+    if (a == "--model" && next(&v)) {
+      opt->model = v;
+    } else if (a == "--config" && next(&v)) {
+      opt->config = v;
+    } else if (a == "--conf" && next(&v)) {
+      opt->conf = v;
+    } else if (a == "--sessions" && next(&v)) {
+      opt->sessions = std::max(1, static_cast<int>(std::strtol(v, nullptr, 10)));
+    } else if (a == "--workers" && next(&v)) {
+      opt->workers = std::max(1, static_cast<int>(std::strtol(v, nullptr, 10)));
+    } else if (a == "--async") {
+      opt->async = true;
+    } else if (a == "--speed" && next(&v)) {
+      opt->speed = std::max(0.01, std::strtod(v, nullptr));
+    } else if (a == "--period" && next(&v)) {
+      opt->period = static_cast<size_t>(std::max(1L, std::strtol(v, nullptr, 10)));
+    } else if (a == "--rate" && next(&v)) {
+      opt->rawRate = static_cast<int>(std::strtol(v, nullptr, 10));
+    } else if (!a.empty() && a[0] != '-' && opt->input.empty()) {
+      opt->input = a;
+    } else {
+      return false;
+    }
+  }
+  return !opt->input.empty();
+}
+
+double seconds(uint64_t frames) { return static_cast<double>(frames) / kEngineSampleRate; }
+
+// 在配置对象末尾追加 "governor":false：比较的是会话隔离，不让工作点随负载变化
+bool withoutGovernor(const std::string& config, std::string* out) {
+  const size_t close = config.find_last_of('}');
+  if (close == std::string::npos) return false;
+  const size_t open = config.find('{');
+  const bool empty = config.find_first_not_of(" \t\r\n", open + 1) == close;
+  *out = config.substr(0, close) + (empty ? "" : ",") + "\"governor\":false}";
+  return true;
+}
+
+struct Run {
+  std::vector<uint64_t> decisions;  // 每次观测到新决策时的决策位置 (会话内样本号)
+  double wallMs = 0.0;
+};
+
+struct Result {
+  std::vector<uint64_t> decisions;
+  SgEngineStats stats;
+  uint64_t lastPos = 0;
+};
+
+Result collect(void* engine, void* session, const Run& run) {
+  Result r;
+  r.decisions = run.decisions;
+  ProtectionEngine_getSessionStats(engine, session, &r.stats);
+  ProtectionEngine_getSessionInterceptCounters(session, nullptr, &r.lastPos);
+  return r;
+}
+
+// 一个送入线程：逐周期送入会话并记录新决策 (异步模式下只是观测，比较以排空后的计数为准)
+// speed > 0 时按实时的 speed 倍节奏送入，否则尽快送入
+void feed(void* session, const std::vector<int16_t>& pcm, size_t period, double speed, Run* run) {
+  std::vector<int16_t> buf(period);
+  const auto t0 = std::chrono::steady_clock::now();
+  uint64_t seen = 0;
+  for (size_t fed = 0; fed < pcm.size(); fed += period) {
+    const size_t n = std::min(period, pcm.size() - fed);
+    std::copy(pcm.begin() + fed, pcm.begin() + fed + n, buf.begin());
+    silenceguard_session_read_proxy(session, buf.data(), n * sizeof(int16_t));
+    uint64_t decisions = 0, lastPos = 0;
+    ProtectionEngine_getSessionInterceptCounters(session, &decisions, &lastPos);
+    if (decisions != seen) {
+      seen = decisions;
+      run->decisions.push_back(lastPos);
+    }
+    if (speed > 0.0) {
+      const double due = seconds(fed + n) / speed;
+      std::this_thread::sleep_until(t0 + std::chrono::microseconds(static_cast<int64_t>(due * 1e6)));
+    }
+  }
+  run->wallMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  Options opt;
+  if (!parseArgs(argc, argv, &opt)) {
+    usage();
+    return 2;
+  }
+  ReplayAudio audio;
+  if (!silenceguard::loadReplayAudio(opt.input, opt.rawRate, &audio) || audio.pcm.empty()) {
+    fprintf(stderr, "sg_session_check: no audio in %s\n", opt.input.c_str());
+    return 1;
+  }
+  if (opt.config[0] == '@') {
+    std::vector<char> bytes;
+    if (!silenceguard::readFile(opt.config.substr(1), &bytes)) {
+      fprintf(stderr, "sg_session_check: cannot read config %s\n", opt.config.c_str() + 1);
+      return 1;
+    }
+    opt.config.assign(bytes.begin(), bytes.end());
+  }
+  std::string config;
+  if (!withoutGovernor(opt.config, &config)) {
+    fprintf(stderr, "sg_session_check: --config must be a JSON object\n");
+    return 2;
+  }
+
+  void* engine = ProtectionEngine_getInstance();
+  ProtectionEngine_setAsyncAnalysis(engine, 0);
+  ProtectionEngine_setWorkerCount(engine, opt.workers);
+  ProtectionEngine_updateConfig(engine, config.c_str());
+  ProtectionEngine_loadModel(engine, opt.model.c_str());
+  if (!opt.conf.empty() && !ConfMatrix_load(opt.conf.c_str())) {
+    fprintf(stderr, "sg_session_check: cannot load confusion matrix %s\n", opt.conf.c_str());
+    return 1;
+  }
+  if (!ProtectionEngine_waitForModel(engine)) {
+    fprintf(stderr, "sg_session_check: model failed to load\n");
+    return 1;
+  }
+
+  // 各会话送入同一音频的不同循环移位：内容互不相同，推理槽里残留别的会话的状态时决策会偏离
+  std::vector<std::vector<int16_t>> inputs(opt.sessions);
+  for (int i = 0; i < opt.sessions; ++i) {
+    const size_t shift = static_cast<size_t>(i) * kShiftFrames % audio.pcm.size();
+    inputs[i].assign(audio.pcm.begin() + shift, audio.pcm.end());
+    inputs[i].insert(inputs[i].end(), audio.pcm.begin(), audio.pcm.begin() + shift);
+  }
+
+  // 基准：每路输入各用一个新会话单独同步分析 (依次进行，互不交错)
+  std::vector<Result> refs(opt.sessions);
+  double refWallMs = 0.0;
+  for (int i = 0; i < opt.sessions; ++i) {
+    void* s = ProtectionEngine_openSession(engine, kEngineSampleRate, 1);
+    if (!s) {
+      fprintf(stderr, "sg_session_check: openSession failed\n");
+      return 1;
+    }
+    Run run;
+    feed(s, inputs[i], opt.period, 0.0, &run);
+    refs[i] = collect(engine, s, run);
+    refWallMs += run.wallMs;
+    ProtectionEngine_closeSession(engine, s);
+  }
+
+  std::vector<void*> sessions;
+  for (int i = 0; i < opt.sessions; ++i) {
+    void* s = ProtectionEngine_openSession(engine, kEngineSampleRate, 1);
+    if (!s) {
+      fprintf(stderr, "sg_session_check: openSession failed\n");
+      return 1;
+    }
+    sessions.push_back(s);
+  }
+  ProtectionEngine_setAsyncAnalysis(engine, opt.async ? 1 : 0);
+  std::vector<Run> runs(sessions.size());
+  std::vector<std::thread> feeders;
+  const auto t0 = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < sessions.size(); ++i) {
+    feeders.emplace_back(feed, sessions[i], std::cref(inputs[i]), opt.period, opt.async ? opt.speed : 0.0,
+                         &runs[i]);
+  }
+  for (std::thread& t : feeders) t.join();
+  ProtectionEngine_setAsyncAnalysis(engine, 0);  // 排空全部会话的队列
+  const double wallMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+
+  SgEngineStats engineStats;
+  ProtectionEngine_getSessionStats(engine, sessions[0], &engineStats);
+  printf("input     : %s (%.2f s), period %zu frames, shifted %.2f s per session\n", opt.input.c_str(),
+         seconds(audio.pcm.size()), opt.period, seconds(kShiftFrames));
+  if (opt.async) {
+    printf("pool      : %d sessions on %u workers, async at %.2fx real time, %.1f ms wall\n", opt.sessions,
+           engineStats.pool_workers, opt.speed, wallMs);
+  } else {
+    printf("pool      : %d sessions on %u workers, sync, %.1f ms wall (serial reference %.1f ms)\n", opt.sessions,
+           engineStats.pool_workers, wallMs, refWallMs);
+  }
+
+  int mismatched = 0;
+  for (size_t i = 0; i < sessions.size(); ++i) {
+    const Result got = collect(engine, sessions[i], runs[i]);
+    const Result& ref = refs[i];
+    bool same = got.stats.intercept_decisions == ref.stats.intercept_decisions &&
+                got.stats.kws_hits == ref.stats.kws_hits && got.lastPos == ref.lastPos &&
+                got.stats.blocks_dropped == 0;
+    if (!opt.async) same = same && got.decisions == ref.decisions;
+    printf("session %-2u: slot %u, %llu/%llu decisions, %llu/%llu kws hits, last at %.3f/%.3f s, "
+           "%llu restores, %llu resets, %llu dropped  %s\n",
+           got.stats.session_id, got.stats.session_slot,
+           static_cast<unsigned long long>(got.stats.intercept_decisions),
+           static_cast<unsigned long long>(ref.stats.intercept_decisions),
+           static_cast<unsigned long long>(got.stats.kws_hits), static_cast<unsigned long long>(ref.stats.kws_hits),
+           seconds(got.lastPos), seconds(ref.lastPos),
+           static_cast<unsigned long long>(got.stats.stream_state_restores),
+           static_cast<unsigned long long>(got.stats.stream_resets),
+           static_cast<unsigned long long>(got.stats.blocks_dropped), same ? "ok" : "MISMATCH");
+    mismatched += same ? 0 : 1;
+  }
+  for (void* s : sessions) ProtectionEngine_closeSession(engine, s);
+  printf("result    : %d/%d sessions match their single-stream reference (got/reference)\n",
+         opt.sessions - mismatched, opt.sessions);
+  return mismatched == 0 ? 0 : 1;
+}
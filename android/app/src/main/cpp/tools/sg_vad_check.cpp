@@ -0,0 +1,256 @@
+// SilenceGuard Pro — VAD 门控召回校验 sg_vad_check (host)
+// 同一段回放音频先关闭 VAD、再开启 VAD 各走一遍完整 native 链路 (同步分析，结果可复现)，
+// 以关闭 VAD 的拦截区间为基准统计开启后的召回 (区间有重叠即算召回) 与起始延迟，
+// 并报告门控跳过的样本比例及 Mel / 推理阶段的调用次数与耗时变化；全部召回时退出码为 0
+//
+// 用法: sg_vad_check [选项] <input.wav | input.pcm>
+//   --model PATH    模型路径 (stub 后端：含 phoneme 时输出音素后验)
+//   --config JSON   UPDATE_CONFIG 负载 (不含 "vad" 键)；以 @ 开头则从文件读取
+//   --vad JSON      开启那一遍使用的 "vad" 值 (默认 true，即默认阈值)
+//   --conf PATH     conf_matrix.json / conf_matrix.bin
+//   --period N      HAL 周期帧数 (默认 320 = 20ms @ 16kHz)
+//   --rate HZ       裸 PCM 的采样率 (默认 16000)
+
+#include "core/EngineStats.h"
+#include "tools/ReplayAudio.h"
+#include <sys/types.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+extern "C" {
+void* ProtectionEngine_getInstance(void);
+void ProtectionEngine_loadModel(void* engine, const char* path);
+void ProtectionEngine_updateConfig(void* engine, const char* json);
+void ProtectionEngine_setAsyncAnalysis(void* engine, int enabled);
+void ProtectionEngine_getInterceptCounters(void* engine, uint64_t* decisions, uint64_t* lastPosition);
+int ProtectionEngine_getStats(void* engine, SgEngineStats* out);
+int ProtectionEngine_waitForModel(void* engine);
+int ConfMatrix_load(const char* path);
+ssize_t silenceguard_in_read_proxy(void* engine, void* buffer, size_t bytes);
+}
+
+namespace {
+
+using silenceguard::ReplayAudio;
+
+constexpr int kEngineSampleRate = 16000;
+constexpr uint64_t kMaskFrames = 3200;  // 单次决策的掩蔽时长 (200ms)，用于合并区间
+constexpr size_t kGapFrames = 16000;    // 两遍之间送入 1s 静音，让门关闭、解码器走出上一遍
+
+struct Options {
+  std::string input;
+  std::string model = "stub";
+  std::string config = "{}";
+  std::string vad = "true";
+  std::string conf;
+  size_t period = 320;
+  int rawRate = kEngineSampleRate;
+};
+
+void usage() {
+  fprintf(stderr,
+          "usage: sg_vad_check [--model PATH] [--config JSON|@file] [--vad JSON] [--conf PATH]\n"
+          "                    [--period N] [--rate HZ] <input.wav|input.pcm>\n");
+}
+
+bool parseArgs(int argc, char** argv, Options* opt) {
+  for (int i = 1; i < argc; ++i) {
+    std::string a = argv[i];
+    auto next = [&](const char** v) {
+      if (i + 1 >= argc) return false;
+      *v = argv[++i];
+      return true;
+    };
+    const char* v = nullptr;
+    if (a == "--model" && next(&v)) {
+      opt->model = v;
+    } else if (a == "--config" && next(&v)) {
+      opt->config = v;
+    } else if (a == "--vad" && next(&v)) {
+      opt->vad = v;
+    } else if (a == "--conf" && next(&v)) {
+      opt->conf = v;
+    } else if (a == "--period" && next(&v)) {
+      opt->period = static_cast<size_t>(std::max(1L, std::strtol(v, nullptr, 10)));
+    } else if (a == "--rate" && next(&v)) {
+      opt->rawRate = static_cast<int>(std::strtol(v, nullptr, 10));
+    } else if (!a.empty() && a[0] != '-' && opt->input.empty()) {
+      opt->input = a;
+    } else {
+      return false;
+    }
+  }
+  return !opt->input.empty();
+}
+
+double seconds(uint64_t frames) { return static_cast<double>(frames) / kEngineSampleRate; }
+
+// 在配置对象末尾追加 "vad" 键
+bool withVad(const std::string& config, const std::string& vad, std::string* out) {
+  const size_t close = config.find_last_of('}');
+  if (close == std::string::npos) return false;
+  const size_t open = config.find('{');
+  const bool empty = config.find_first_not_of(" \t\r\n", open + 1) == close;
+  *out = config.substr(0, close) + (empty ? "" : ",") + "\"vad\":" + vad + "}";
+  return true;
+}
+
+struct Segment {
+  uint64_t start;
+  uint64_t end;
+};
+
+struct Pass {
+  std::vector<Segment> segments;  // 相对本遍起点的样本位置
+  SgEngineStats before;
+  SgEngineStats after;
+  double wallMs = 0.0;  // 本遍全部 in_read 调用的墙钟时间 (含 VAD 本身)
+};
+
+// 逐周期送入并记录决策位置，按掩蔽时长合并为区间 (同 sg_replay 的时间线)
+void replay(void* engine, const std::vector<int16_t>& pcm, size_t period, uint64_t origin, Pass* pass) {
+  std::vector<int16_t> buf(period);
+  uint64_t seen = 0;
+  ProtectionEngine_getInterceptCounters(engine, &seen, nullptr);
+  for (size_t fed = 0; fed < pcm.size(); fed += period) {
+    const size_t n = std::min(period, pcm.size() - fed);
+    std::copy(pcm.begin() + fed, pcm.begin() + fed + n, buf.begin());
+    silenceguard_in_read_proxy(engine, buf.data(), n * sizeof(int16_t));
+    uint64_t decisions = 0, lastPos = 0;
+    ProtectionEngine_getInterceptCounters(engine, &decisions, &lastPos);
+    if (decisions == seen) continue;
+    seen = decisions;
+    const uint64_t at = lastPos > origin ? lastPos - origin : 0;
+    if (!pass->segments.empty() && at <= pass->segments.back().end) {
+      pass->segments.back().end = std::max(pass->segments.back().end, at + kMaskFrames);
+    } else {
+      pass->segments.push_back({at, at + kMaskFrames});
+    }
+  }
+}
+
+void printStage(const char* name, const SgStageStats& off, const SgStageStats& on) {
+  printf("  %-10s %8llu calls %10.1f ms   ->  %8llu calls %10.1f ms\n", name,
+         static_cast<unsigned long long>(off.count), static_cast<double>(off.sum_ns) / 1e6,
+         static_cast<unsigned long long>(on.count), static_cast<double>(on.sum_ns) / 1e6);
+}
+
+SgStageStats delta(const SgStageStats& a, const SgStageStats& b) {
+  SgStageStats d = {};
+  d.count = b.count - a.count;
+  d.sum_ns = b.sum_ns - a.sum_ns;
+  return d;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  Options opt;
+  if (!parseArgs(argc, argv, &opt)) {
+    usage();
+    return 2;
+  }
+  ReplayAudio audio;
+  if (!silenceguard::loadReplayAudio(opt.input, opt.rawRate, &audio) || audio.pcm.empty()) {
+    fprintf(stderr, "sg_vad_check: no audio in %s\n", opt.input.c_str());
+    return 1;
+  }
+  if (opt.config[0] == '@') {
+    std::vector<char> bytes;
+    if (!silenceguard::readFile(opt.config.substr(1), &bytes)) {
+      fprintf(stderr, "sg_vad_check: cannot read config %s\n", opt.config.c_str() + 1);
+      return 1;
+    }
+    opt.config.assign(bytes.begin(), bytes.end());
+  }
+  std::string configOff, configOn;
+  if (!withVad(opt.config, "false", &configOff) || !withVad(opt.config, opt.vad, &configOn)) {
+    fprintf(stderr, "sg_vad_check: --config must be a JSON object\n");
+    return 2;
+  }
+
+  void* engine = ProtectionEngine_getInstance();
+  ProtectionEngine_setAsyncAnalysis(engine, 0);
+  ProtectionEngine_loadModel(engine, opt.model.c_str());
+  if (!opt.conf.empty() && !ConfMatrix_load(opt.conf.c_str())) {
+    fprintf(stderr, "sg_vad_check: cannot load confusion matrix %s\n", opt.conf.c_str());
+    return 1;
+  }
+  const std::vector<int16_t> gap(kGapFrames, 0);
+  Pass passes[2];
+  uint64_t origin = 0;
+  for (int p = 0; p < 2; ++p) {
+    ProtectionEngine_updateConfig(engine, p == 0 ? configOff.c_str() : configOn.c_str());
+    if (!ProtectionEngine_waitForModel(engine)) {
+      fprintf(stderr, "sg_vad_check: model failed to load\n");
+      return 1;
+    }
+    ProtectionEngine_getStats(engine, &passes[p].before);
+    const auto t0 = std::chrono::steady_clock::now();
+    replay(engine, audio.pcm, opt.period, origin, &passes[p]);
+    passes[p].wallMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+    ProtectionEngine_getStats(engine, &passes[p].after);
+    origin += audio.pcm.size();
+    Pass ignored;
+    replay(engine, gap, opt.period, origin, &ignored);
+    origin += gap.size();
+  }
+
+  const Pass& off = passes[0];
+  const Pass& on = passes[1];
+  printf("input     : %s (%.2f s), period %zu frames, vad %s\n", opt.input.c_str(), seconds(audio.pcm.size()),
+         opt.period, opt.vad.c_str());
+  printf("\nreference (vad off) intercepts -> vad on:\n");
+  int recalled = 0;
+  double delaySum = 0.0;
+  for (const Segment& ref : off.segments) {
+    const Segment* match = nullptr;
+    for (const Segment& s : on.segments) {
+      if (s.start < ref.end && ref.start < s.end) {
+        match = &s;
+        break;
+      }
+    }
+    if (match) {
+      const double delay = seconds(match->start) - seconds(ref.start);
+      printf("  %9.3f s - %9.3f s  recalled  (%+.0f ms)\n", seconds(ref.start), seconds(ref.end), 1000.0 * delay);
+      delaySum += delay;
+      ++recalled;
+    } else {
+      printf("  %9.3f s - %9.3f s  MISSED\n", seconds(ref.start), seconds(ref.end));
+    }
+  }
+  if (off.segments.empty()) printf("  (none)\n");
+  int extra = 0;
+  for (const Segment& s : on.segments) {
+    bool overlaps = false;
+    for (const Segment& ref : off.segments) overlaps = overlaps || (s.start < ref.end && ref.start < s.end);
+    extra += overlaps ? 0 : 1;
+  }
+  const int total = static_cast<int>(off.segments.size());
+  printf("recall    : %d/%d segments (%.1f%%), mean onset shift %+.0f ms, %d new segments with vad on\n", recalled,
+         total, total ? 100.0 * recalled / total : 100.0, recalled ? 1000.0 * delaySum / recalled : 0.0, extra);
+
+  const uint64_t samples = on.after.vad_samples - on.before.vad_samples;
+  const uint64_t skipped = on.after.vad_skipped_samples - on.before.vad_skipped_samples;
+  const uint64_t hops = on.after.vad_hops - on.before.vad_hops;
+  const uint64_t speech = on.after.vad_speech_hops - on.before.vad_speech_hops;
+  printf("vad       : skipped %.1f%% of samples, %.1f%% speech hops, %llu openings\n",
+         samples ? 100.0 * skipped / samples : 0.0, hops ? 100.0 * speech / hops : 0.0,
+         static_cast<unsigned long long>(on.after.vad_openings - on.before.vad_openings));
+  printf("compute   : vad off                              vad on\n");
+  printStage("mel", delta(off.before.stages[SG_STAGE_MEL], off.after.stages[SG_STAGE_MEL]),
+             delta(on.before.stages[SG_STAGE_MEL], on.after.stages[SG_STAGE_MEL]));
+  printStage("inference", delta(off.before.stages[SG_STAGE_INFERENCE], off.after.stages[SG_STAGE_INFERENCE]),
+             delta(on.before.stages[SG_STAGE_INFERENCE], on.after.stages[SG_STAGE_INFERENCE]));
+  printf("  %-10s %25.1f ms   ->  %25.1f ms\n", "wall", off.wallMs, on.wallMs);
+  printf("kws hits  : %llu -> %llu\n",
+         static_cast<unsigned long long>(off.after.kws_hits - off.before.kws_hits),
+         static_cast<unsigned long long>(on.after.kws_hits - on.before.kws_hits));
+  return recalled == total ? 0 : 1;
+}
@@ -59,6 +59,30 @@ public class Bridge {
     /** JNI: Load Model from path */
     public native void loadModel(String path);
 
+    /**
+     * JNI: 引擎统计快照 (紧凑 JSON，阶段单位 ns)
+     * {"v":11,"stages":{"push":[n,p50,p90,p99,max,sum],...},"counters":{"intercepts":..,...},
+     *  "model":{"load_us":..,"warmup_us":..,"first_us":..,"threads":..,"xnnpack":0|1,
+     *           "in_type":..,"out_type":..,"chunk":..,"states":..},
+     *  "kws":{"keywords":..,"nodes":..,"frames":..,"hits":..,"peak_tokens":..,
+     *         "last":{"id":..,"score":..,"start":..,"end":..}},
+     *  "config":{"publishes":..,"rejected":..,"parse_us":..,"compile_us":..},
+     *  "vad":{"samples":..,"skipped":..,"hops":..,"speech_hops":..,"openings":..},
+     *  "governor":{"level":..,"levels":..,"stride_ms":..,"threads":..,"fallback":0|1,"rtf":..,"lag_ms":..,
+     *              "transitions":..,"overloads":..},
+     *  "sessions":{"id":..,"open":..,"opened":..,"workers":..,"slot":..,"state_restores":..},
+     *  "capture":{"rate":..,"channels":..,"format":0|1,"taps":..}}
+     * 张量类型 0 = float32, 1 = int8, 2 = uint8；chunk > 0 为流式模型每块帧数 (counters 含 chunks / stream_resets)
+     * kws.last 为最近一次关键词命中 (id 为 UPDATE_CONFIG keywords 下标，-1 = 尚无；start / end 为流内样本号)
+     * config：UPDATE_CONFIG 在调用线程解析 + 编译后原子发布 (rejected 为 JSON 不合法被丢弃的推送)
+     * vad：skipped / samples 为门控跳过 Mel 与推理的样本比例 (节省的算力)
+     * governor：算力调节器当前工作点 (level 0 算力最多)；rtf / lag_ms 为最近一个评估区间的测量
+     * sessions：本快照为默认会话 (id) 的流统计；open / workers 为当前采集会话数与推理线程池大小
+     * capture：会话的原生采集格式 (format 0 = int16, 1 = float32)；taps 为重采样到 16kHz 的滤波长度，0 = 无需重采样
+     * stages: push / queue_wait / lock_wait / mel / inference / decision / lookahead
+     */
+    public native String getStats();
+
     @JavascriptInterface
     public void onMessage(String action, String payloadJson) {
         if (payloadJson == null) payloadJson = "{}";